@@ -9,16 +9,23 @@ from esphome.const import (
     CONF_OUTPUT,
     DEVICE_CLASS_OCCUPANCY,
     ENTITY_CATEGORY_DIAGNOSTIC,
+    UNIT_PERCENT,
+    UNIT_SECOND,
 )
 
 CODEOWNERS = ["@nuttytree"]
-AUTO_LOAD = ["binary_sensor", "sensor", "text_sensor"]
+AUTO_LOAD = ["binary_sensor", "loop_profile", "sensor", "text_sensor"]
 
 adc_ns = cg.esphome_ns.namespace("adc")
 ADCSensor = adc_ns.class_("ADCSensor")
 
 bed_sensor_ns = cg.esphome_ns.namespace("bed_sensor")
 BedSensor = bed_sensor_ns.class_("BedSensor", cg.PollingComponent)
+SampleReduction = bed_sensor_ns.enum("SampleReduction", is_class=True)
+SAMPLE_REDUCTIONS = {
+    "MEDIAN": SampleReduction.MEDIAN,
+    "TRIMMED_MEAN": SampleReduction.TRIMMED_MEAN,
+}
 
 CONF_ADC_SENSOR = "adc_sensor"
 CONF_SIDE_ONE = "side_one"
@@ -28,10 +35,32 @@ CONF_VALUE_SENSOR = "value_sensor"
 CONF_SOMEONE = "someone_sensor"
 CONF_COUNT = "count_sensor"
 CONF_STATUS = "status_sensor"
+CONF_OCCUPIED_THRESHOLD = "occupied_threshold"
+CONF_OCCUPIED_HYSTERESIS = "occupied_hysteresis"
+CONF_SOMEONE_THRESHOLD = "someone_threshold"
+CONF_SOMEONE_HYSTERESIS = "someone_hysteresis"
+CONF_VALUE_DELTA = "value_delta"
+CONF_SETTLE_TIME = "settle_time"
+CONF_SAMPLE_COUNT = "sample_count"
+CONF_REDUCTION = "reduction"
+CONF_ADAPTIVE_POLLING = "adaptive_polling"
+CONF_MIN_INTERVAL = "min_interval"
+CONF_MAX_INTERVAL = "max_interval"
+CONF_INTERVAL_SENSOR = "interval_sensor"
+CONF_ADC_RESOLUTION = "adc_resolution"
+CONF_AUTO_CALIBRATE = "auto_calibrate"
+CONF_THRESHOLD_SENSOR = "threshold_sensor"
+CONF_ZONES = "zones"
+CONF_OCCUPANCY = "occupancy_sensor"
+
+# Must match MAX_ZONES in bed_sensor.h.
+MAX_ZONES = 6
 
 ICON_BED = "mdi:bed"
 ICON_NUMERIC = "mdi:numeric"
 ICON_COUNTER = "mdi:counter"
+ICON_TIMER = "mdi:timer-outline"
+ICON_TUNE = "mdi:tune-vertical"
 
 BED_SIDE_CONFIG_SCHEMA = binary_sensor.binary_sensor_schema(
     device_class=DEVICE_CLASS_OCCUPANCY,
@@ -45,9 +74,44 @@ BED_SIDE_CONFIG_SCHEMA = binary_sensor.binary_sensor_schema(
             accuracy_decimals=0,
             entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
         ),
+        cv.Optional(CONF_THRESHOLD_SENSOR): sensor.sensor_schema(
+            unit_of_measurement=UNIT_PERCENT,
+            icon=ICON_TUNE,
+            accuracy_decimals=1,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
     }
 )
 
+
+def _validate_intervals(config):
+    if config[CONF_MIN_INTERVAL] > config[CONF_MAX_INTERVAL]:
+        raise cv.Invalid(
+            f"{CONF_MIN_INTERVAL} must not be larger than {CONF_MAX_INTERVAL}"
+        )
+    return config
+
+
+ADAPTIVE_POLLING_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.Optional(
+                CONF_MIN_INTERVAL, default="1s"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(
+                CONF_MAX_INTERVAL, default="10s"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_INTERVAL_SENSOR): sensor.sensor_schema(
+                unit_of_measurement=UNIT_SECOND,
+                icon=ICON_TIMER,
+                accuracy_decimals=1,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+        }
+    ),
+    _validate_intervals,
+)
+
 SOMEONE_CONFIG_SCHEMA = binary_sensor.binary_sensor_schema(
     device_class=DEVICE_CLASS_OCCUPANCY,
     icon=ICON_BED,
@@ -57,22 +121,91 @@ SOMEONE_CONFIG_SCHEMA = binary_sensor.binary_sensor_schema(
     }
 )
 
-CONFIG_SCHEMA = cv.Schema(
-    {
-        cv.GenerateID(): cv.declare_id(BedSensor),
-        cv.Required(CONF_ADC_SENSOR): cv.use_id(ADCSensor),
-        cv.Required(CONF_SIDE_ONE): BED_SIDE_CONFIG_SCHEMA,
-        cv.Required(CONF_SIDE_TWO): BED_SIDE_CONFIG_SCHEMA,
-        cv.Required(CONF_SOMEONE): SOMEONE_CONFIG_SCHEMA,
-        cv.Required(CONF_COUNT): sensor.sensor_schema(
-            icon=ICON_COUNTER,
-            accuracy_decimals=0,
-        ),
-        cv.Required(CONF_STATUS): text_sensor.text_sensor_schema(
-            icon=ICON_BED,
-        ),
-    }
-).extend(cv.polling_component_schema("2s"))
+
+def _zone_configs(config):
+    if CONF_ZONES in config:
+        return config[CONF_ZONES]
+    return [config[CONF_SIDE_ONE], config[CONF_SIDE_TWO]]
+
+
+def _validate_zones(config):
+    has_sides = CONF_SIDE_ONE in config or CONF_SIDE_TWO in config
+    if CONF_ZONES in config:
+        if has_sides:
+            raise cv.Invalid(
+                f"Use either {CONF_ZONES} or {CONF_SIDE_ONE}/{CONF_SIDE_TWO}, not both"
+            )
+    elif CONF_SIDE_ONE not in config or CONF_SIDE_TWO not in config:
+        raise cv.Invalid(
+            f"Either {CONF_ZONES} or both {CONF_SIDE_ONE} and {CONF_SIDE_TWO} "
+            "are required"
+        )
+    return config
+
+
+def _validate_threshold_sensors(config):
+    for zone_config in _zone_configs(config):
+        if CONF_THRESHOLD_SENSOR in zone_config and not config[CONF_AUTO_CALIBRATE]:
+            raise cv.Invalid(
+                f"{CONF_THRESHOLD_SENSOR} requires {CONF_AUTO_CALIBRATE}: true"
+            )
+    return config
+
+
+def _validate_hysteresis(config):
+    for threshold, hysteresis in (
+        (CONF_OCCUPIED_THRESHOLD, CONF_OCCUPIED_HYSTERESIS),
+        (CONF_SOMEONE_THRESHOLD, CONF_SOMEONE_HYSTERESIS),
+    ):
+        if config[hysteresis] > config[threshold]:
+            raise cv.Invalid(f"{hysteresis} must not be larger than {threshold}")
+    return config
+
+
+CONFIG_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.GenerateID(): cv.declare_id(BedSensor),
+            cv.Required(CONF_ADC_SENSOR): cv.use_id(ADCSensor),
+            cv.Optional(CONF_ZONES): cv.All(
+                cv.ensure_list(BED_SIDE_CONFIG_SCHEMA),
+                cv.Length(min=1, max=MAX_ZONES),
+            ),
+            cv.Optional(CONF_SIDE_ONE): BED_SIDE_CONFIG_SCHEMA,
+            cv.Optional(CONF_SIDE_TWO): BED_SIDE_CONFIG_SCHEMA,
+            cv.Optional(CONF_SOMEONE): SOMEONE_CONFIG_SCHEMA,
+            cv.Required(CONF_COUNT): sensor.sensor_schema(
+                icon=ICON_COUNTER,
+                accuracy_decimals=0,
+            ),
+            cv.Optional(CONF_OCCUPANCY): sensor.sensor_schema(
+                icon=ICON_BED,
+                accuracy_decimals=0,
+            ),
+            cv.Required(CONF_STATUS): text_sensor.text_sensor_schema(
+                icon=ICON_BED,
+            ),
+            cv.Optional(CONF_OCCUPIED_THRESHOLD, default="75%"): cv.percentage,
+            cv.Optional(CONF_OCCUPIED_HYSTERESIS, default="5%"): cv.percentage,
+            cv.Optional(CONF_SOMEONE_THRESHOLD, default="40%"): cv.percentage,
+            cv.Optional(CONF_SOMEONE_HYSTERESIS, default="5%"): cv.percentage,
+            cv.Optional(CONF_VALUE_DELTA, default=8): cv.positive_float,
+            cv.Optional(
+                CONF_SETTLE_TIME, default="10ms"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_SAMPLE_COUNT, default=5): cv.int_range(min=1, max=16),
+            cv.Optional(CONF_REDUCTION, default="MEDIAN"): cv.enum(
+                SAMPLE_REDUCTIONS, upper=True, space="_"
+            ),
+            cv.Optional(CONF_ADAPTIVE_POLLING): ADAPTIVE_POLLING_SCHEMA,
+            cv.Optional(CONF_ADC_RESOLUTION, default=10): cv.int_range(min=8, max=16),
+            cv.Optional(CONF_AUTO_CALIBRATE, default=False): cv.boolean,
+        }
+    ).extend(cv.polling_component_schema("2s")),
+    _validate_zones,
+    _validate_hysteresis,
+    _validate_threshold_sensors,
+)
 
 
 async def to_code(config):
@@ -80,38 +213,48 @@ async def to_code(config):
     await cg.register_component(var, config)
 
     cg.add(var.set_adc_sensor(await cg.get_variable(config[CONF_ADC_SENSOR])))
-
-    side_one_config = config[CONF_SIDE_ONE]
-    cg.add(var.set_side_one_name(side_one_config[CONF_STATUS_NAME]))
-    cg.add(var.set_side_one_output(await cg.get_variable(side_one_config[CONF_OUTPUT])))
-    cg.add(
-        var.set_side_one_value_sensor(
-            await sensor.new_sensor(side_one_config[CONF_VALUE_SENSOR])
+    cg.add(var.set_occupied_threshold(config[CONF_OCCUPIED_THRESHOLD] * 100))
+    cg.add(var.set_occupied_hysteresis(config[CONF_OCCUPIED_HYSTERESIS] * 100))
+    cg.add(var.set_someone_threshold(config[CONF_SOMEONE_THRESHOLD] * 100))
+    cg.add(var.set_someone_hysteresis(config[CONF_SOMEONE_HYSTERESIS] * 100))
+    cg.add(var.set_value_delta(config[CONF_VALUE_DELTA]))
+    cg.add(var.set_settle_time(config[CONF_SETTLE_TIME]))
+    cg.add(var.set_sample_count(config[CONF_SAMPLE_COUNT]))
+    cg.add(var.set_reduction(config[CONF_REDUCTION]))
+    cg.add(var.set_adc_resolution(config[CONF_ADC_RESOLUTION]))
+    cg.add(var.set_auto_calibrate(config[CONF_AUTO_CALIBRATE]))
+    if adaptive_config := config.get(CONF_ADAPTIVE_POLLING):
+        cg.add(
+            var.set_adaptive_update_interval(
+                adaptive_config[CONF_MIN_INTERVAL], adaptive_config[CONF_MAX_INTERVAL]
+            )
         )
-    )
-    cg.add(
-        var.set_side_one_sensor(await binary_sensor.new_binary_sensor(side_one_config))
-    )
+        if sensor_config := adaptive_config.get(CONF_INTERVAL_SENSOR):
+            sens = await sensor.new_sensor(sensor_config)
+            cg.add(var.set_update_interval_sensor(sens))
 
-    side_two_config = config[CONF_SIDE_TWO]
-    cg.add(var.set_side_two_name(side_two_config[CONF_STATUS_NAME]))
-    cg.add(var.set_side_two_output(await cg.get_variable(side_two_config[CONF_OUTPUT])))
-    cg.add(
-        var.set_side_two_value_sensor(
-            await sensor.new_sensor(side_two_config[CONF_VALUE_SENSOR])
+    for zone_config in _zone_configs(config):
+        out = await cg.get_variable(zone_config[CONF_OUTPUT])
+        value_sensor = await sensor.new_sensor(zone_config[CONF_VALUE_SENSOR])
+        zone_sensor = await binary_sensor.new_binary_sensor(zone_config)
+        cg.add(
+            var.add_zone(zone_config[CONF_STATUS_NAME], out, value_sensor, zone_sensor)
         )
-    )
-    cg.add(
-        var.set_side_two_sensor(await binary_sensor.new_binary_sensor(side_two_config))
-    )
+        if threshold_config := zone_config.get(CONF_THRESHOLD_SENSOR):
+            sens = await sensor.new_sensor(threshold_config)
+            cg.add(var.set_last_zone_threshold_sensor(sens))
 
-    someone_config = config[CONF_SOMEONE]
-    cg.add(var.set_someone_name(someone_config[CONF_STATUS_NAME]))
-    cg.add(
-        var.set_someone_sensor(await binary_sensor.new_binary_sensor(someone_config))
-    )
+    if someone_config := config.get(CONF_SOMEONE):
+        cg.add(var.set_someone_name(someone_config[CONF_STATUS_NAME]))
+        cg.add(
+            var.set_someone_sensor(
+                await binary_sensor.new_binary_sensor(someone_config)
+            )
+        )
 
     cg.add(var.set_count_sensor(await sensor.new_sensor(config[CONF_COUNT])))
+    if occupancy_config := config.get(CONF_OCCUPANCY):
+        cg.add(var.set_occupancy_sensor(await sensor.new_sensor(occupancy_config)))
     cg.add(
         var.set_status_sensor(await text_sensor.new_text_sensor(config[CONF_STATUS]))
     )
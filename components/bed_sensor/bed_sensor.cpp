@@ -1,76 +1,325 @@
 #include "bed_sensor.h"
 
 #include "esphome/core/log.h"
+#include "esphome/components/loop_profile/loop_profile.h"
+
+#include <algorithm>
+#include <array>
+#include <cinttypes>
 
 namespace esphome::bed_sensor {
 
 static const char *const TAG = "bed.sensor";
+// A reading this close to a threshold (in percent) and moving towards it keeps the polling fast.
+static constexpr float APPROACH_MARGIN = 10.0f;
+// Polling follows each zone's smoothed pressure level: a reading this far (in percent) from the level is a move, and
+// the level has to move at least ACTIVITY_DEADBAND towards a threshold to count as approaching it. Both sit well
+// above what sample noise does to a reduced reading.
+static constexpr float ACTIVITY_SMOOTHING = 0.25f;
+static constexpr float ACTIVITY_STEP = 2.0f;
+static constexpr float ACTIVITY_DEADBAND = 0.5f;
+// Calibration: the histogram is recalibrated and saved hourly and halves all of its bins once one of them is full,
+// so old readings fade out over days and the thresholds follow the mattress as it ages.
+static constexpr uint32_t CALIBRATION_INTERVAL = 60 * 60 * 1000;
+static constexpr uint16_t HISTOGRAM_LIMIT = 60000;
+static constexpr uint32_t MIN_CALIBRATION_SAMPLES = 500;
+static constexpr float MIN_CLUSTER_FRACTION = 0.05f;    // of all samples, for each cluster
+static constexpr float MIN_CLUSTER_SEPARATION = 20.0f;  // percent between the cluster means
+static constexpr float CALIBRATION_RATE = 0.1f;
+static constexpr float BIN_WIDTH = 100.0f / HISTOGRAM_BINS;
 
 void BedSensor::setup() {
-  // Ensure outputs start in a known state
-  if (this->side_one_output_ != nullptr)
-    this->side_one_output_->set_state(false);
-  if (this->side_two_output_ != nullptr)
-    this->side_two_output_->set_state(false);
-  this->combined_name_ = std::string(this->side_one_name_) + " and " + std::string(this->side_two_name_);
+  // Ensure outputs start in a known state, and all zones read as unloaded until they have been measured.
+  for (auto &zone : this->zones_) {
+    zone.output->set_state(false);
+    zone.value = this->adc_full_scale_;
+  }
+  this->build_status_names_();
+
+  if (this->auto_calibrate_) {
+    for (auto &zone : this->zones_)
+      this->load_calibration_(zone.calibration, zone.sensor);
+    this->set_interval("calibration", CALIBRATION_INTERVAL, [this]() {
+      for (auto &zone : this->zones_)
+        this->recalibrate_(zone.calibration, zone.name);
+    });
+  }
+
+  // Adaptive polling starts fast and backs off once the readings are stable.
+  if (this->max_update_interval_ != 0) {
+    this->set_update_interval(this->min_update_interval_);
+    if (this->update_interval_sensor_ != nullptr)
+      this->update_interval_sensor_->publish_state(this->min_update_interval_ / 1000.0f);
+  }
+}
+
+void BedSensor::build_status_names_() {
+  const uint8_t combinations = 1 << this->zones_.size();
+  this->status_names_.clear();
+  this->status_names_.reserve(combinations);
+  for (uint8_t mask = 0; mask < combinations; mask++) {
+    const int occupied = __builtin_popcount(mask);
+    if (occupied == 0) {
+      this->status_names_.emplace_back("Empty");
+      continue;
+    }
+    // "A", "A and B", "A, B and C", ...
+    std::string name;
+    int added = 0;
+    for (uint8_t i = 0; i < this->zones_.size(); i++) {
+      if ((mask & (1 << i)) == 0)
+        continue;
+      if (added > 0)
+        name += added == occupied - 1 ? " and " : ", ";
+      name += this->zones_[i].name;
+      added++;
+    }
+    this->status_names_.push_back(std::move(name));
+  }
 }
 
 void BedSensor::dump_config() {
   ESP_LOGCONFIG(TAG, "Bed Sensor:");
-  ESP_LOGCONFIG(TAG, "  Side One: %s", this->side_one_name_);
-  ESP_LOGCONFIG(TAG, "  Side Two: %s", this->side_two_name_);
+  for (uint8_t i = 0; i < this->zones_.size(); i++) {
+    const Zone &zone = this->zones_[i];
+    if (this->auto_calibrate_) {
+      ESP_LOGCONFIG(TAG, "  Zone %u: %s (threshold %.1f%%)", i + 1, zone.name,
+                    this->occupied_threshold_for_(zone.calibration));
+      LOG_SENSOR("    ", "Threshold", zone.calibration.threshold_sensor);
+    } else {
+      ESP_LOGCONFIG(TAG, "  Zone %u: %s", i + 1, zone.name);
+    }
+  }
+  ESP_LOGCONFIG(TAG, "  Occupied Threshold: %.0f%% (hysteresis %.0f%%)", this->occupied_threshold_,
+                this->classifier_.get_occupied_hysteresis());
+  ESP_LOGCONFIG(TAG, "  Someone Threshold: %.0f%% (hysteresis %.0f%%)", this->classifier_.get_someone_threshold(),
+                this->classifier_.get_someone_hysteresis());
+  ESP_LOGCONFIG(TAG, "  ADC Full Scale: %.0f", this->adc_full_scale_);
+  ESP_LOGCONFIG(TAG, "  Auto Calibration: %s", YESNO(this->auto_calibrate_));
+  ESP_LOGCONFIG(TAG, "  Value Delta: %.0f", this->value_delta_);
+  ESP_LOGCONFIG(TAG, "  Settle Time: %" PRIu32 " ms", this->settle_time_);
+  ESP_LOGCONFIG(TAG, "  Samples: %u (%s)", this->sample_count_,
+                this->reduction_ == SampleReduction::MEDIAN ? "median" : "trimmed mean");
+  LOG_UPDATE_INTERVAL(this);
+  if (this->max_update_interval_ != 0) {
+    ESP_LOGCONFIG(TAG, "  Adaptive Update Interval: %" PRIu32 " ms - %" PRIu32 " ms", this->min_update_interval_,
+                  this->max_update_interval_);
+    LOG_SENSOR("  ", "Update Interval", this->update_interval_sensor_);
+  }
+  LOG_SENSOR("  ", "Occupancy", this->occupancy_);
 }
 
 void BedSensor::update() {
-  if (this->adc_sensor_ == nullptr || this->side_one_output_ == nullptr || this->side_two_output_ == nullptr)
+  LOOP_PROFILE("bed_sensor");
+  if (this->adc_sensor_ == nullptr || this->zones_.empty())
+    return;
+  // A slow settle time can outlast a short update interval, don't switch zones under a running acquisition.
+  if (this->acquiring_)
     return;
-  if (!this->last_updated_side_one_) {
-    this->side_two_output_->set_state(false);
-    this->side_one_output_->set_state(true);
-    this->adc_sensor_->update();
-    this->side_one_value_ = this->adc_sensor_->state;
-    ESP_LOGD(TAG, "Side one value: %f", this->side_one_value_);
-    this->side_one_value_sensor_->publish_state(this->side_one_value_);
-    this->last_updated_side_one_ = true;
+
+  // Zones share the ADC input, so only the zone being read may be powered.
+  const uint8_t index = this->next_zone_;
+  this->next_zone_ = (index + 1) % this->zones_.size();
+  for (uint8_t i = 0; i < this->zones_.size(); i++) {
+    if (i != index)
+      this->zones_[i].output->set_state(false);
+  }
+  this->zones_[index].output->set_state(true);
+
+  // Give the pressure sensor's RC network time to settle after switching before it is measured.
+  this->acquiring_ = true;
+  this->set_timeout("acquire", this->settle_time_, [this, index]() {
+    this->acquiring_ = false;
+    this->process_reading_(index, this->acquire_());
+  });
+}
+
+float BedSensor::acquire_() {
+  std::array<float, MAX_SAMPLES> samples{};
+  for (uint8_t i = 0; i < this->sample_count_; i++)
+    samples[i] = this->adc_sensor_->sample();
+  return reduce_samples(samples.data(), this->sample_count_, this->reduction_);
+}
+
+void BedSensor::process_reading_(uint8_t index, float value) {
+  LOOP_PROFILE("bed_sensor.reading");
+  Zone &zone = this->zones_[index];
+  zone.value = value;
+  ESP_LOGV(TAG, "%s value: %f", zone.name, value);
+  this->publish_value_(zone.value_sensor, value, zone.published_value);
+
+  std::array<float, MAX_ZONES> percents;
+  std::array<float, MAX_ZONES> thresholds;
+  for (uint8_t i = 0; i < this->zones_.size(); i++) {
+    percents[i] = this->to_percent_(this->zones_[i].value);
+    thresholds[i] = this->occupied_threshold_for_(this->zones_[i].calibration);
+  }
+  const Occupancy result = this->classifier_.classify(percents.data(), thresholds.data(), this->zones_.size(),
+                                                      this->someone_in_bed_ != nullptr);
+  const uint8_t occupancy = result.zones;
+  const bool someone_in_bed = result.someone;
+
+  const int count = result.count();
+  const char *status = someone_in_bed ? this->someone_name_ : this->status_names_[occupancy].c_str();
+
+  const bool changed = !this->published_ || occupancy != this->occupancy_state_ || status != this->status_state_;
+  const float previous_level = zone.level;
+  bool moved = false;
+  bool approaching = false;
+  if (std::isnan(previous_level)) {
+    zone.level = percents[index];
   } else {
-    this->side_one_output_->set_state(false);
-    this->side_two_output_->set_state(true);
-    this->adc_sensor_->update();
-    this->side_two_value_ = this->adc_sensor_->state;
-    ESP_LOGD(TAG, "Side two value: %f", this->side_two_value_);
-    this->side_two_value_sensor_->publish_state(this->side_two_value_);
-    this->last_updated_side_one_ = false;
+    zone.level = previous_level + ACTIVITY_SMOOTHING * (percents[index] - previous_level);
+    moved = std::fabs(percents[index] - previous_level) > ACTIVITY_STEP;
+    approaching = this->approaching_threshold_(previous_level, zone.level, thresholds[index]);
   }
+  this->adapt_update_interval_(changed || moved || approaching);
+  if (this->auto_calibrate_)
+    this->record_calibration_sample_(zone.calibration, percents[index]);
 
-  float side_one_percent = (1024 - this->side_one_value_) * 100 / 1024;
-  ESP_LOGD(TAG, "Side one percent: %f", side_one_percent);
-  bool side_one_in_bed = side_one_percent > 75;
-  ESP_LOGD(TAG, "Side one state: %d", side_one_in_bed);
-  this->side_one_sensor_->publish_state(side_one_in_bed);
-
-  float side_two_percent = (1024 - this->side_two_value_) * 100 / 1024;
-  ESP_LOGD(TAG, "Side two percent: %f", side_two_percent);
-  bool side_two_in_bed = side_two_percent > 75;
-  ESP_LOGD(TAG, "Side two state: %d", side_two_in_bed);
-  this->side_two_sensor_->publish_state(side_two_in_bed);
-
-  bool someone_in_bed = !side_one_in_bed && !side_two_in_bed && side_one_percent > 40 && side_two_percent > 40;
-  this->someone_in_bed_->publish_state(someone_in_bed);
-
-  int count = (side_one_in_bed ? 1 : 0) + (side_two_in_bed ? 1 : 0) + (someone_in_bed ? 1 : 0);
-  this->count_->publish_state(count);
-
-  if (count == 0) {
-    this->status_->publish_state("Empty");
-  } else if (count == 2) {
-    this->status_->publish_state(this->combined_name_);
-  } else if (side_one_in_bed) {
-    this->status_->publish_state(this->side_one_name_);
-  } else if (side_two_in_bed) {
-    this->status_->publish_state(this->side_two_name_);
-  } else if (someone_in_bed) {
-    this->status_->publish_state(this->someone_name_);
+  for (uint8_t i = 0; i < this->zones_.size(); i++) {
+    Zone &z = this->zones_[i];
+    const bool occupied = (occupancy & (1 << i)) != 0;
+    this->publish_binary_(z.sensor, occupied, z.occupied);
+    z.occupied = occupied;
+  }
+  if (this->someone_in_bed_ != nullptr)
+    this->publish_binary_(this->someone_in_bed_, someone_in_bed, this->someone_in_bed_state_);
+  if (!this->published_ || count != this->count_state_)
+    this->count_->publish_state(count);
+  if (this->occupancy_ != nullptr && (!this->published_ || occupancy != this->occupancy_state_))
+    this->occupancy_->publish_state(occupancy);
+  if (!this->published_ || status != this->status_state_) {
+    ESP_LOGD(TAG, "Status: %s", status);
+    this->status_->publish_state(status);
   }
+
+  this->someone_in_bed_state_ = someone_in_bed;
+  this->count_state_ = count;
+  this->occupancy_state_ = occupancy;
+  this->status_state_ = status;
+  this->published_ = true;
+}
+
+float BedSensor::to_percent_(float value) const {
+  return (this->adc_full_scale_ - value) * 100 / this->adc_full_scale_;
+}
+
+bool BedSensor::approaching_threshold_(float previous_percent, float percent, float occupied_threshold) const {
+  for (float threshold : {occupied_threshold, this->classifier_.get_someone_threshold()}) {
+    if (std::fabs(threshold - percent) < APPROACH_MARGIN && std::fabs(percent - previous_percent) > ACTIVITY_DEADBAND &&
+        (percent - previous_percent) * (threshold - percent) > 0)
+      return true;
+  }
+  return false;
+}
+
+float BedSensor::occupied_threshold_for_(const ZoneCalibration &calibration) const {
+  if (this->auto_calibrate_ && !std::isnan(calibration.data.threshold))
+    return calibration.data.threshold;
+  return this->occupied_threshold_;
+}
+
+void BedSensor::load_calibration_(ZoneCalibration &calibration, binary_sensor::BinarySensor *zone_sensor) {
+  calibration.pref = zone_sensor->make_entity_preference<CalibrationData>();
+  if (!calibration.pref.load(&calibration.data))
+    calibration.data = {};
+  if (calibration.threshold_sensor != nullptr && !std::isnan(calibration.data.threshold))
+    calibration.threshold_sensor->publish_state(calibration.data.threshold);
+}
+
+void BedSensor::record_calibration_sample_(ZoneCalibration &calibration, float percent) {
+  const int bin = std::clamp(static_cast<int>(percent / BIN_WIDTH), 0, HISTOGRAM_BINS - 1);
+  if (++calibration.data.bins[bin] < HISTOGRAM_LIMIT)
+    return;
+  for (auto &count : calibration.data.bins)
+    count /= 2;
+}
+
+void BedSensor::recalibrate_(ZoneCalibration &calibration, const char *name) {
+  const auto &bins = calibration.data.bins;
+  uint32_t total = 0;
+  float weighted_total = 0.0f;
+  for (uint8_t i = 0; i < HISTOGRAM_BINS; i++) {
+    total += bins[i];
+    weighted_total += static_cast<float>(i) * bins[i];
+  }
+  if (total < MIN_CALIBRATION_SAMPLES)
+    return;
+
+  // Otsu's method: the split that maximises the variance between the two clusters.
+  uint32_t empty_count = 0;
+  float empty_weighted = 0.0f;
+  float best_variance = 0.0f;
+  uint32_t best_empty_count = 0;
+  float best_empty_mean = 0.0f;
+  float best_occupied_mean = 0.0f;
+  for (uint8_t i = 0; i < HISTOGRAM_BINS - 1; i++) {
+    empty_count += bins[i];
+    empty_weighted += static_cast<float>(i) * bins[i];
+    const uint32_t occupied_count = total - empty_count;
+    if (empty_count == 0 || occupied_count == 0)
+      continue;
+    const float empty_mean = empty_weighted / empty_count;
+    const float occupied_mean = (weighted_total - empty_weighted) / occupied_count;
+    const float variance =
+        static_cast<float>(empty_count) * occupied_count * (occupied_mean - empty_mean) * (occupied_mean - empty_mean);
+    if (variance > best_variance) {
+      best_variance = variance;
+      best_empty_count = empty_count;
+      best_empty_mean = empty_mean;
+      best_occupied_mean = occupied_mean;
+    }
+  }
+
+  // Bin indexes to percent, using the bin centres.
+  const float empty_level = (best_empty_mean + 0.5f) * BIN_WIDTH;
+  const float occupied_level = (best_occupied_mean + 0.5f) * BIN_WIDTH;
+  const float min_cluster = MIN_CLUSTER_FRACTION * total;
+  if (best_empty_count < min_cluster || total - best_empty_count < min_cluster ||
+      occupied_level - empty_level < MIN_CLUSTER_SEPARATION) {
+    ESP_LOGD(TAG, "%s: not enough separation to calibrate yet (%.0f%% / %.0f%%)", name, empty_level, occupied_level);
+    calibration.pref.save(&calibration.data);
+    return;
+  }
+
+  const float target = (empty_level + occupied_level) / 2;
+  float &threshold = calibration.data.threshold;
+  threshold = std::isnan(threshold) ? target : threshold + CALIBRATION_RATE * (target - threshold);
+  ESP_LOGD(TAG, "%s: empty %.0f%%, occupied %.0f%%, threshold %.1f%%", name, empty_level, occupied_level, threshold);
+  calibration.pref.save(&calibration.data);
+  if (calibration.threshold_sensor != nullptr)
+    calibration.threshold_sensor->publish_state(threshold);
+}
+
+void BedSensor::adapt_update_interval_(bool active) {
+  if (this->max_update_interval_ == 0)
+    return;
+  // Fast while something is happening, then back off exponentially while the bed is quiet, but never so far that a
+  // zone goes longer than the maximum interval without being read.
+  const uint32_t longest =
+      std::max<uint32_t>(this->max_update_interval_ / this->zones_.size(), this->min_update_interval_);
+  const uint32_t interval = active ? this->min_update_interval_ : std::min(this->get_update_interval() * 2, longest);
+  if (interval == this->get_update_interval())
+    return;
+  ESP_LOGV(TAG, "Update interval: %" PRIu32 " ms", interval);
+  this->set_update_interval(interval);
+  this->start_poller();
+  if (this->update_interval_sensor_ != nullptr)
+    this->update_interval_sensor_->publish_state(interval / 1000.0f);
+}
+
+void BedSensor::publish_value_(sensor::Sensor *sensor, float value, float &last_published) {
+  if (!std::isnan(last_published) && std::fabs(value - last_published) <= this->value_delta_)
+    return;
+  last_published = value;
+  sensor->publish_state(value);
+}
+
+void BedSensor::publish_binary_(binary_sensor::BinarySensor *sensor, bool state, bool last_state) {
+  if (this->published_ && state == last_state)
+    return;
+  sensor->publish_state(state);
 }
 
 }  // namespace esphome::bed_sensor
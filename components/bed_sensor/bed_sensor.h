@@ -1,8 +1,13 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <string>
+#include <vector>
 
 #include "esphome/core/component.h"
+#include "esphome/core/preferences.h"
 
 #include "esphome/components/adc/adc_sensor.h"
 #include "esphome/components/binary_sensor/binary_sensor.h"
@@ -10,60 +15,141 @@
 #include "esphome/components/sensor/sensor.h"
 #include "esphome/components/text_sensor/text_sensor.h"
 
+#include "occupancy.h"
+
 namespace esphome::bed_sensor {
 
+static constexpr uint8_t HISTOGRAM_BINS = 32;
+
+/// Fixed-size histogram of one zone's pressure readings (in percent), persisted so calibration survives reboots.
+struct CalibrationData {
+  std::array<uint16_t, HISTOGRAM_BINS> bins{};
+  float threshold{NAN};  ///< Learned occupied threshold in percent, NAN until both clusters have been seen.
+};
+
+struct ZoneCalibration {
+  CalibrationData data;
+  ESPPreferenceObject pref;
+  sensor::Sensor *threshold_sensor{nullptr};
+};
+
+/// Most zones one BedSensor can multiplex onto its ADC; the occupancy bitmask and status table are sized for this.
+static constexpr uint8_t MAX_ZONES = 6;
+
+/// One pressure pad, powered by its own output and read through the shared ADC.
+struct Zone {
+  output::BinaryOutput *output{nullptr};
+  const char *name{nullptr};
+  sensor::Sensor *value_sensor{nullptr};
+  binary_sensor::BinarySensor *sensor{nullptr};
+  ZoneCalibration calibration{};
+  float value{NAN};
+  float published_value{NAN};
+  float level{NAN};  ///< Smoothed pressure in percent, decides how fast to poll.
+  bool occupied{false};
+};
+
 class BedSensor : public PollingComponent {
  public:
   void set_adc_sensor(adc::ADCSensor *adc_sensor) { this->adc_sensor_ = adc_sensor; }
 
-  void set_side_one_output(output::BinaryOutput *side_one_output) { this->side_one_output_ = side_one_output; }
-  void set_side_one_name(const char *side_one_name) { this->side_one_name_ = side_one_name; }
-  void set_side_one_value_sensor(sensor::Sensor *side_one_value_sensor) {
-    this->side_one_value_sensor_ = side_one_value_sensor;
+  void add_zone(const char *name, output::BinaryOutput *output, sensor::Sensor *value_sensor,
+                binary_sensor::BinarySensor *sensor) {
+    Zone zone;
+    zone.name = name;
+    zone.output = output;
+    zone.value_sensor = value_sensor;
+    zone.sensor = sensor;
+    this->zones_.push_back(zone);
   }
-  void set_side_one_sensor(binary_sensor::BinarySensor *side_one_sensor) { this->side_one_sensor_ = side_one_sensor; }
-
-  void set_side_two_output(output::BinaryOutput *side_two_output) { this->side_two_output_ = side_two_output; }
-  void set_side_two_name(const char *side_two_name) { this->side_two_name_ = side_two_name; }
-  void set_side_two_value_sensor(sensor::Sensor *side_two_value_sensor) {
-    this->side_two_value_sensor_ = side_two_value_sensor;
+  void set_last_zone_threshold_sensor(sensor::Sensor *sensor) {
+    this->zones_.back().calibration.threshold_sensor = sensor;
   }
-  void set_side_two_sensor(binary_sensor::BinarySensor *side_two_sensor) { this->side_two_sensor_ = side_two_sensor; }
 
   void set_someone_sensor(binary_sensor::BinarySensor *someone_in_bed) { this->someone_in_bed_ = someone_in_bed; }
   void set_someone_name(const char *someone_name) { this->someone_name_ = someone_name; }
 
   void set_count_sensor(sensor::Sensor *count) { this->count_ = count; }
+  void set_occupancy_sensor(sensor::Sensor *occupancy) { this->occupancy_ = occupancy; }
 
   void set_status_sensor(text_sensor::TextSensor *status) { this->status_ = status; }
 
+  void set_occupied_threshold(float threshold) { this->occupied_threshold_ = threshold; }
+  void set_occupied_hysteresis(float hysteresis) { this->classifier_.set_occupied_hysteresis(hysteresis); }
+  void set_someone_threshold(float threshold) { this->classifier_.set_someone_threshold(threshold); }
+  void set_someone_hysteresis(float hysteresis) { this->classifier_.set_someone_hysteresis(hysteresis); }
+  void set_value_delta(float value_delta) { this->value_delta_ = value_delta; }
+  void set_settle_time(uint32_t settle_time) { this->settle_time_ = settle_time; }
+  void set_sample_count(uint8_t sample_count) {
+    this->sample_count_ = std::clamp<uint8_t>(sample_count, 1, MAX_SAMPLES);
+  }
+  void set_reduction(SampleReduction reduction) { this->reduction_ = reduction; }
+  void set_adaptive_update_interval(uint32_t min_interval, uint32_t max_interval) {
+    this->min_update_interval_ = min_interval;
+    this->max_update_interval_ = max_interval;
+  }
+  void set_update_interval_sensor(sensor::Sensor *sensor) { this->update_interval_sensor_ = sensor; }
+  void set_adc_resolution(uint8_t bits) { this->adc_full_scale_ = 1 << bits; }
+  void set_auto_calibrate(bool auto_calibrate) { this->auto_calibrate_ = auto_calibrate; }
+
   void setup() override;
   void dump_config() override;
   void update() override;
 
  protected:
-  adc::ADCSensor *adc_sensor_{nullptr};
-
-  output::BinaryOutput *side_one_output_{nullptr};
-  const char *side_one_name_{nullptr};
-  sensor::Sensor *side_one_value_sensor_{nullptr};
-  binary_sensor::BinarySensor *side_one_sensor_{nullptr};
+  /// Takes a burst of sample_count_ samples from the ADC and reduces them to one reading.
+  float acquire_();
+  /// Stores the reading for a zone and publishes whatever changed.
+  void process_reading_(uint8_t index, float value);
+  float to_percent_(float value) const;
+  /// True when a zone's pressure level is close to a threshold and moving towards it.
+  bool approaching_threshold_(float previous_percent, float percent, float occupied_threshold) const;
+  /// The learned occupied threshold for a zone, or the configured one until calibration has enough data.
+  float occupied_threshold_for_(const ZoneCalibration &calibration) const;
+  void load_calibration_(ZoneCalibration &calibration, binary_sensor::BinarySensor *zone_sensor);
+  void record_calibration_sample_(ZoneCalibration &calibration, float percent);
+  /// Splits the histogram into an empty and an occupied cluster and moves the threshold towards the gap between them.
+  void recalibrate_(ZoneCalibration &calibration, const char *name);
+  /// Drops to the minimum update interval when `active`, otherwise doubles it up to the maximum interval shared out
+  /// over the zones.
+  void adapt_update_interval_(bool active);
+  /// Builds the status text for every combination of occupied zones.
+  void build_status_names_();
+  /// Publishes `value` only when it has moved more than value_delta_ from the last published value.
+  void publish_value_(sensor::Sensor *sensor, float value, float &last_published);
+  void publish_binary_(binary_sensor::BinarySensor *sensor, bool state, bool last_state);
 
-  output::BinaryOutput *side_two_output_{nullptr};
-  const char *side_two_name_{nullptr};
-  sensor::Sensor *side_two_value_sensor_{nullptr};
-  binary_sensor::BinarySensor *side_two_sensor_{nullptr};
+  adc::ADCSensor *adc_sensor_{nullptr};
+  std::vector<Zone> zones_;
+  uint8_t next_zone_{0};  ///< Round-robin position of the zone read on the next poll.
 
   binary_sensor::BinarySensor *someone_in_bed_{nullptr};
   const char *someone_name_{nullptr};
 
   sensor::Sensor *count_{nullptr};
+  sensor::Sensor *occupancy_{nullptr};
   text_sensor::TextSensor *status_{nullptr};
-
-  bool last_updated_side_one_{false};
-  std::string combined_name_;
-  float side_one_value_{1024.0f};
-  float side_two_value_{1024.0f};
+  std::vector<std::string> status_names_;  ///< Status text indexed by the occupancy bitmask.
+
+  float occupied_threshold_{75.0f};  ///< Percent pressure above which a zone becomes occupied.
+  OccupancyClassifier classifier_;
+  float value_delta_{8.0f};   ///< Minimum change in a raw value before the value sensor is published again.
+  uint32_t settle_time_{10};  ///< Time (ms) between powering a zone and sampling it.
+  uint8_t sample_count_{5};
+  SampleReduction reduction_{SampleReduction::MEDIAN};
+  bool acquiring_{false};  ///< A zone is powered and waiting for its settle time.
+  uint32_t min_update_interval_{0};
+  uint32_t max_update_interval_{0};  ///< 0 when adaptive polling is disabled.
+  sensor::Sensor *update_interval_sensor_{nullptr};
+  float adc_full_scale_{1024.0f};  ///< Raw reading of an unloaded sensor, 2^adc_resolution.
+  bool auto_calibrate_{false};
+
+  // Last published state; nothing is published again until it changes.
+  bool published_{false};
+  bool someone_in_bed_state_{false};
+  int count_state_{0};
+  uint8_t occupancy_state_{0};
+  const char *status_state_{nullptr};
 };
 
 }  // namespace esphome::bed_sensor
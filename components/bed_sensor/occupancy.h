@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+// The occupancy decision, kept free of ESPHome and hardware so recorded or synthetic pressure traces can be replayed
+// through exactly the code that runs on the bed.
+
+namespace esphome::bed_sensor {
+
+/// How the burst of samples taken for each reading is reduced to one value.
+enum class SampleReduction : uint8_t {
+  MEDIAN,
+  TRIMMED_MEAN,  ///< Mean of the samples left after dropping the lowest and highest quarter.
+};
+
+static constexpr uint8_t MAX_SAMPLES = 16;
+
+/// Sorts the first `count` samples in place and reduces them to one reading.
+inline float reduce_samples(float *samples, uint8_t count, SampleReduction reduction) {
+  std::sort(samples, samples + count);
+
+  if (reduction == SampleReduction::MEDIAN) {
+    const uint8_t mid = count / 2;
+    return count % 2 == 1 ? samples[mid] : (samples[mid - 1] + samples[mid]) / 2;
+  }
+
+  // Trimmed mean: drop the lowest and highest quarter of the samples and average the rest.
+  const uint8_t trim = count / 4;
+  float sum = 0.0f;
+  for (uint8_t i = trim; i < count - trim; i++)
+    sum += samples[i];
+  return sum / (count - 2 * trim);
+}
+
+/// Who is in the bed after a reading.
+struct Occupancy {
+  uint8_t zones{0};     ///< Bitmask of occupied zones, bit 0 for the first zone.
+  bool someone{false};  ///< Someone is in the middle of the bed, between zones.
+
+  int count() const { return __builtin_popcount(this->zones) + (this->someone ? 1 : 0); }
+  bool operator==(const Occupancy &other) const { return this->zones == other.zones && this->someone == other.someone; }
+  bool operator!=(const Occupancy &other) const { return !(*this == other); }
+};
+
+/// Turns the pressure (in percent) on every zone into an Occupancy, with hysteresis on every state.
+class OccupancyClassifier {
+ public:
+  void set_occupied_hysteresis(float hysteresis) { this->occupied_hysteresis_ = hysteresis; }
+  void set_someone_threshold(float threshold) { this->someone_threshold_ = threshold; }
+  void set_someone_hysteresis(float hysteresis) { this->someone_hysteresis_ = hysteresis; }
+  float get_occupied_hysteresis() const { return this->occupied_hysteresis_; }
+  float get_someone_threshold() const { return this->someone_threshold_; }
+  float get_someone_hysteresis() const { return this->someone_hysteresis_; }
+
+  /// Classifies one set of readings. `percents` and `thresholds` hold an entry for each of the `zone_count` zones;
+  /// `detect_someone` is false when nothing consumes the someone state.
+  Occupancy classify(const float *percents, const float *thresholds, uint8_t zone_count, bool detect_someone) {
+    // Each state has to cross back over its threshold by the hysteresis before it clears, so readings hovering
+    // around a threshold don't make the sensors flap.
+    const float someone_limit =
+        this->someone_pressure_ ? this->someone_threshold_ - this->someone_hysteresis_ : this->someone_threshold_;
+    Occupancy occupancy;
+    uint8_t someone_zones = 0;
+    for (uint8_t i = 0; i < zone_count; i++) {
+      const bool was_occupied = (this->last_.zones & (1 << i)) != 0;
+      if (percents[i] > thresholds[i] - (was_occupied ? this->occupied_hysteresis_ : 0.0f))
+        occupancy.zones |= 1 << i;
+      if (percents[i] > someone_limit)
+        someone_zones++;
+    }
+    this->someone_pressure_ = someone_zones >= 2;
+    occupancy.someone = detect_someone && occupancy.zones == 0 && this->someone_pressure_;
+    this->last_ = occupancy;
+    return occupancy;
+  }
+
+ protected:
+  float occupied_hysteresis_{5.0f};  ///< How far below the threshold a zone has to drop to become empty again.
+  float someone_threshold_{40.0f};   ///< Percent pressure on two zones above which someone is between them.
+  float someone_hysteresis_{5.0f};
+  Occupancy last_{};
+  bool someone_pressure_{false};  ///< Two zones above the someone threshold, before excluding occupied zones.
+};
+
+}  // namespace esphome::bed_sensor
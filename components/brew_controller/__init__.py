@@ -0,0 +1,84 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import binary_sensor, output, text_sensor
+from esphome.components import switch as esphome_switch
+from esphome.const import CONF_ID
+
+CODEOWNERS = ["@nuttytree"]
+AUTO_LOAD = ["switch", "text_sensor"]
+
+brew_controller_ns = cg.esphome_ns.namespace("brew_controller")
+BrewController = brew_controller_ns.class_("BrewController", cg.Component)
+BrewSwitch = brew_controller_ns.class_("BrewSwitch", esphome_switch.Switch)
+BrewButton = brew_controller_ns.enum("BrewButton", is_class=True)
+
+CONF_POWER_LIGHT = "power_light"
+CONF_BOLD_LIGHT = "bold_light"
+CONF_POWER_BUTTON = "power_button"
+CONF_BOLD_BUTTON = "bold_button"
+CONF_POWER_SWITCH = "power_switch"
+CONF_BOLD_SWITCH = "bold_switch"
+CONF_STAGE_SENSOR = "stage_sensor"
+CONF_PRE_WET_TIME = "pre_wet_time"
+CONF_BLOOM_TIME = "bloom_time"
+CONF_PRESS_TIME = "press_time"
+CONF_RELEASE_TIME = "release_time"
+
+ICON_COFFEE = "mdi:coffee"
+
+SWITCH_SCHEMA = esphome_switch.switch_schema(
+    BrewSwitch, icon=ICON_COFFEE, default_restore_mode="DISABLED"
+)
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(BrewController),
+        cv.Required(CONF_POWER_LIGHT): cv.use_id(binary_sensor.BinarySensor),
+        cv.Required(CONF_BOLD_LIGHT): cv.use_id(binary_sensor.BinarySensor),
+        cv.Required(CONF_POWER_BUTTON): cv.use_id(output.BinaryOutput),
+        cv.Required(CONF_BOLD_BUTTON): cv.use_id(output.BinaryOutput),
+        cv.Optional(CONF_POWER_SWITCH): SWITCH_SCHEMA,
+        cv.Optional(CONF_BOLD_SWITCH): SWITCH_SCHEMA,
+        cv.Optional(CONF_STAGE_SENSOR): text_sensor.text_sensor_schema(
+            icon="mdi:progress-clock"
+        ),
+        cv.Optional(
+            CONF_PRE_WET_TIME, default="75s"
+        ): cv.positive_time_period_milliseconds,
+        cv.Optional(
+            CONF_BLOOM_TIME, default="45s"
+        ): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_PRESS_TIME, default="200ms"): cv.All(
+            cv.positive_time_period_milliseconds,
+            cv.Range(max=cv.TimePeriod(seconds=2)),
+        ),
+        cv.Optional(CONF_RELEASE_TIME, default="100ms"): cv.All(
+            cv.positive_time_period_milliseconds,
+            cv.Range(max=cv.TimePeriod(seconds=2)),
+        ),
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+
+async def to_code(config):
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+
+    cg.add(var.set_power_light(await cg.get_variable(config[CONF_POWER_LIGHT])))
+    cg.add(var.set_bold_light(await cg.get_variable(config[CONF_BOLD_LIGHT])))
+    cg.add(var.set_power_button(await cg.get_variable(config[CONF_POWER_BUTTON])))
+    cg.add(var.set_bold_button(await cg.get_variable(config[CONF_BOLD_BUTTON])))
+    cg.add(var.set_pre_wet_time(config[CONF_PRE_WET_TIME]))
+    cg.add(var.set_bloom_time(config[CONF_BLOOM_TIME]))
+    cg.add(var.set_press_time(config[CONF_PRESS_TIME]))
+    cg.add(var.set_release_time(config[CONF_RELEASE_TIME]))
+
+    if power_config := config.get(CONF_POWER_SWITCH):
+        sw = await esphome_switch.new_switch(power_config, var, BrewButton.POWER)
+        cg.add(var.set_power_switch(sw))
+    if bold_config := config.get(CONF_BOLD_SWITCH):
+        sw = await esphome_switch.new_switch(bold_config, var, BrewButton.BOLD)
+        cg.add(var.set_bold_switch(sw))
+    if stage_config := config.get(CONF_STAGE_SENSOR):
+        sens = await text_sensor.new_text_sensor(stage_config)
+        cg.add(var.set_stage_sensor(sens))
@@ -0,0 +1,179 @@
+#include "brew_controller.h"
+
+#include "esphome/core/log.h"
+
+#include <cinttypes>
+
+namespace esphome::brew_controller {
+
+static const char *const TAG = "brew_controller";
+// Extra time (ms) given to the coffee maker to turn back on after the bloom before the brew is treated as over.
+static constexpr uint32_t RESUME_MARGIN = 1000;
+
+static const char *brew_stage_to_string(BrewStage stage) {
+  switch (stage) {
+    case BrewStage::PRE_WET:
+      return "Pre-Wet";
+    case BrewStage::BLOOM:
+      return "Bloom";
+    case BrewStage::BREW:
+      return "Brew";
+    default:
+      return "Off";
+  }
+}
+
+void BrewSwitch::write_state(bool state) {
+  // The state is published when the indicator light changes, not when the button is pressed.
+  this->parent_->request(this->button_, state);
+}
+
+void BrewController::setup() {
+  this->power_button_->turn_off();
+  this->bold_button_->turn_off();
+
+  this->power_light_->add_on_state_callback([this](bool state) {
+    if (this->power_switch_ != nullptr)
+      this->power_switch_->publish_state(state);
+    this->on_power_light_(state);
+  });
+  this->bold_light_->add_on_state_callback([this](bool state) {
+    if (this->bold_switch_ != nullptr)
+      this->bold_switch_->publish_state(state);
+  });
+
+  this->set_stage_(BrewStage::OFF);
+}
+
+void BrewController::dump_config() {
+  ESP_LOGCONFIG(TAG, "Brew Controller:");
+  ESP_LOGCONFIG(TAG, "  Pre-Wet Time: %" PRIu32 " ms", this->pre_wet_time_);
+  ESP_LOGCONFIG(TAG, "  Bloom Time: %" PRIu32 " ms", this->bloom_time_);
+  ESP_LOGCONFIG(TAG, "  Button Press: %" PRIu32 " ms, release %" PRIu32 " ms", this->press_time_,
+                this->release_time_);
+  LOG_SWITCH("  ", "Power Switch", this->power_switch_);
+  LOG_SWITCH("  ", "Bold Switch", this->bold_switch_);
+  LOG_TEXT_SENSOR("  ", "Stage", this->stage_sensor_);
+}
+
+void BrewController::request(BrewButton button, bool state) {
+  // Turning the coffee maker off while it blooms cancels the rest of the brew; the light is already off, so there
+  // is nothing to press.
+  if (button == BrewButton::POWER && !state && this->stage_ == BrewStage::BLOOM) {
+    this->cancel_timeout("stage");
+    this->set_stage_(BrewStage::OFF);
+    return;
+  }
+
+  binary_sensor::BinarySensor *light = button == BrewButton::POWER ? this->power_light_ : this->bold_light_;
+  output::BinaryOutput *output = button == BrewButton::POWER ? this->power_button_ : this->bold_button_;
+  // The buttons toggle, so a second press queued before the light catches up would undo the first.
+  if (light->state == state || this->is_pressing_(output))
+    return;
+  this->press_(output);
+}
+
+void BrewController::on_power_light_(bool state) {
+  switch (this->stage_) {
+    case BrewStage::OFF:
+      if (state) {
+        this->bold_brew_ = this->bold_light_->state;
+        this->set_stage_(BrewStage::PRE_WET);
+        this->set_timeout("stage", this->pre_wet_time_, [this]() { this->on_stage_timeout_(); });
+      }
+      break;
+    case BrewStage::PRE_WET:
+    case BrewStage::BREW:
+      // Turned off by hand during the pre-wet, or done brewing.
+      if (!state) {
+        this->cancel_timeout("stage");
+        this->set_stage_(BrewStage::OFF);
+      }
+      break;
+    case BrewStage::BLOOM:
+      // Turned back on by hand before the bloom was over.
+      if (state) {
+        this->cancel_timeout("stage");
+        this->set_stage_(BrewStage::BREW);
+      }
+      break;
+  }
+}
+
+void BrewController::on_stage_timeout_() {
+  switch (this->stage_) {
+    case BrewStage::PRE_WET:
+      // The grounds are wet, pause the brew and let them bloom.
+      this->set_stage_(BrewStage::BLOOM);
+      this->press_(this->power_button_);
+      this->set_timeout("stage", this->bloom_time_, [this]() { this->on_stage_timeout_(); });
+      break;
+    case BrewStage::BLOOM:
+      this->set_stage_(BrewStage::BREW);
+      // Still on means the pause didn't take and it has been brewing all along.
+      if (this->power_light_->state)
+        break;
+      // Resume the brew with the setting it was started with.
+      if (this->bold_brew_ && !this->bold_light_->state)
+        this->press_(this->bold_button_);
+      this->press_(this->power_button_);
+      this->set_timeout("stage", 2 * (this->press_time_ + this->release_time_) + RESUME_MARGIN,
+                        [this]() { this->on_stage_timeout_(); });
+      break;
+    case BrewStage::BREW:
+      // The coffee maker didn't come back on after the bloom.
+      if (!this->power_light_->state)
+        this->set_stage_(BrewStage::OFF);
+      break;
+    default:
+      break;
+  }
+}
+
+void BrewController::set_stage_(BrewStage stage) {
+  this->stage_ = stage;
+  const char *name = brew_stage_to_string(stage);
+  ESP_LOGD(TAG, "Stage: %s", name);
+  if (this->stage_sensor_ != nullptr)
+    this->stage_sensor_->publish_state(name);
+}
+
+void BrewController::press_(output::BinaryOutput *button) {
+  if (this->press_count_ == this->press_queue_.size()) {
+    ESP_LOGW(TAG, "Too many button presses queued, dropping one");
+    return;
+  }
+  this->press_queue_[this->press_count_++] = button;
+  if (this->pressing_ == nullptr)
+    this->next_press_();
+}
+
+void BrewController::next_press_() {
+  if (this->press_count_ == 0) {
+    this->pressing_ = nullptr;
+    return;
+  }
+  output::BinaryOutput *button = this->press_queue_[0];
+  for (uint8_t i = 1; i < this->press_count_; i++)
+    this->press_queue_[i - 1] = this->press_queue_[i];
+  this->press_count_--;
+
+  this->pressing_ = button;
+  button->turn_on();
+  this->set_timeout("press", this->press_time_, [this, button]() {
+    button->turn_off();
+    this->set_timeout("press", this->release_time_, [this]() { this->next_press_(); });
+  });
+}
+
+bool BrewController::is_pressing_(output::BinaryOutput *button) const {
+  if (this->pressing_ == button)
+    return true;
+  for (uint8_t i = 0; i < this->press_count_; i++) {
+    if (this->press_queue_[i] == button)
+      return true;
+  }
+  return false;
+}
+
+}  // namespace esphome::brew_controller
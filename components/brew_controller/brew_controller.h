@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+
+#include "esphome/core/component.h"
+#include "esphome/components/binary_sensor/binary_sensor.h"
+#include "esphome/components/output/binary_output.h"
+#include "esphome/components/switch/switch.h"
+#include "esphome/components/text_sensor/text_sensor.h"
+
+namespace esphome::brew_controller {
+
+/// Where the coffee maker is in a brew. A brew starts with a pre-wet, is paused to let the grounds bloom and is then
+/// resumed to finish, however the coffee maker was turned on.
+enum class BrewStage : uint8_t {
+  OFF,
+  PRE_WET,
+  BLOOM,
+  BREW,
+};
+
+enum class BrewButton : uint8_t {
+  POWER,
+  BOLD,
+};
+
+class BrewController;
+
+/// Exposes one of the coffee maker's buttons as a switch whose state follows the button's indicator light.
+class BrewSwitch : public switch_::Switch {
+ public:
+  BrewSwitch(BrewController *parent, BrewButton button) : parent_(parent), button_(button) {}
+
+ protected:
+  void write_state(bool state) override;
+
+  BrewController *parent_;
+  BrewButton button_;
+};
+
+class BrewController : public Component {
+ public:
+  void set_power_light(binary_sensor::BinarySensor *light) { this->power_light_ = light; }
+  void set_bold_light(binary_sensor::BinarySensor *light) { this->bold_light_ = light; }
+  void set_power_button(output::BinaryOutput *button) { this->power_button_ = button; }
+  void set_bold_button(output::BinaryOutput *button) { this->bold_button_ = button; }
+  void set_power_switch(BrewSwitch *power_switch) { this->power_switch_ = power_switch; }
+  void set_bold_switch(BrewSwitch *bold_switch) { this->bold_switch_ = bold_switch; }
+  void set_stage_sensor(text_sensor::TextSensor *stage_sensor) { this->stage_sensor_ = stage_sensor; }
+  void set_pre_wet_time(uint32_t pre_wet_time) { this->pre_wet_time_ = pre_wet_time; }
+  void set_bloom_time(uint32_t bloom_time) { this->bloom_time_ = bloom_time; }
+  void set_press_time(uint32_t press_time) { this->press_time_ = press_time; }
+  void set_release_time(uint32_t release_time) { this->release_time_ = release_time; }
+
+  void setup() override;
+  void dump_config() override;
+
+  /// Presses `button` if its light doesn't already show `state`. Called by the switches.
+  void request(BrewButton button, bool state);
+
+ protected:
+  void on_power_light_(bool state);
+  /// Ends the current stage when its deadline passes.
+  void on_stage_timeout_();
+  void set_stage_(BrewStage stage);
+
+  /// Queues a press of `button`; presses run one after another without blocking the main loop.
+  void press_(output::BinaryOutput *button);
+  void next_press_();
+  bool is_pressing_(output::BinaryOutput *button) const;
+
+  binary_sensor::BinarySensor *power_light_{nullptr};
+  binary_sensor::BinarySensor *bold_light_{nullptr};
+  output::BinaryOutput *power_button_{nullptr};
+  output::BinaryOutput *bold_button_{nullptr};
+  BrewSwitch *power_switch_{nullptr};
+  BrewSwitch *bold_switch_{nullptr};
+  text_sensor::TextSensor *stage_sensor_{nullptr};
+
+  uint32_t pre_wet_time_{75000};  ///< How long (ms) the coffee maker runs before it is paused for the bloom.
+  uint32_t bloom_time_{45000};    ///< How long (ms) the grounds are left to bloom.
+  uint32_t press_time_{200};      ///< How long (ms) a button is held down.
+  uint32_t release_time_{100};    ///< How long (ms) a button is released before the next press.
+
+  BrewStage stage_{BrewStage::OFF};
+  bool bold_brew_{false};  ///< The bold setting was on when the brew started, restored when it is resumed.
+
+  std::array<output::BinaryOutput *, 4> press_queue_{};
+  uint8_t press_count_{0};
+  output::BinaryOutput *pressing_{nullptr};  ///< Button currently held down or being released.
+};
+
+}  // namespace esphome::brew_controller
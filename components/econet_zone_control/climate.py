@@ -12,6 +12,7 @@ from esphome.components.econet import (
 import esphome.config_validation as cv
 
 DEPENDENCIES = ["econet"]
+AUTO_LOAD = ["loop_profile"]
 
 CONF_OPERATING_MODE_DATAPOINT = "operating_mode_datapoint"
 CONF_MODE_DATAPOINT = "mode_datapoint"
@@ -22,6 +23,7 @@ CONF_AUTOMATIC_FAN_MODE = "automatic_fan_mode"
 CONF_FAN_MODES = "fan_modes"
 CONF_FAN_MODE = "fan_mode"
 CONF_MINIMUM_TEMPERATURE_DELTA = "minimum_temperature_delta"
+CONF_FAN_MODE_TREND = "fan_mode_trend"
 CONF_CURRENT_TEMPERATURE_DATAPOINT = "current_temperature_datapoint"
 CONF_TARGET_TEMPERATURE_LOW_DATAPOINT = "target_temperature_low_datapoint"
 CONF_TARGET_TEMPERATURE_HIGH_DATAPOINT = "target_temperature_high_datapoint"
@@ -95,6 +97,7 @@ CONFIG_SCHEMA = (
                 cv.ensure_list(FAN_MODE_SCHEMA),
                 cv.Length(min=1),
             ),
+            cv.Optional(CONF_FAN_MODE_TREND, default=True): cv.boolean,
         }
     )
     .extend(cv.COMPONENT_SCHEMA)
@@ -149,3 +152,4 @@ async def to_code(config):
                 entry[CONF_FAN_MODE],
             )
         )
+    cg.add(var.set_fan_mode_trend(config[CONF_FAN_MODE_TREND]))
@@ -1,15 +1,30 @@
 #include "econet_zone_control.h"
 
 #include <algorithm>
+#include <cinttypes>
 #include <cmath>
 #include <set>
 
 #include "esphome/core/hal.h"
 #include "esphome/core/log.h"
+#include "esphome/components/loop_profile/loop_profile.h"
 
 namespace esphome::econet_zone_control {
 
 static const char *const TAG = "econet_zone_control";
+static constexpr uint32_t FAN_LOCK_HASH = 0x66616E6C;  // "fanl"
+// Locked zones whose spread has closed to this (°C) are released before the lock expires.
+static constexpr float ZONE_EQUALISED_DELTA = 0.1f;
+// Thermostats report in 0.1°F steps.
+static constexpr float READING_STEP = 0.1f * 5.0f / 9.0f;
+// Rate (°C per minute) above which the spread counts as closing or widening. One reading step in each of the two zones
+// over the shortest span a trend is reported for is still quantisation noise.
+static constexpr float SPREAD_TREND_DEADBAND = 2.0f * READING_STEP / (TREND_MIN_SPAN / 60000.0f);
+// How much further apart than ZONE_EQUALISED_DELTA another pair of zones has to be to release the lock early.
+static constexpr float EARLY_RELEASE_MARGIN = 2.0f * READING_STEP;
+// A setpoint from Home Assistant is resent on this many polls of the primary zone that still report the old value, in
+// case the write was lost; after that a change made at the thermostat meanwhile wins.
+static constexpr uint8_t SETPOINT_RETRIES = 5;
 
 namespace {
 inline float fahrenheit_to_celsius(float f) { return (f - 32.0f) * 5.0f / 9.0f; }
@@ -29,6 +44,10 @@ void EcoNetZoneControl::setup() {
     return;
   }
 
+  this->restore_fan_lock_();
+  // Without a mode datapoint the mode never comes from the primary zone, so there is nothing to wait for
+  this->primary_mode_reported_ = this->mode_id_ == nullptr || !*this->mode_id_;
+
   // Register per-zone listeners
   for (auto &zone_cfg : this->zones_) {
     EconetZone *zp = &zone_cfg;
@@ -44,7 +63,13 @@ void EcoNetZoneControl::setup() {
               return;
             }
             zp->cached_mode = it->mode;
+            if (zp->is_primary && !this->primary_mode_reported_) {
+              ESP_LOGD(TAG, "Primary zone reported its mode");
+              this->primary_mode_reported_ = true;
+            }
             this->update_zones_();
+            if (zp->is_primary)
+              this->update_current_action_();
           },
           false, zone_cfg.src_adr);
     }
@@ -54,6 +79,7 @@ void EcoNetZoneControl::setup() {
           this->current_temperature_id_, zone_cfg.request_mod, false,
           [this, zp](const econet::EconetDatapoint &dp) {
             zp->cached_temperature = fahrenheit_to_celsius(dp.value_float);
+            zp->trend.add(millis(), zp->cached_temperature);
             ESP_LOGD(TAG, "Zone src_adr=0x%08X current_temperature=%.1f°C (%.1f°F)", zp->src_adr,
                      zp->cached_temperature, dp.value_float);
             this->update_zones_();
@@ -67,6 +93,8 @@ void EcoNetZoneControl::setup() {
           [this, zp](const econet::EconetDatapoint &dp) {
             zp->cached_target_low_f = dp.value_float;
             ESP_LOGD(TAG, "Zone src_adr=0x%08X target_temperature_low=%.1f°F", zp->src_adr, dp.value_float);
+            if (zp->is_primary)
+              this->confirm_setpoint_(this->pending_target_low_, this->target_temperature_low_id_, dp.value_float);
             this->update_zones_();
           },
           false, zone_cfg.src_adr);
@@ -78,6 +106,8 @@ void EcoNetZoneControl::setup() {
           [this, zp](const econet::EconetDatapoint &dp) {
             zp->cached_target_high_f = dp.value_float;
             ESP_LOGD(TAG, "Zone src_adr=0x%08X target_temperature_high=%.1f°F", zp->src_adr, dp.value_float);
+            if (zp->is_primary)
+              this->confirm_setpoint_(this->pending_target_high_, this->target_temperature_high_id_, dp.value_float);
             this->update_zones_();
           },
           false, zone_cfg.src_adr);
@@ -149,6 +179,7 @@ void EcoNetZoneControl::dump_config() {
   ESP_LOGCONFIG(TAG, "  Mode Datapoint: %s", dp(this->mode_id_));
   ESP_LOGCONFIG(TAG, "  Operating Mode Datapoint: %s", dp(this->operating_mode_id_));
   ESP_LOGCONFIG(TAG, "  Automatic Fan Mode: %u", this->automatic_fan_mode_);
+  ESP_LOGCONFIG(TAG, "  Fan Mode Trend: %s", YESNO(this->fan_mode_trend_));
   ESP_LOGCONFIG(TAG, "  Current Temp Datapoint: %s", dp(this->current_temperature_id_));
   ESP_LOGCONFIG(TAG, "  Target Temp Low Datapoint: %s", dp(this->target_temperature_low_id_));
   ESP_LOGCONFIG(TAG, "  Target Temp High Datapoint: %s", dp(this->target_temperature_high_id_));
@@ -203,6 +234,7 @@ void EcoNetZoneControl::control(const climate::ClimateCall &call) {
     float val_f = celsius_to_fahrenheit(*call.get_target_temperature_low());
     ESP_LOGD(TAG, "Control: set primary zone target_low=%.1f°F", val_f);
     this->parent_->set_float_datapoint_value(this->target_temperature_low_id_, val_f, this->primary_zone_->src_adr);
+    this->pending_target_low_ = {val_f, SETPOINT_RETRIES};
   }
 
   if (call.get_target_temperature_high().has_value() && this->target_temperature_high_id_ != nullptr &&
@@ -210,15 +242,29 @@ void EcoNetZoneControl::control(const climate::ClimateCall &call) {
     float val_f = celsius_to_fahrenheit(*call.get_target_temperature_high());
     ESP_LOGD(TAG, "Control: set primary zone target_high=%.1f°F", val_f);
     this->parent_->set_float_datapoint_value(this->target_temperature_high_id_, val_f, this->primary_zone_->src_adr);
+    this->pending_target_high_ = {val_f, SETPOINT_RETRIES};
   }
 }
 
+void EcoNetZoneControl::confirm_setpoint_(PendingSetpoint &pending, const char *datapoint_id, float reported_f) {
+  if (std::isnan(pending.value_f))
+    return;
+  if (std::abs(reported_f - pending.value_f) < 0.1f || pending.retries == 0) {
+    pending.value_f = NAN;
+    return;
+  }
+  pending.retries--;
+  ESP_LOGD(TAG, "Primary zone still reports %s=%.1f°F, resending %.1f°F", datapoint_id, reported_f, pending.value_f);
+  this->parent_->set_float_datapoint_value(datapoint_id, pending.value_f, this->primary_zone_->src_adr);
+}
+
 void EcoNetZoneControl::update_zones_() {
+  LOOP_PROFILE("econet_zone_control");
   bool state_changed = false;
 
-  // 1. Mirror primary zone values to this HA climate entity
+  // 1. Mirror primary zone values to this HA climate entity. Its cached mode is only a default until it reports.
   if (this->primary_zone_ != nullptr) {
-    if (this->primary_zone_->cached_mode != this->mode) {
+    if (this->primary_mode_reported_ && this->primary_zone_->cached_mode != this->mode) {
       this->mode = this->primary_zone_->cached_mode;
       state_changed = true;
     }
@@ -311,6 +357,11 @@ void EcoNetZoneControl::update_zones_() {
 }
 
 void EcoNetZoneControl::update_current_action_() {
+  // Until the primary zone has reported its mode the action would be derived from a default, and moving off it
+  // would reset and save the fan zone lock restored at boot.
+  if (!this->primary_mode_reported_)
+    return;
+
   climate::ClimateAction new_action;
   if (this->mode == climate::CLIMATE_MODE_OFF) {
     new_action = climate::CLIMATE_ACTION_OFF;
@@ -341,6 +392,7 @@ void EcoNetZoneControl::update_current_action_() {
     this->zone_lock_until_ = 0;
     this->last_fan_mode_ = 0xFF;
     this->fan_mode_lock_until_ = 0;
+    this->save_fan_lock_();
   }
 
   // Reset fan mode debounce when entering idle/fan from an active state so the
@@ -353,6 +405,7 @@ void EcoNetZoneControl::update_current_action_() {
     ESP_LOGD(TAG, "Entering idle/fan from active state — resetting fan mode debounce");
     this->last_fan_mode_ = 0xFF;
     this->fan_mode_lock_until_ = 0;
+    this->save_fan_lock_();
   }
 
   this->action = new_action;
@@ -364,10 +417,14 @@ void EcoNetZoneControl::update_zone_fan_mode_() {
   if (this->action == climate::CLIMATE_ACTION_OFF)
     return;
 
-  // Wait until every zone has reported a temperature before touching fan modes
+  // Wait until every zone has reported its temperature and current fan modes before touching fan modes, otherwise
+  // every zone that hasn't reported yet gets written to, e.g. right after a reboot
+  const bool has_fan_mode = this->fan_mode_id_ != nullptr && *this->fan_mode_id_;
+  const bool has_fan_mode_no_schedule = this->fan_mode_no_schedule_id_ != nullptr && *this->fan_mode_no_schedule_id_;
   for (const auto &zone : this->zones_) {
-    if (std::isnan(zone.cached_temperature)) {
-      ESP_LOGV(TAG, "Zone src_adr=0x%08X has no temperature yet — deferring fan mode update", zone.src_adr);
+    if (std::isnan(zone.cached_temperature) || (has_fan_mode && zone.cached_fan_mode < 0) ||
+        (has_fan_mode_no_schedule && zone.cached_fan_mode_no_schedule < 0)) {
+      ESP_LOGV(TAG, "Zone src_adr=0x%08X has not reported yet — deferring fan mode update", zone.src_adr);
       return;
     }
   }
@@ -383,25 +440,45 @@ void EcoNetZoneControl::update_zone_fan_mode_() {
     // Zone lock: once zones are assigned, keep them for 15 minutes to prevent flip-flopping.
     // Speed adjustments still happen freely; only the zone selection is frozen.
     uint64_t now = millis_64();
-    if (this->locked_min_zone_ != nullptr && this->locked_max_zone_ != nullptr && now < this->zone_lock_until_) {
-      // Lock still active — use locked zones directly, skip the scan entirely
-      ESP_LOGV(TAG, "Fan zone lock active for %llu more seconds", (this->zone_lock_until_ - now) / 1000ull);
-      min_zone = this->locked_min_zone_;
-      max_zone = this->locked_max_zone_;
-    } else {
-      // Lock expired or not yet set — scan for hottest/coldest zones and lock them
-      for (const auto &zone : this->zones_) {
-        if (min_zone == nullptr || zone.cached_temperature < min_zone->cached_temperature)
-          min_zone = &zone;
-        if (max_zone == nullptr || zone.cached_temperature > max_zone->cached_temperature)
-          max_zone = &zone;
+    bool locked =
+        this->locked_min_zone_ != nullptr && this->locked_max_zone_ != nullptr && now < this->zone_lock_until_;
+    // Once the locked zones have equalised and are known not to be drifting apart again, another pair that is clearly
+    // further apart gets the fan straight away instead of waiting out the lock. Zones that are all within a reading
+    // step or two of each other swap places on every step of jitter, so the new pair has to be apart by at least
+    // EARLY_RELEASE_MARGIN more than the equalised band.
+    if (locked && this->fan_mode_trend_) {
+      const EconetZone *lmin = this->locked_min_zone_;
+      const EconetZone *lmax = this->locked_max_zone_;
+      const float trend = lmax->trend.slope() - lmin->trend.slope();
+      if (lmax->cached_temperature - lmin->cached_temperature <= ZONE_EQUALISED_DELTA && !std::isnan(trend) &&
+          trend <= SPREAD_TREND_DEADBAND) {
+        const EconetZone *coldest = nullptr;
+        const EconetZone *hottest = nullptr;
+        this->find_coldest_and_hottest_(coldest, hottest);
+        if ((coldest != lmin || hottest != lmax) &&
+            hottest->cached_temperature - coldest->cached_temperature >= ZONE_EQUALISED_DELTA + EARLY_RELEASE_MARGIN) {
+          ESP_LOGD(TAG, "Fan zone lock released early: locked zones equalised, 0x%08X-0x%08X are %.2f°C apart",
+                   coldest->src_adr, hottest->src_adr, hottest->cached_temperature - coldest->cached_temperature);
+          locked = false;
+        }
       }
+    }
+    if (!locked) {
+      // Lock expired, not yet set or released early — scan for hottest/coldest zones
+      this->find_coldest_and_hottest_(min_zone, max_zone);
       if (this->locked_min_zone_ != min_zone || this->locked_max_zone_ != max_zone) {
-        ESP_LOGD(TAG, "Fan zone lock set: min=0x%08X max=0x%08X for 15 minutes", min_zone->src_adr, max_zone->src_adr);
+        ESP_LOGD(TAG, "Fan zone lock set: min=0x%08X max=0x%08X for 15 minutes", min_zone->src_adr,
+                 max_zone->src_adr);
       }
       this->locked_min_zone_ = min_zone;
       this->locked_max_zone_ = max_zone;
       this->zone_lock_until_ = now + (15ull * 60ull * 1000ull);
+      this->save_fan_lock_();
+    } else {
+      // Lock still active — use locked zones directly, skip the scan entirely
+      ESP_LOGV(TAG, "Fan zone lock active for %llu more seconds", (this->zone_lock_until_ - now) / 1000ull);
+      min_zone = this->locked_min_zone_;
+      max_zone = this->locked_max_zone_;
     }
 
     float delta = max_zone->cached_temperature - min_zone->cached_temperature;
@@ -415,6 +492,18 @@ void EcoNetZoneControl::update_zone_fan_mode_() {
     }
     fan_mode = (best != nullptr) ? best->id : this->automatic_fan_mode_;
 
+    // Trend hysteresis: don't speed the fan up while the spread is already closing, or slow it down while the spread
+    // is still widening. Without enough history the trend is NAN and the spread alone decides.
+    if (this->fan_mode_trend_ && this->last_fan_mode_ != 0xFF && fan_mode != this->last_fan_mode_) {
+      const float spread_trend = max_zone->trend.slope() - min_zone->trend.slope();
+      const bool faster = this->fan_mode_delta_(fan_mode) > this->fan_mode_delta_(this->last_fan_mode_);
+      if ((faster && spread_trend < -SPREAD_TREND_DEADBAND) || (!faster && spread_trend > SPREAD_TREND_DEADBAND)) {
+        ESP_LOGD(TAG, "Fan mode change %u->%u skipped: spread is %s at %.3f°C/min", this->last_fan_mode_, fan_mode,
+                 faster ? "closing" : "widening", spread_trend);
+        fan_mode = this->last_fan_mode_;
+      }
+    }
+
     // Fan mode change debounce (5 minutes).
     // Allow the first write through unconditionally; after that, hold the current
     // fan_mode for at least 5 minutes before switching to a new one.
@@ -422,6 +511,7 @@ void EcoNetZoneControl::update_zone_fan_mode_() {
       // First application since boot or mode-change reset — write immediately.
       this->last_fan_mode_ = fan_mode;
       this->fan_mode_lock_until_ = now + (5ull * 60ull * 1000ull);
+      this->save_fan_lock_();
     } else if (fan_mode != this->last_fan_mode_) {
       if (now < this->fan_mode_lock_until_) {
         ESP_LOGD(TAG, "Fan mode change %u->%u deferred: lock active for %llu more seconds", this->last_fan_mode_,
@@ -431,6 +521,7 @@ void EcoNetZoneControl::update_zone_fan_mode_() {
         ESP_LOGD(TAG, "Fan mode changing: %u->%u (lock released)", this->last_fan_mode_, fan_mode);
         this->last_fan_mode_ = fan_mode;
         this->fan_mode_lock_until_ = now + (5ull * 60ull * 1000ull);
+        this->save_fan_lock_();
       }
     }
   }  // end IDLE/FAN block
@@ -452,4 +543,64 @@ void EcoNetZoneControl::update_zone_fan_mode_() {
   write_fan(this->fan_mode_no_schedule_id_, &EconetZone::cached_fan_mode_no_schedule);
 }
 
+void EcoNetZoneControl::find_coldest_and_hottest_(const EconetZone *&coldest, const EconetZone *&hottest) const {
+  for (const auto &zone : this->zones_) {
+    if (coldest == nullptr || zone.cached_temperature < coldest->cached_temperature)
+      coldest = &zone;
+    if (hottest == nullptr || zone.cached_temperature > hottest->cached_temperature)
+      hottest = &zone;
+  }
+}
+
+float EcoNetZoneControl::fan_mode_delta_(uint8_t id) const {
+  if (id == this->automatic_fan_mode_)
+    return -INFINITY;
+  for (const auto &entry : this->fan_modes_) {
+    if (entry.id == id)
+      return entry.minimum_temperature_delta;
+  }
+  return -INFINITY;
+}
+
+void EcoNetZoneControl::on_safe_shutdown() {
+  // Save what is left of the locks right before an OTA or requested reboot; after a power cut the values saved when
+  // the locks were set are used, which at worst holds them a little longer than intended
+  if (this->primary_zone_ != nullptr)
+    this->save_fan_lock_();
+}
+
+void EcoNetZoneControl::restore_fan_lock_() {
+  this->fan_lock_pref_ = global_preferences->make_preference<FanLockState>(this->get_object_id_hash() ^ FAN_LOCK_HASH);
+  FanLockState state{};
+  if (!this->fan_lock_pref_.load(&state))
+    return;
+
+  const uint64_t now = millis_64();
+  if (state.zone_lock_remaining > 0 && state.min_zone < this->zones_.size() && state.max_zone < this->zones_.size()) {
+    this->locked_min_zone_ = &this->zones_[state.min_zone];
+    this->locked_max_zone_ = &this->zones_[state.max_zone];
+    this->zone_lock_until_ = now + state.zone_lock_remaining;
+  }
+  this->last_fan_mode_ = state.fan_mode;
+  this->fan_mode_lock_until_ = now + state.fan_mode_lock_remaining;
+  ESP_LOGD(TAG, "Restored fan lock: fan mode %u, zone lock %" PRIu32 " s, fan mode lock %" PRIu32 " s", state.fan_mode,
+           state.zone_lock_remaining / 1000, state.fan_mode_lock_remaining / 1000);
+}
+
+void EcoNetZoneControl::save_fan_lock_() {
+  const uint64_t now = millis_64();
+  auto remaining = [now](uint64_t until) -> uint32_t {
+    return until > now ? static_cast<uint32_t>(std::min<uint64_t>(until - now, UINT32_MAX)) : 0;
+  };
+  FanLockState state{};
+  if (this->locked_min_zone_ != nullptr && this->locked_max_zone_ != nullptr) {
+    state.zone_lock_remaining = remaining(this->zone_lock_until_);
+    state.min_zone = static_cast<uint8_t>(this->locked_min_zone_ - this->zones_.data());
+    state.max_zone = static_cast<uint8_t>(this->locked_max_zone_ - this->zones_.data());
+  }
+  state.fan_mode_lock_remaining = remaining(this->fan_mode_lock_until_);
+  state.fan_mode = this->last_fan_mode_;
+  this->fan_lock_pref_.save(&state);
+}
+
 }  // namespace esphome::econet_zone_control
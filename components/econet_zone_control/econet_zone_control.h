@@ -4,8 +4,10 @@
 #include <vector>
 
 #include "esphome/core/component.h"
+#include "esphome/core/preferences.h"
 #include "esphome/components/climate/climate.h"
 #include "esphome/components/econet/econet.h"
+#include "temperature_trend.h"
 
 namespace esphome::econet_zone_control {
 
@@ -30,6 +32,23 @@ struct EconetZone {
   climate::ClimateMode cached_mode{climate::CLIMATE_MODE_OFF};
   int16_t cached_fan_mode{-1};  // -1 = not yet received
   int16_t cached_fan_mode_no_schedule{-1};
+  TemperatureTrend trend;  // °C per minute, fed by the current temperature listener
+};
+
+/// Fan zone lock and debounce saved across reboots, so an OTA doesn't re-decide (and rewrite) the fan modes within
+/// seconds of the previous decision. Durations are what was left when saved and restart counting at boot.
+struct FanLockState {
+  uint32_t zone_lock_remaining;      ///< ms left on the zone lock, 0 = not locked.
+  uint32_t fan_mode_lock_remaining;  ///< ms left on the fan mode debounce.
+  uint8_t min_zone;                  ///< Index into zones_ of the locked coldest zone.
+  uint8_t max_zone;                  ///< Index into zones_ of the locked hottest zone.
+  uint8_t fan_mode;                  ///< last_fan_mode_, 0xFF = never written.
+};
+
+/// A setpoint written from Home Assistant that the primary zone hasn't reported back yet.
+struct PendingSetpoint {
+  float value_f{NAN};  ///< NAN = nothing pending.
+  uint8_t retries{0};  ///< Resends left before the write is given up on.
 };
 
 class EcoNetZoneControl : public climate::Climate, public Component, public econet::EconetClient {
@@ -43,6 +62,7 @@ class EcoNetZoneControl : public climate::Climate, public Component, public econ
   void add_mode(uint8_t id, climate::ClimateMode mode) { modes_.push_back({id, mode}); }
   void set_automatic_fan_mode(uint8_t mode) { automatic_fan_mode_ = mode; }
   void add_fan_mode(float min_delta, uint8_t id) { fan_modes_.push_back({min_delta, id}); }
+  void set_fan_mode_trend(bool fan_mode_trend) { fan_mode_trend_ = fan_mode_trend; }
   void set_current_temperature_id(const char *id) { current_temperature_id_ = id; }
   void set_target_temperature_low_id(const char *id) { target_temperature_low_id_ = id; }
   void set_target_temperature_high_id(const char *id) { target_temperature_high_id_ = id; }
@@ -52,6 +72,7 @@ class EcoNetZoneControl : public climate::Climate, public Component, public econ
 
   void setup() override;
   void dump_config() override;
+  void on_safe_shutdown() override;
 
  protected:
   climate::ClimateTraits traits() override;
@@ -59,17 +80,29 @@ class EcoNetZoneControl : public climate::Climate, public Component, public econ
 
   // Called by listeners to re-evaluate all sync and fan logic
   void update_zones_();
-  // Called by the operating mode listener
+  // Called by the operating mode listener and when the primary zone reports its mode
   void update_current_action_();
   // Called by update_zones_
   void update_zone_fan_mode_();
+  // Sets the zones with the lowest and highest temperature
+  void find_coldest_and_hottest_(const EconetZone *&coldest, const EconetZone *&hottest) const;
+  // Minimum temperature delta of the fan mode with the given enum, -infinity for automatic or an unknown enum
+  float fan_mode_delta_(uint8_t id) const;
+  // Called when the primary zone reports a setpoint; resends `pending` until the reported value matches it
+  void confirm_setpoint_(PendingSetpoint &pending, const char *datapoint_id, float reported_f);
+  // Called by setup() once zones_ is final
+  void restore_fan_lock_();
+  // Called whenever the zone lock or fan mode debounce changes, and before a reboot
+  void save_fan_lock_();
 
   // Pointer to primary zone — set in setup() after zones_ vector is finalized
   EconetZone *primary_zone_{nullptr};
   std::vector<EconetZone> zones_;
   std::string operating_mode_state_;
+  bool primary_mode_reported_{false};  ///< The primary zone has reported its mode since boot.
   uint8_t automatic_fan_mode_{0};
   std::vector<FanModeEntry> fan_modes_;
+  bool fan_mode_trend_{true};  ///< Use the zone trends for the fan mode and to release the zone lock early.
   std::vector<ModeEntry> modes_;
   const char *current_temperature_id_{nullptr};
   const char *target_temperature_low_id_{nullptr};
@@ -79,11 +112,14 @@ class EcoNetZoneControl : public climate::Climate, public Component, public econ
   const char *current_humidity_id_{nullptr};
   const char *operating_mode_id_{nullptr};
   const char *mode_id_{nullptr};
+  PendingSetpoint pending_target_low_;
+  PendingSetpoint pending_target_high_;
   const EconetZone *locked_min_zone_{nullptr};
   const EconetZone *locked_max_zone_{nullptr};
   uint64_t zone_lock_until_{0};
   uint8_t last_fan_mode_{0xFF};      ///< Last spread_mode written; 0xFF = never written.
   uint64_t fan_mode_lock_until_{0};  ///< Do not change spread_mode before this millis_64() timestamp.
+  ESPPreferenceObject fan_lock_pref_;
 };
 
 }  // namespace esphome::econet_zone_control
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+// The temperature trend of a zone, kept free of ESPHome so recorded thermostat readings can be replayed through exactly
+// the code that picks the fan modes.
+
+namespace esphome::econet_zone_control {
+
+/// Readings kept per zone. With at most one reading per TREND_SAMPLE_INTERVAL this spans the last ~16 minutes.
+static constexpr uint8_t TREND_SAMPLES = 16;
+/// Readings within this long of the first one in the newest slot share that slot, each replacing the last one's time
+/// and temperature.
+static constexpr uint32_t TREND_SAMPLE_INTERVAL = 60 * 1000;
+/// The readings have to span at least this long before a slope is reported, thermostats only report in 0.1°F steps.
+static constexpr uint32_t TREND_MIN_SPAN = 5 * 60 * 1000;
+
+/// Fixed-size ring buffer of timestamped temperatures with a least-squares slope over them.
+class TemperatureTrend {
+ public:
+  /// Adds a reading taken at `time` (millis()).
+  void add(uint32_t time, float temperature) {
+    if (std::isnan(temperature))
+      return;
+    if (this->count_ > 0 && time - this->slot_started_ < TREND_SAMPLE_INTERVAL) {
+      this->readings_[this->newest_] = {time, temperature};
+      return;
+    }
+    this->newest_ = (this->newest_ + 1) % TREND_SAMPLES;
+    this->readings_[this->newest_] = {time, temperature};
+    this->slot_started_ = time;
+    if (this->count_ < TREND_SAMPLES)
+      this->count_++;
+  }
+
+  void clear() { this->count_ = 0; }
+  uint8_t size() const { return this->count_; }
+
+  /// Least-squares slope of the readings in degrees per minute, NAN until they span at least TREND_MIN_SPAN.
+  float slope() const {
+    if (this->count_ < 2)
+      return NAN;
+    const uint32_t newest = this->at_(0).time;
+    if (newest - this->at_(this->count_ - 1).time < TREND_MIN_SPAN)
+      return NAN;
+
+    // Times relative to the newest reading, in minutes, so the sums stay small enough for a float.
+    float sum_t = 0.0f, sum_y = 0.0f, sum_tt = 0.0f, sum_ty = 0.0f;
+    for (uint8_t i = 0; i < this->count_; i++) {
+      const Reading &reading = this->at_(i);
+      const float t = -static_cast<float>(newest - reading.time) / 60000.0f;
+      sum_t += t;
+      sum_y += reading.temperature;
+      sum_tt += t * t;
+      sum_ty += t * reading.temperature;
+    }
+    const float n = this->count_;
+    const float denominator = n * sum_tt - sum_t * sum_t;
+    if (denominator <= 0.0f)
+      return NAN;
+    return (n * sum_ty - sum_t * sum_y) / denominator;
+  }
+
+ protected:
+  struct Reading {
+    uint32_t time;
+    float temperature;
+  };
+
+  /// The reading `age` places before the newest one.
+  const Reading &at_(uint8_t age) const {
+    return this->readings_[(this->newest_ + TREND_SAMPLES - age) % TREND_SAMPLES];
+  }
+
+  std::array<Reading, TREND_SAMPLES> readings_{};
+  uint32_t slot_started_{0};  ///< Time of the first reading in the newest slot.
+  uint8_t newest_{TREND_SAMPLES - 1};
+  uint8_t count_{0};
+};
+
+}  // namespace esphome::econet_zone_control
@@ -0,0 +1,109 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor, time
+from esphome.const import (
+    CONF_ENERGY,
+    CONF_ID,
+    CONF_POWER,
+    CONF_SENSOR,
+    CONF_TIME_ID,
+    DEVICE_CLASS_ENERGY,
+    DEVICE_CLASS_POWER,
+    STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
+    UNIT_WATT,
+    UNIT_WATT_HOURS,
+)
+
+CODEOWNERS = ["@nuttytree"]
+DEPENDENCIES = ["time"]
+AUTO_LOAD = ["sensor"]
+
+energy_aggregator_ns = cg.esphome_ns.namespace("energy_aggregator")
+EnergyAggregator = energy_aggregator_ns.class_(
+    "EnergyAggregator", cg.PollingComponent
+)
+
+CONF_MAINS = "mains"
+CONF_CIRCUITS = "circuits"
+CONF_TOTAL = "total"
+CONF_BALANCE = "balance"
+CONF_POWER_INTERVAL = "power_interval"
+CONF_ENERGY_INTERVAL = "energy_interval"
+
+POWER_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_WATT,
+    accuracy_decimals=1,
+    device_class=DEVICE_CLASS_POWER,
+    state_class=STATE_CLASS_MEASUREMENT,
+)
+ENERGY_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_WATT_HOURS,
+    accuracy_decimals=0,
+    device_class=DEVICE_CLASS_ENERGY,
+    state_class=STATE_CLASS_TOTAL_INCREASING,
+)
+
+DERIVED_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_POWER): POWER_SCHEMA,
+        cv.Optional(CONF_ENERGY): ENERGY_SCHEMA,
+    }
+)
+CHANNEL_SCHEMA = DERIVED_SCHEMA.extend(
+    {
+        cv.Required(CONF_SENSOR): cv.use_id(sensor.Sensor),
+    }
+)
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(EnergyAggregator),
+        cv.GenerateID(CONF_TIME_ID): cv.use_id(time.RealTimeClock),
+        cv.Required(CONF_MAINS): cv.All(
+            cv.ensure_list(CHANNEL_SCHEMA), cv.Length(min=1, max=255)
+        ),
+        cv.Optional(CONF_CIRCUITS, default=[]): cv.ensure_list(CHANNEL_SCHEMA),
+        cv.Optional(CONF_TOTAL, default={}): DERIVED_SCHEMA,
+        cv.Optional(CONF_BALANCE, default={}): DERIVED_SCHEMA,
+        cv.Optional(
+            CONF_POWER_INTERVAL, default="5s"
+        ): cv.positive_time_period_milliseconds,
+        cv.Optional(
+            CONF_ENERGY_INTERVAL, default="60s"
+        ): cv.positive_time_period_milliseconds,
+    }
+).extend(cv.polling_component_schema("never"))
+
+
+async def _derived_sensors(config):
+    power = cg.nullptr
+    energy = cg.nullptr
+    if power_config := config.get(CONF_POWER):
+        power = await sensor.new_sensor(power_config)
+    if energy_config := config.get(CONF_ENERGY):
+        energy = await sensor.new_sensor(energy_config)
+    return power, energy
+
+
+async def to_code(config):
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+
+    cg.add(var.set_time(await cg.get_variable(config[CONF_TIME_ID])))
+    cg.add(var.set_power_interval(config[CONF_POWER_INTERVAL]))
+    cg.add(var.set_energy_interval(config[CONF_ENERGY_INTERVAL]))
+
+    for main_config in config[CONF_MAINS]:
+        source = await cg.get_variable(main_config[CONF_SENSOR])
+        power, energy = await _derived_sensors(main_config)
+        cg.add(var.add_main(source, power, energy))
+    for circuit_config in config[CONF_CIRCUITS]:
+        source = await cg.get_variable(circuit_config[CONF_SENSOR])
+        power, energy = await _derived_sensors(circuit_config)
+        cg.add(var.add_circuit(source, power, energy))
+
+    power, energy = await _derived_sensors(config[CONF_TOTAL])
+    cg.add(var.set_total_sensors(power, energy))
+    power, energy = await _derived_sensors(config[CONF_BALANCE])
+    cg.add(var.set_balance_sensors(power, energy))
@@ -0,0 +1,111 @@
+#include "energy_aggregator.h"
+
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+#include <cinttypes>
+#include <cmath>
+
+namespace esphome::energy_aggregator {
+
+static const char *const TAG = "energy_aggregator";
+// mW·ms in a mWh.
+static constexpr uint64_t MS_PER_HOUR = 60 * 60 * 1000;
+
+void EnergyAggregator::setup() {
+  this->set_interval("power", this->power_interval_, [this]() {
+    this->check_midnight_();
+    this->publish_power_();
+  });
+  this->set_interval("energy", this->energy_interval_, [this]() { this->publish_energy_(); });
+}
+
+void EnergyAggregator::dump_config() {
+  ESP_LOGCONFIG(TAG, "Energy Aggregator:");
+  ESP_LOGCONFIG(TAG, "  Mains: %u", this->main_count_);
+  ESP_LOGCONFIG(TAG, "  Circuits: %u", static_cast<unsigned>(this->channels_.size() - this->main_count_));
+  ESP_LOGCONFIG(TAG, "  Power Interval: %" PRIu32 " ms", this->power_interval_);
+  ESP_LOGCONFIG(TAG, "  Energy Interval: %" PRIu32 " ms", this->energy_interval_);
+  LOG_UPDATE_INTERVAL(this);
+  LOG_SENSOR("  ", "Total Power", this->total_.power_sensor);
+  LOG_SENSOR("  ", "Total Energy", this->total_.energy_sensor);
+  LOG_SENSOR("  ", "Balance Power", this->balance_.power_sensor);
+  LOG_SENSOR("  ", "Balance Energy", this->balance_.energy_sensor);
+}
+
+void EnergyAggregator::update() {
+  const uint32_t now = millis();
+  // The first update only has the readings, energy accumulates over the time between updates.
+  const uint32_t elapsed = this->updated_ ? now - this->last_update_ : 0;
+  this->last_update_ = now;
+  this->updated_ = true;
+
+  uint32_t mains = 0;
+  uint32_t circuits = 0;
+  for (uint8_t i = 0; i < this->channels_.size(); i++) {
+    Channel &channel = this->channels_[i];
+    const float watts = channel.source->state;
+    // Sources that haven't reported yet are NAN, and a negative reading is only CT clamp noise.
+    const uint32_t milliwatts = std::isnan(watts) || watts <= 0.0f ? 0 : static_cast<uint32_t>(watts * 1000.0f);
+    integrate_(channel, milliwatts, elapsed);
+    if (i < this->main_count_) {
+      mains += milliwatts;
+    } else {
+      circuits += milliwatts;
+    }
+  }
+  integrate_(this->total_, mains, elapsed);
+  integrate_(this->balance_, mains > circuits ? mains - circuits : 0, elapsed);
+  this->samples_++;
+}
+
+void EnergyAggregator::integrate_(Channel &channel, uint32_t milliwatts, uint32_t elapsed) {
+  channel.power_sum += milliwatts;
+  channel.energy += static_cast<uint64_t>(milliwatts) * elapsed;
+}
+
+void EnergyAggregator::publish_power_() {
+  if (this->samples_ == 0)
+    return;
+  auto publish = [this](Channel &channel) {
+    if (channel.power_sensor != nullptr)
+      channel.power_sensor->publish_state(static_cast<float>(channel.power_sum / this->samples_) / 1000.0f);
+    channel.power_sum = 0;
+  };
+  for (auto &channel : this->channels_)
+    publish(channel);
+  publish(this->total_);
+  publish(this->balance_);
+  this->samples_ = 0;
+}
+
+void EnergyAggregator::publish_energy_() {
+  auto publish = [](Channel &channel) {
+    if (channel.energy_sensor != nullptr)
+      channel.energy_sensor->publish_state(static_cast<float>(channel.energy / MS_PER_HOUR) / 1000.0f);
+  };
+  for (auto &channel : this->channels_)
+    publish(channel);
+  publish(this->total_);
+  publish(this->balance_);
+}
+
+void EnergyAggregator::check_midnight_() {
+  const ESPTime now = this->time_->now();
+  if (!now.is_valid() || now.day_of_year == this->day_of_year_)
+    return;
+  const bool first = this->day_of_year_ == -1;
+  this->day_of_year_ = now.day_of_year;
+  // Whatever was measured before the clock was set belongs to today.
+  if (first)
+    return;
+
+  ESP_LOGD(TAG, "New day, resetting daily energy");
+  for (auto &channel : this->channels_)
+    channel.energy = 0;
+  this->total_.energy = 0;
+  this->balance_.energy = 0;
+  this->publish_energy_();
+}
+
+}  // namespace esphome::energy_aggregator
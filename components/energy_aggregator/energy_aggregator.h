@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+
+#include "esphome/core/component.h"
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/components/time/real_time_clock.h"
+
+namespace esphome::energy_aggregator {
+
+/// One power reading and its integrators. Everything is kept in integer milliwatts so a day of tiny per-update
+/// increments adds up exactly instead of disappearing into the rounding of a float.
+struct Channel {
+  sensor::Sensor *source{nullptr};         ///< Raw power sensor (W), nullptr for the derived total and balance.
+  sensor::Sensor *power_sensor{nullptr};   ///< Average power (W) over the power interval.
+  sensor::Sensor *energy_sensor{nullptr};  ///< Energy (Wh) since midnight.
+  uint64_t power_sum{0};                   ///< Sum of the readings (mW) since power was last published.
+  uint64_t energy{0};                      ///< Energy (mW·ms) since midnight.
+};
+
+class EnergyAggregator : public PollingComponent {
+ public:
+  void add_main(sensor::Sensor *source, sensor::Sensor *power_sensor, sensor::Sensor *energy_sensor) {
+    this->channels_.insert(this->channels_.begin() + this->main_count_++, {source, power_sensor, energy_sensor});
+  }
+  void add_circuit(sensor::Sensor *source, sensor::Sensor *power_sensor, sensor::Sensor *energy_sensor) {
+    this->channels_.push_back({source, power_sensor, energy_sensor});
+  }
+  void set_total_sensors(sensor::Sensor *power_sensor, sensor::Sensor *energy_sensor) {
+    this->total_.power_sensor = power_sensor;
+    this->total_.energy_sensor = energy_sensor;
+  }
+  void set_balance_sensors(sensor::Sensor *power_sensor, sensor::Sensor *energy_sensor) {
+    this->balance_.power_sensor = power_sensor;
+    this->balance_.energy_sensor = energy_sensor;
+  }
+  void set_time(time::RealTimeClock *time) { this->time_ = time; }
+  void set_power_interval(uint32_t power_interval) { this->power_interval_ = power_interval; }
+  void set_energy_interval(uint32_t energy_interval) { this->energy_interval_ = energy_interval; }
+
+  float get_setup_priority() const override { return setup_priority::DATA; }
+  void setup() override;
+  void dump_config() override;
+  /// Folds the current state of every source into the integrators. Normally run from the meter's on_update trigger.
+  void update() override;
+
+ protected:
+  void publish_power_();
+  void publish_energy_();
+  /// Clears the energy integrators once the local date changes.
+  void check_midnight_();
+  static void integrate_(Channel &channel, uint32_t milliwatts, uint32_t elapsed);
+
+  std::vector<Channel> channels_;  ///< Mains first, then circuits, so one pass over the array sums both.
+  uint8_t main_count_{0};
+  Channel total_{};    ///< Sum of the mains.
+  Channel balance_{};  ///< Total less the circuits, i.e. whatever isn't on a CT clamp.
+
+  time::RealTimeClock *time_{nullptr};
+  uint32_t power_interval_{5000};
+  uint32_t energy_interval_{60000};
+  uint32_t samples_{0};  ///< Updates since power was last published; every channel is sampled on every update.
+  uint32_t last_update_{0};
+  bool updated_{false};
+  int day_of_year_{-1};  ///< Local day the energy integrators belong to, -1 until the time is valid.
+};
+
+}  // namespace esphome::energy_aggregator
@@ -2,7 +2,9 @@
 
 #include "esphome/core/hal.h"
 #include "esphome/core/log.h"
+#include "esphome/components/loop_profile/loop_profile.h"
 
+#include <cinttypes>
 #include <cmath>
 
 namespace esphome::high_temp_water_heater {
@@ -20,20 +22,30 @@ static bool floats_equal(float a, float b) {
 
 static const char *const TAG = "water_heater.high_temp_water_heater";
 
+// Smoothing factor for the per-mode heating rate; recent cycles dominate as the tank and source age.
+static constexpr float HEATING_RATE_ALPHA = 0.3f;
+static constexpr uint32_t STATS_PUBLISH_INTERVAL_MS = 60000;
+
 void HighTempWaterHeater::setup() {
   // Note: WaterHeater has no state callback, so the source is polled via loop().
-  if (this->temperature_sensor_ != nullptr) {
-    auto unit = this->temperature_sensor_->get_unit_of_measurement_ref();
+  // Tank sensors do have callbacks, so fusion runs as each reading arrives.
+  for (uint8_t i = 0; i < this->temperature_sensor_count_; i++) {
+    TankSensor *ts = &this->temperature_sensors_[i];
+    auto unit = ts->sensor->get_unit_of_measurement_ref();
     // "\xc2\xb0F" is the UTF-8 encoding of "°F"
-    this->temperature_sensor_is_fahrenheit_ = (unit == "\xc2\xb0\x46");
-    ESP_LOGD(TAG, "Temperature sensor unit: '%s' — treating as %s", unit.c_str(),
-             this->temperature_sensor_is_fahrenheit_ ? "\xc2\xb0\x46" : "\xc2\xb0\x43");
+    ts->is_fahrenheit = (unit == "\xc2\xb0\x46");
+    ESP_LOGD(TAG, "Temperature sensor '%s' unit: '%s' — treating as %s", ts->sensor->get_name().c_str(), unit.c_str(),
+             ts->is_fahrenheit ? "\xc2\xb0\x46" : "\xc2\xb0\x43");
+    ts->sensor->add_on_state_callback([this, ts](float state) { this->on_temperature_sensor_(*ts, state); });
+    this->on_temperature_sensor_(*ts, ts->sensor->state);
   }
 
+  // Read the saved state first: the initial sync publishes, which saves over it.
+  auto restore = this->restore_state_();
+
   // Initial sync before restoring state.
   this->update_state_();
 
-  auto restore = this->restore_state_();
   if (restore.has_value()) {
     // perform() calls control() which calls apply_control_() and publish_state().
     restore->perform();
@@ -45,19 +57,34 @@ void HighTempWaterHeater::setup() {
     this->apply_control_();
     this->publish_state();
   }
+  this->publish_command_stats_();
+
+  this->stats_start_ms_ = millis_64();
+  this->publish_cycle_stats_();
+  this->set_interval("stats", STATS_PUBLISH_INTERVAL_MS, [this]() { this->publish_cycle_stats_(); });
 }
 
-void HighTempWaterHeater::loop() { this->update_state_(); }
+void HighTempWaterHeater::loop() {
+  LOOP_PROFILE("high_temp_water_heater");
+  this->update_state_();
+}
 
 void HighTempWaterHeater::dump_config() {
   LOG_WATER_HEATER("", "High Temp Water Heater", this);
   ESP_LOGCONFIG(TAG, "  Source Water Heater: %s", this->source_->get_name().c_str());
-  if (this->temperature_sensor_ != nullptr) {
-    ESP_LOGCONFIG(TAG, "  Temperature Sensor: %s", this->temperature_sensor_->get_name().c_str());
-    ESP_LOGCONFIG(TAG, "  Temperature Sensor Offset: %.1f", this->temperature_sensor_offset_);
+  for (uint8_t i = 0; i < this->temperature_sensor_count_; i++) {
+    const TankSensor &ts = this->temperature_sensors_[i];
+    ESP_LOGCONFIG(TAG, "  Temperature Sensor: %s", ts.sensor->get_name().c_str());
+    ESP_LOGCONFIG(TAG, "    Offset: %.1f", ts.offset);
+    ESP_LOGCONFIG(TAG, "    Weight: %.2f", ts.weight);
+    if (!std::isnan(ts.draw_rate))
+      ESP_LOGCONFIG(TAG, "    Draw Rate: %.2f/min (hold %" PRIu32 " ms)", ts.draw_rate, this->draw_hold_ms_);
   }
   ESP_LOGCONFIG(TAG, "  Dead Band: %.1f", this->dead_band_);
   ESP_LOGCONFIG(TAG, "  Over Run: %.1f", this->over_run_);
+  ESP_LOGCONFIG(TAG, "  Command Timeout: %" PRIu32 " ms", this->command_timeout_ms_);
+  LOG_SENSOR("  ", "Command Retries", this->command_retries_sensor_);
+  LOG_SENSOR("  ", "Command Mismatches", this->command_mismatches_sensor_);
 }
 
 water_heater::WaterHeaterTraits HighTempWaterHeater::traits() {
@@ -121,14 +148,11 @@ void HighTempWaterHeater::update_state_() {
     changed = true;
   }
 
-  // Derive monitored_temp_ from the sensor (with unit conversion + offset) when
-  // configured, otherwise fall back to current_temperature_.
+  // Derive monitored_temp_ from the fused tank sensors when configured,
+  // otherwise fall back to current_temperature_.
   float new_monitored;
-  if (this->temperature_sensor_ != nullptr) {
-    float raw = this->temperature_sensor_->state;
-    float sensor_c =
-        (this->temperature_sensor_is_fahrenheit_ && !std::isnan(raw)) ? (raw - 32.0f) * (5.0f / 9.0f) : raw;
-    new_monitored = sensor_c + this->temperature_sensor_offset_;
+  if (this->temperature_sensor_count_ > 0) {
+    new_monitored = this->fused_weight_ > 0.0f ? this->fused_weighted_sum_ / this->fused_weight_ : NAN;
   } else {
     new_monitored = this->current_temperature_;
   }
@@ -142,12 +166,110 @@ void HighTempWaterHeater::update_state_() {
     this->publish_state();
 }
 
+void HighTempWaterHeater::on_temperature_sensor_(TankSensor &ts, float raw) {
+  LOOP_PROFILE("high_temp_water_heater.sensor");
+  float temp_c = (ts.is_fahrenheit && !std::isnan(raw)) ? (raw - 32.0f) * (5.0f / 9.0f) : raw;
+
+  // Swap this sensor's previous contribution for the new one instead of re-summing every sensor.
+  if (!std::isnan(ts.last_c)) {
+    this->fused_weighted_sum_ -= (ts.last_c + ts.offset) * ts.weight;
+    this->fused_weight_ -= ts.weight;
+  }
+  if (!std::isnan(temp_c)) {
+    this->fused_weighted_sum_ += (temp_c + ts.offset) * ts.weight;
+    this->fused_weight_ += ts.weight;
+  }
+  if (this->fused_weight_ <= 0.0f) {
+    // No sensor has a reading; clear any accumulated rounding error.
+    this->fused_weighted_sum_ = 0.0f;
+    this->fused_weight_ = 0.0f;
+  }
+  ts.last_c = temp_c;
+
+  if (!std::isnan(ts.draw_rate))
+    this->check_draw_(ts, temp_c);
+}
+
+void HighTempWaterHeater::check_draw_(TankSensor &ts, float temp_c) {
+  // Minimum span a drop is measured over so a single quantization step can't look like a draw.
+  static constexpr uint32_t DRAW_WINDOW_MS = 60000;
+
+  const uint32_t now = millis();
+  if (std::isnan(temp_c) || std::isnan(ts.draw_ref_c) || temp_c > ts.draw_ref_c) {
+    ts.draw_ref_c = temp_c;
+    ts.draw_ref_ms = now;
+    return;
+  }
+
+  const uint32_t elapsed = now - ts.draw_ref_ms;
+  if (elapsed < DRAW_WINDOW_MS)
+    return;
+
+  const float rate = (ts.draw_ref_c - temp_c) * 60000.0f / static_cast<float>(elapsed);
+  if (rate >= ts.draw_rate) {
+    if (!this->draw_detected_) {
+      ESP_LOGD(TAG, "Draw detected on '%s': falling %.2f/min", ts.sensor->get_name().c_str(), rate);
+    }
+    this->draw_detected_ = true;
+    this->draw_detected_ms_ = now;
+  }
+  ts.draw_ref_c = temp_c;
+  ts.draw_ref_ms = now;
+}
+
+bool HighTempWaterHeater::is_draw_active_() {
+  if (this->draw_detected_ && millis() - this->draw_detected_ms_ >= this->draw_hold_ms_)
+    this->draw_detected_ = false;
+  return this->draw_detected_;
+}
+
+template<typename T> bool HighTempWaterHeater::should_send_(SourceCommand<T> &cmd, T desired, T reported) {
+  if (cmd.pending && reported == cmd.value) {
+    cmd.pending = false;
+    cmd.confirmed = true;
+  }
+
+  if (desired == reported) {
+    // Nothing to do; also drop any in-flight command for a value we no longer want.
+    cmd.pending = false;
+    return false;
+  }
+
+  const uint32_t now = millis();
+  if (cmd.pending && cmd.value == desired) {
+    // Same command still in flight — wait for the bus round-trip before repeating it.
+    if (now - cmd.sent_ms < this->command_timeout_ms_)
+      return false;
+    this->command_retries_++;
+    ESP_LOGW(TAG, "Source did not confirm command within %" PRIu32 " ms, retrying", this->command_timeout_ms_);
+    this->publish_command_stats_();
+  } else if (!cmd.pending && cmd.confirmed && cmd.value == desired) {
+    // The source confirmed this value earlier and has since drifted away from it.
+    this->command_mismatches_++;
+    ESP_LOGW(TAG, "Source drifted away from a confirmed command, re-sending");
+    this->publish_command_stats_();
+  }
+
+  cmd.value = desired;
+  cmd.sent_ms = now;
+  cmd.pending = true;
+  cmd.confirmed = false;
+  return true;
+}
+
+void HighTempWaterHeater::publish_command_stats_() {
+  if (this->command_retries_sensor_ != nullptr)
+    this->command_retries_sensor_->publish_state(this->command_retries_);
+  if (this->command_mismatches_sensor_ != nullptr)
+    this->command_mismatches_sensor_->publish_state(this->command_mismatches_);
+}
+
 void HighTempWaterHeater::apply_control_() {
   if (this->source_ == nullptr)
     return;
 
   // Mirror away mode to child if it differs.
-  if (this->is_away() != this->source_->is_away()) {
+  if (this->should_send_(this->away_command_, this->is_away(), this->source_->is_away())) {
     auto call = this->source_->make_call();
     call.set_away(this->is_away());
     call.perform();
@@ -166,13 +288,13 @@ void HighTempWaterHeater::apply_control_() {
   water_heater::WaterHeaterMode desired_child_mode;
   if (this->mode_ == water_heater::WATER_HEATER_MODE_OFF) {
     // High-temp entity is OFF — reset bang-bang state and ensure source is off.
-    this->heating_active_ = false;
+    this->stop_heating_(false);
     desired_child_mode = water_heater::WATER_HEATER_MODE_OFF;
   } else if (floats_equal(this->target_temperature_, this->source_->get_target_temperature())) {
     // Target temperatures match — the source can self-manage at its own setpoint,
     // so bypass bang-bang and simply mirror our mode directly to the child.
     ESP_LOGD(TAG, "Target temperatures match (%.2f), mirroring mode directly to child", this->target_temperature_);
-    this->heating_active_ = false;
+    this->stop_heating_(false);
     desired_child_mode = this->mode_;
   } else {
     // Bang-bang control: turn on when monitored drops below (target - dead_band),
@@ -181,19 +303,25 @@ void HighTempWaterHeater::apply_control_() {
       if (this->monitored_temp_ >= this->target_temperature_ + this->over_run_) {
         ESP_LOGD(TAG, "Heating cut: monitored=%.1f >= target=%.1f + over_run=%.1f", this->monitored_temp_,
                  this->target_temperature_, this->over_run_);
-        this->heating_active_ = false;
+        this->stop_heating_(true);
       }
     } else {
       if (this->monitored_temp_ <= this->target_temperature_ - this->dead_band_) {
         ESP_LOGD(TAG, "Heating start: monitored=%.1f <= target=%.1f - dead_band=%.1f", this->monitored_temp_,
                  this->target_temperature_, this->dead_band_);
-        this->heating_active_ = true;
+        this->start_heating_(CycleStart::DEAD_BAND);
+      } else if (this->monitored_temp_ < this->target_temperature_ && this->is_draw_active_()) {
+        // A large draw is pulling cold water into the bottom of the tank; start recovery now rather
+        // than waiting for the stratified average to fall through the dead band.
+        ESP_LOGD(TAG, "Heating start: draw detected with monitored=%.1f < target=%.1f", this->monitored_temp_,
+                 this->target_temperature_);
+        this->start_heating_(CycleStart::DRAW);
       }
     }
     desired_child_mode = this->heating_active_ ? this->mode_ : water_heater::WATER_HEATER_MODE_OFF;
   }
 
-  if (desired_child_mode != this->source_->get_mode()) {
+  if (this->should_send_(this->mode_command_, desired_child_mode, this->source_->get_mode())) {
     ESP_LOGD(TAG, "Setting child mode: %s", LOG_STR_ARG(water_heater::water_heater_mode_to_string(desired_child_mode)));
     auto call = this->source_->make_call();
     call.set_mode(desired_child_mode);
@@ -201,4 +329,90 @@ void HighTempWaterHeater::apply_control_() {
   }
 }
 
+void HighTempWaterHeater::start_heating_(CycleStart reason) {
+  if (this->heating_active_)
+    return;
+  this->heating_active_ = true;
+  this->cycle_count_++;
+  this->cycle_start_ms_ = millis_64();
+  this->cycle_start_temp_ = this->monitored_temp_;
+  this->cycle_mode_ = this->mode_;
+  this->cycle_start_reason_ = reason;
+  this->publish_cycle_stats_();
+}
+
+void HighTempWaterHeater::stop_heating_(bool completed) {
+  if (!this->heating_active_)
+    return;
+  this->heating_active_ = false;
+
+  const uint64_t elapsed_ms = millis_64() - this->cycle_start_ms_;
+  if (this->cycle_mode_ < MODE_STATS_SIZE)
+    this->mode_stats_[this->cycle_mode_].on_time_ms += elapsed_ms;
+
+  // Only cycles that ran from target - dead_band to cut-off measure recovery. Ones cut short by a mode or target
+  // change, or started early by a draw (higher up and with cold water still coming in), would skew the averages.
+  if (completed && this->cycle_start_reason_ == CycleStart::DEAD_BAND && elapsed_ms > 0) {
+    const float minutes = elapsed_ms / 60000.0f;
+    this->recovery_count_++;
+    if (std::isnan(this->recovery_time_avg_min_)) {
+      this->recovery_time_avg_min_ = minutes;
+    } else {
+      this->recovery_time_avg_min_ += (minutes - this->recovery_time_avg_min_) / this->recovery_count_;
+    }
+
+    if (this->cycle_mode_ < MODE_STATS_SIZE && !std::isnan(this->cycle_start_temp_)) {
+      auto &stats = this->mode_stats_[this->cycle_mode_];
+      const float rate = (this->monitored_temp_ - this->cycle_start_temp_) / minutes;
+      if (std::isnan(stats.heating_rate)) {
+        stats.heating_rate = rate;
+      } else {
+        stats.heating_rate = HEATING_RATE_ALPHA * rate + (1.0f - HEATING_RATE_ALPHA) * stats.heating_rate;
+      }
+      ESP_LOGD(TAG, "Cycle complete in %.1f min (%s): %.3f\xc2\xb0\x43/min, smoothed %.3f\xc2\xb0\x43/min", minutes,
+               LOG_STR_ARG(water_heater::water_heater_mode_to_string(this->cycle_mode_)), rate, stats.heating_rate);
+    }
+  }
+  this->publish_cycle_stats_();
+}
+
+void HighTempWaterHeater::publish_cycle_stats_() {
+  const uint64_t now = millis_64();
+  uint64_t on_time_ms = 0;
+  float energy = 0.0f;
+  float max_power = 0.0f;
+  for (size_t i = 0; i < MODE_STATS_SIZE; i++) {
+    const auto &stats = this->mode_stats_[i];
+    uint64_t mode_on_ms = stats.on_time_ms;
+    if (this->heating_active_ && this->cycle_mode_ == i)
+      mode_on_ms += now - this->cycle_start_ms_;
+    on_time_ms += mode_on_ms;
+    if (!std::isnan(stats.power)) {
+      energy += stats.power * (mode_on_ms / 1000.0f);
+      if (stats.power > max_power)
+        max_power = stats.power;
+    }
+    if (stats.heating_rate_sensor != nullptr && !std::isnan(stats.heating_rate))
+      stats.heating_rate_sensor->publish_state(stats.heating_rate);
+  }
+
+  if (this->cycle_count_sensor_ != nullptr)
+    this->cycle_count_sensor_->publish_state(this->cycle_count_);
+  if (this->on_time_sensor_ != nullptr)
+    this->on_time_sensor_->publish_state(on_time_ms / 1000.0f);
+  if (this->recovery_time_sensor_ != nullptr && !std::isnan(this->recovery_time_avg_min_))
+    this->recovery_time_sensor_->publish_state(this->recovery_time_avg_min_);
+
+  // Energy-weighted duty cycle: energy used relative to running the most powerful mode non-stop. Modes without a
+  // configured power can't be weighted and are left out; with no powers configured at all it is the plain duty cycle.
+  const uint64_t elapsed_ms = now - this->stats_start_ms_;
+  if (this->duty_cycle_sensor_ != nullptr && elapsed_ms > 0) {
+    if (max_power > 0.0f) {
+      this->duty_cycle_sensor_->publish_state(energy * 100.0f / (max_power * (elapsed_ms / 1000.0f)));
+    } else {
+      this->duty_cycle_sensor_->publish_state(on_time_ms * 100.0f / elapsed_ms);
+    }
+  }
+}
+
 }  // namespace esphome::high_temp_water_heater
@@ -1,22 +1,85 @@
 #pragma once
 
+#include <array>
+
 #include "esphome/core/component.h"
 #include "esphome/components/sensor/sensor.h"
 #include "esphome/components/water_heater/water_heater.h"
 
 namespace esphome::high_temp_water_heater {
 
+/// A command sent to the source water heater that has not yet been confirmed.
+/// The econet-backed source only reflects a write after a bus round-trip, so
+/// identical commands are held back until `command_timeout_` has elapsed.
+template<typename T> struct SourceCommand {
+  T value{};
+  uint32_t sent_ms{0};
+  bool pending{false};    ///< Sent and waiting for the source to report it.
+  bool confirmed{false};  ///< The source has reported `value` since it was sent.
+};
+
+/// One tank temperature sensor contributing to the fused monitored temperature.
+struct TankSensor {
+  sensor::Sensor *sensor{nullptr};
+  float offset{0.0f};    ///< Added to the reading (°C) before fusion.
+  float weight{1.0f};    ///< Relative weight of this sensor in the fused temperature.
+  float draw_rate{NAN};  ///< °C/min drop that signals a hot water draw; NAN disables draw detection.
+  bool is_fahrenheit{false};
+  float last_c{NAN};      ///< Last reading (°C) folded into the fused sum.
+  float draw_ref_c{NAN};  ///< Reading at the start of the current draw-detection window.
+  uint32_t draw_ref_ms{0};
+};
+
+static constexpr size_t MAX_TEMPERATURE_SENSORS = 4;
+
+/// Per source-mode heating statistics, indexed by water_heater::WaterHeaterMode.
+struct ModeStats {
+  float power{NAN};         ///< Nominal power (W) used to energy-weight the duty cycle, NAN if not configured.
+  float heating_rate{NAN};  ///< Smoothed °C/min rise of the monitored temperature during completed cycles.
+  uint64_t on_time_ms{0};
+  sensor::Sensor *heating_rate_sensor{nullptr};
+};
+
+static constexpr size_t MODE_STATS_SIZE = 8;
+
+/// What started a heating cycle.
+enum class CycleStart : uint8_t {
+  DEAD_BAND,  ///< The monitored temperature fell to target - dead_band.
+  DRAW,       ///< A draw was detected while the monitored temperature was still above target - dead_band.
+};
+
 class HighTempWaterHeater : public water_heater::WaterHeater, public Component {
  public:
   float get_setup_priority() const override { return setup_priority::LATE; }
   void set_source_water_heater(water_heater::WaterHeater *source) { this->source_ = source; }
-  void set_temperature_sensor(sensor::Sensor *sens) { this->temperature_sensor_ = sens; }
-  void set_temperature_sensor_offset(float offset) { this->temperature_sensor_offset_ = offset; }
+  void add_temperature_sensor(sensor::Sensor *sens, float offset, float weight) {
+    if (this->temperature_sensor_count_ < MAX_TEMPERATURE_SENSORS)
+      this->temperature_sensors_[this->temperature_sensor_count_++] = {sens, offset, weight};
+  }
+  void set_last_temperature_sensor_draw_rate(float rate) {
+    this->temperature_sensors_[this->temperature_sensor_count_ - 1].draw_rate = rate;
+  }
+  void set_draw_hold_time(uint32_t hold_ms) { this->draw_hold_ms_ = hold_ms; }
   void set_min_temperature(float min_temperature) { this->min_temperature_ = min_temperature; }
   void set_max_temperature(float max_temperature) { this->max_temperature_ = max_temperature; }
   void set_target_temperature_step(float step) { this->target_temperature_step_ = step; }
   void set_dead_band(float dead_band) { this->dead_band_ = dead_band; }
   void set_over_run(float over_run) { this->over_run_ = over_run; }
+  void set_command_timeout(uint32_t timeout_ms) { this->command_timeout_ms_ = timeout_ms; }
+  void set_command_retries_sensor(sensor::Sensor *sens) { this->command_retries_sensor_ = sens; }
+  void set_command_mismatches_sensor(sensor::Sensor *sens) { this->command_mismatches_sensor_ = sens; }
+  void set_cycle_count_sensor(sensor::Sensor *sens) { this->cycle_count_sensor_ = sens; }
+  void set_on_time_sensor(sensor::Sensor *sens) { this->on_time_sensor_ = sens; }
+  void set_recovery_time_sensor(sensor::Sensor *sens) { this->recovery_time_sensor_ = sens; }
+  void set_duty_cycle_sensor(sensor::Sensor *sens) { this->duty_cycle_sensor_ = sens; }
+  void set_heating_rate_sensor(water_heater::WaterHeaterMode mode, sensor::Sensor *sens) {
+    if (mode < MODE_STATS_SIZE)
+      this->mode_stats_[mode].heating_rate_sensor = sens;
+  }
+  void set_mode_power(water_heater::WaterHeaterMode mode, float power) {
+    if (mode < MODE_STATS_SIZE)
+      this->mode_stats_[mode].power = power;
+  }
 
   void setup() override;
   void loop() override;
@@ -32,10 +95,30 @@ class HighTempWaterHeater : public water_heater::WaterHeater, public Component {
 
   void apply_control_();
 
+  /// Folds a new reading into the fused temperature and runs draw detection for that sensor.
+  void on_temperature_sensor_(TankSensor &ts, float raw);
+  void check_draw_(TankSensor &ts, float temp_c);
+  bool is_draw_active_();
+
+  /// Returns true when `desired` should be written to the source, updating the in-flight
+  /// state of `cmd` and the retry/mismatch counters.
+  template<typename T> bool should_send_(SourceCommand<T> &cmd, T desired, T reported);
+  void publish_command_stats_();
+
+  /// Bang-bang transitions; these also collect the heating-cycle statistics.
+  void start_heating_(CycleStart reason);
+  /// `completed` is true when the cycle ended by reaching target + over_run.
+  void stop_heating_(bool completed);
+  void publish_cycle_stats_();
+
   water_heater::WaterHeater *source_{nullptr};
-  sensor::Sensor *temperature_sensor_{nullptr};
-  bool temperature_sensor_is_fahrenheit_{false};
-  float temperature_sensor_offset_{0.0f};
+  std::array<TankSensor, MAX_TEMPERATURE_SENSORS> temperature_sensors_{};
+  uint8_t temperature_sensor_count_{0};
+  float fused_weighted_sum_{0.0f};  ///< Sum of (reading + offset) * weight over sensors with a reading.
+  float fused_weight_{0.0f};        ///< Sum of weights over sensors with a reading.
+  uint32_t draw_hold_ms_{600000};
+  uint32_t draw_detected_ms_{0};
+  bool draw_detected_{false};
   float dead_band_{5.0f};
   float over_run_{0.0f};
   float min_temperature_{40.0f};
@@ -43,6 +126,28 @@ class HighTempWaterHeater : public water_heater::WaterHeater, public Component {
   float target_temperature_step_{1.0f};
   float monitored_temp_{NAN};
   bool heating_active_{false};
+
+  uint32_t command_timeout_ms_{30000};
+  SourceCommand<water_heater::WaterHeaterMode> mode_command_{};
+  SourceCommand<bool> away_command_{};
+  uint32_t command_retries_{0};     ///< Commands re-sent because the source did not confirm in time.
+  uint32_t command_mismatches_{0};  ///< Confirmed commands the source later drifted away from.
+  sensor::Sensor *command_retries_sensor_{nullptr};
+  sensor::Sensor *command_mismatches_sensor_{nullptr};
+
+  std::array<ModeStats, MODE_STATS_SIZE> mode_stats_{};
+  uint32_t cycle_count_{0};
+  uint32_t recovery_count_{0};
+  float recovery_time_avg_min_{NAN};
+  uint64_t cycle_start_ms_{0};
+  float cycle_start_temp_{NAN};
+  CycleStart cycle_start_reason_{CycleStart::DEAD_BAND};
+  water_heater::WaterHeaterMode cycle_mode_{water_heater::WATER_HEATER_MODE_OFF};
+  uint64_t stats_start_ms_{0};
+  sensor::Sensor *cycle_count_sensor_{nullptr};
+  sensor::Sensor *on_time_sensor_{nullptr};
+  sensor::Sensor *recovery_time_sensor_{nullptr};
+  sensor::Sensor *duty_cycle_sensor_{nullptr};
 };
 
 }  // namespace esphome::high_temp_water_heater
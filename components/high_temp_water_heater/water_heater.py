@@ -1,14 +1,47 @@
 import esphome.codegen as cg
 from esphome.components import sensor, water_heater
 import esphome.config_validation as cv
-from esphome.const import CONF_MAX_TEMPERATURE, CONF_MIN_TEMPERATURE
+from esphome.const import (
+    CONF_MAX_TEMPERATURE,
+    CONF_MIN_TEMPERATURE,
+    CONF_OFFSET,
+    CONF_SENSOR,
+    DEVICE_CLASS_DURATION,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
+    UNIT_MINUTE,
+    UNIT_PERCENT,
+    UNIT_SECOND,
+)
+
+AUTO_LOAD = ["loop_profile"]
 
 CONF_SOURCE_WATER_HEATER = "source_water_heater"
 CONF_TEMPERATURE_SENSOR = "temperature_sensor"
 CONF_TEMPERATURE_SENSOR_OFFSET = "temperature_sensor_offset"
+CONF_TEMPERATURE_SENSORS = "temperature_sensors"
+CONF_WEIGHT = "weight"
+CONF_DRAW_RATE = "draw_rate"
+CONF_DRAW_HOLD_TIME = "draw_hold_time"
 CONF_DEAD_BAND = "dead_band"
 CONF_OVER_RUN = "over_run"
 CONF_TARGET_TEMPERATURE_STEP = "target_temperature_step"
+CONF_COMMAND_TIMEOUT = "command_timeout"
+CONF_COMMAND_RETRIES = "command_retries"
+CONF_COMMAND_MISMATCHES = "command_mismatches"
+
+CONF_CYCLE_COUNT = "cycle_count"
+CONF_ON_TIME = "on_time"
+CONF_RECOVERY_TIME = "recovery_time"
+CONF_DUTY_CYCLE = "duty_cycle"
+CONF_HEATING_RATE = "heating_rate"
+CONF_MODE_POWER = "mode_power"
+
+ICON_COUNTER = "mdi:counter"
+ICON_TIMER = "mdi:timer-outline"
+ICON_THERMOMETER_CHEVRON_UP = "mdi:thermometer-chevron-up"
+UNIT_CELSIUS_PER_MINUTE = "\u00b0C/min"
 
 _MIN_TEMP_MIN_C = 30.0
 _MIN_TEMP_MAX_C = 50.0
@@ -21,6 +54,10 @@ _MIN_MAX_TEMP_GAP_C = 5.0
 _TEMP_OFFSET_MIN_C = 0.0
 _TEMP_OFFSET_MAX_C = 20.0
 
+_MAX_TEMPERATURE_SENSORS = 4
+_DRAW_RATE_MIN_C = 0.05
+_DRAW_RATE_MAX_C = 10.0
+
 _TEMP_STEP_MIN = 0.5
 _TEMP_STEP_MAX = 2.0
 _TEMP_STEP_DEFAULT = 1.0
@@ -29,12 +66,46 @@ _DEAD_BAND_OVER_RUN_MIN_SUM_C = 0.5
 _HEATING_DELTA_MIN_C = 0.0
 _HEATING_DELTA_MAX_C = 20.0
 
+water_heater_ns = cg.esphome_ns.namespace("water_heater")
+WaterHeaterMode = water_heater_ns.enum("WaterHeaterMode")
+# Source modes that heating statistics are tracked for.
+_STATS_MODES = {
+    "eco": WaterHeaterMode.WATER_HEATER_MODE_ECO,
+    "electric": WaterHeaterMode.WATER_HEATER_MODE_ELECTRIC,
+    "performance": WaterHeaterMode.WATER_HEATER_MODE_PERFORMANCE,
+    "high_demand": WaterHeaterMode.WATER_HEATER_MODE_HIGH_DEMAND,
+}
+
 high_temp_water_heater_ns = cg.esphome_ns.namespace("high_temp_water_heater")
 HighTempWaterHeater = high_temp_water_heater_ns.class_(
     "HighTempWaterHeater", water_heater.WaterHeater, cg.Component
 )
 
 
+HEATING_RATE_SENSOR_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_CELSIUS_PER_MINUTE,
+    icon=ICON_THERMOMETER_CHEVRON_UP,
+    accuracy_decimals=3,
+    state_class=STATE_CLASS_MEASUREMENT,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+TEMPERATURE_SENSOR_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_SENSOR): cv.use_id(sensor.Sensor),
+        cv.Required(CONF_OFFSET): cv.All(
+            cv.temperature_delta,
+            cv.float_range(min=-_TEMP_OFFSET_MAX_C, max=_TEMP_OFFSET_MAX_C),
+        ),
+        cv.Optional(CONF_WEIGHT, default=1.0): cv.positive_not_null_float,
+        cv.Optional(CONF_DRAW_RATE): cv.All(
+            cv.temperature_delta,
+            cv.float_range(min=_DRAW_RATE_MIN_C, max=_DRAW_RATE_MAX_C),
+        ),
+    }
+)
+
+
 def _validate_config(config):
     if (
         CONF_TEMPERATURE_SENSOR in config
@@ -43,6 +114,10 @@ def _validate_config(config):
         raise cv.Invalid(
             f"{CONF_TEMPERATURE_SENSOR_OFFSET} is required when {CONF_TEMPERATURE_SENSOR} is set"
         )
+    if CONF_TEMPERATURE_SENSOR in config and CONF_TEMPERATURE_SENSORS in config:
+        raise cv.Invalid(
+            f"Use either {CONF_TEMPERATURE_SENSOR} or {CONF_TEMPERATURE_SENSORS}, not both"
+        )
     min_temp = config[CONF_MIN_TEMPERATURE]
     max_temp = config[CONF_MAX_TEMPERATURE]
     if max_temp < min_temp + _MIN_MAX_TEMP_GAP_C:
@@ -68,6 +143,13 @@ CONFIG_SCHEMA = cv.All(
                 cv.temperature_delta,
                 cv.float_range(min=_TEMP_OFFSET_MIN_C, max=_TEMP_OFFSET_MAX_C),
             ),
+            cv.Optional(CONF_TEMPERATURE_SENSORS): cv.All(
+                cv.ensure_list(TEMPERATURE_SENSOR_SCHEMA),
+                cv.Length(min=1, max=_MAX_TEMPERATURE_SENSORS),
+            ),
+            cv.Optional(
+                CONF_DRAW_HOLD_TIME, default="10min"
+            ): cv.positive_time_period_milliseconds,
             cv.Optional(CONF_MIN_TEMPERATURE, default=_MIN_TEMP_DEFAULT_C): cv.All(
                 cv.temperature, cv.float_range(min=_MIN_TEMP_MIN_C, max=_MIN_TEMP_MAX_C)
             ),
@@ -87,6 +169,59 @@ CONFIG_SCHEMA = cv.All(
                 cv.temperature_delta,
                 cv.float_range(min=_HEATING_DELTA_MIN_C, max=_HEATING_DELTA_MAX_C),
             ),
+            cv.Optional(
+                CONF_COMMAND_TIMEOUT, default="30s"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_COMMAND_RETRIES): sensor.sensor_schema(
+                icon=ICON_COUNTER,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_COMMAND_MISMATCHES): sensor.sensor_schema(
+                icon=ICON_COUNTER,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_CYCLE_COUNT): sensor.sensor_schema(
+                icon=ICON_COUNTER,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_ON_TIME): sensor.sensor_schema(
+                unit_of_measurement=UNIT_SECOND,
+                icon=ICON_TIMER,
+                accuracy_decimals=0,
+                device_class=DEVICE_CLASS_DURATION,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_RECOVERY_TIME): sensor.sensor_schema(
+                unit_of_measurement=UNIT_MINUTE,
+                icon=ICON_TIMER,
+                accuracy_decimals=1,
+                device_class=DEVICE_CLASS_DURATION,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_DUTY_CYCLE): sensor.sensor_schema(
+                unit_of_measurement=UNIT_PERCENT,
+                icon="mdi:percent",
+                accuracy_decimals=1,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_HEATING_RATE): cv.Schema(
+                {
+                    cv.Optional(mode): HEATING_RATE_SENSOR_SCHEMA
+                    for mode in _STATS_MODES
+                }
+            ),
+            cv.Optional(CONF_MODE_POWER): cv.Schema(
+                {cv.Optional(mode): cv.power for mode in _STATS_MODES}
+            ),
         }
     )
     .extend(cv.COMPONENT_SCHEMA),
@@ -103,14 +238,52 @@ async def to_code(config):
 
     if lower_tank_sens := config.get(CONF_TEMPERATURE_SENSOR):
         sens = await cg.get_variable(lower_tank_sens)
-        cg.add(var.set_temperature_sensor(sens))
+        cg.add(
+            var.add_temperature_sensor(
+                sens, config[CONF_TEMPERATURE_SENSOR_OFFSET], 1.0
+            )
+        )
 
-    if CONF_TEMPERATURE_SENSOR_OFFSET in config:
+    for sens_config in config.get(CONF_TEMPERATURE_SENSORS, []):
+        sens = await cg.get_variable(sens_config[CONF_SENSOR])
         cg.add(
-            var.set_temperature_sensor_offset(config[CONF_TEMPERATURE_SENSOR_OFFSET])
+            var.add_temperature_sensor(
+                sens, sens_config[CONF_OFFSET], sens_config[CONF_WEIGHT]
+            )
         )
+        if CONF_DRAW_RATE in sens_config:
+            cg.add(
+                var.set_last_temperature_sensor_draw_rate(sens_config[CONF_DRAW_RATE])
+            )
+    cg.add(var.set_draw_hold_time(config[CONF_DRAW_HOLD_TIME]))
     cg.add(var.set_min_temperature(config[CONF_MIN_TEMPERATURE]))
     cg.add(var.set_max_temperature(config[CONF_MAX_TEMPERATURE]))
     cg.add(var.set_target_temperature_step(config[CONF_TARGET_TEMPERATURE_STEP]))
     cg.add(var.set_dead_band(config[CONF_DEAD_BAND]))
     cg.add(var.set_over_run(config[CONF_OVER_RUN]))
+    cg.add(var.set_command_timeout(config[CONF_COMMAND_TIMEOUT]))
+
+    if retries_config := config.get(CONF_COMMAND_RETRIES):
+        sens = await sensor.new_sensor(retries_config)
+        cg.add(var.set_command_retries_sensor(sens))
+
+    if mismatches_config := config.get(CONF_COMMAND_MISMATCHES):
+        sens = await sensor.new_sensor(mismatches_config)
+        cg.add(var.set_command_mismatches_sensor(sens))
+
+    for key, setter in (
+        (CONF_CYCLE_COUNT, var.set_cycle_count_sensor),
+        (CONF_ON_TIME, var.set_on_time_sensor),
+        (CONF_RECOVERY_TIME, var.set_recovery_time_sensor),
+        (CONF_DUTY_CYCLE, var.set_duty_cycle_sensor),
+    ):
+        if sens_config := config.get(key):
+            sens = await sensor.new_sensor(sens_config)
+            cg.add(setter(sens))
+
+    for mode, sens_config in config.get(CONF_HEATING_RATE, {}).items():
+        sens = await sensor.new_sensor(sens_config)
+        cg.add(var.set_heating_rate_sensor(_STATS_MODES[mode], sens))
+
+    for mode, power in config.get(CONF_MODE_POWER, {}).items():
+        cg.add(var.set_mode_power(_STATS_MODES[mode], power))
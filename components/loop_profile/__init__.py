@@ -0,0 +1,2 @@
+# Header only: provides LOOP_PROFILE() to the components that loop_profiler can time.
+CODEOWNERS = ["@nuttytree"]
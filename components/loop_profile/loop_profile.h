@@ -0,0 +1,12 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+
+// LOOP_PROFILE("name") times the rest of the enclosing scope when the loop_profiler component is configured and
+// compiles to nothing otherwise, so components can mark their hot functions without any #ifdef of their own.
+
+#ifdef USE_LOOP_PROFILER
+#include "esphome/components/loop_profiler/profile_point.h"
+#else
+#define LOOP_PROFILE(name)
+#endif
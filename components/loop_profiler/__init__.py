@@ -0,0 +1,82 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor
+from esphome.const import (
+    CONF_ID,
+    CONF_MAX,
+    CONF_NAME,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    STATE_CLASS_MEASUREMENT,
+    UNIT_MICROSECOND,
+)
+
+CODEOWNERS = ["@nuttytree"]
+AUTO_LOAD = ["loop_profile", "sensor"]
+
+loop_profiler_ns = cg.esphome_ns.namespace("loop_profiler")
+LoopProfiler = loop_profiler_ns.class_("LoopProfiler", cg.PollingComponent)
+
+CONF_POINTS = "points"
+CONF_P50 = "p50"
+CONF_P99 = "p99"
+CONF_CALLS = "calls"
+CONF_LOG = "log"
+
+ICON_TIMER = "mdi:timer-outline"
+ICON_COUNTER = "mdi:counter"
+
+TIME_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_MICROSECOND,
+    icon=ICON_TIMER,
+    accuracy_decimals=0,
+    state_class=STATE_CLASS_MEASUREMENT,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+POINT_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_NAME): cv.string_strict,
+        cv.Optional(CONF_P50): TIME_SCHEMA,
+        cv.Optional(CONF_P99): TIME_SCHEMA,
+        cv.Optional(CONF_MAX): TIME_SCHEMA,
+        cv.Optional(CONF_CALLS): sensor.sensor_schema(
+            icon=ICON_COUNTER,
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+    }
+)
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(LoopProfiler),
+        cv.Optional(CONF_LOG, default=True): cv.boolean,
+        cv.Optional(CONF_POINTS, default=[]): cv.ensure_list(POINT_SCHEMA),
+    }
+).extend(cv.polling_component_schema("60s"))
+
+
+async def _optional_sensor(config, key):
+    if sensor_config := config.get(key):
+        return await sensor.new_sensor(sensor_config)
+    return cg.nullptr
+
+
+async def to_code(config):
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+    # Turns on the LOOP_PROFILE points compiled into the other components.
+    cg.add_define("USE_LOOP_PROFILER")
+
+    cg.add(var.set_log(config[CONF_LOG]))
+    for point_config in config[CONF_POINTS]:
+        cg.add(
+            var.add_point(
+                point_config[CONF_NAME],
+                await _optional_sensor(point_config, CONF_P50),
+                await _optional_sensor(point_config, CONF_P99),
+                await _optional_sensor(point_config, CONF_MAX),
+                await _optional_sensor(point_config, CONF_CALLS),
+            )
+        )
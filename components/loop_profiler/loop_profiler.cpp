@@ -0,0 +1,61 @@
+#include "loop_profiler.h"
+
+#include "esphome/core/log.h"
+
+#include <cinttypes>
+#include <cstring>
+
+namespace esphome::loop_profiler {
+
+static const char *const TAG = "loop_profiler";
+
+void LoopProfiler::dump_config() {
+  ESP_LOGCONFIG(TAG, "Loop Profiler:");
+  LOG_UPDATE_INTERVAL(this);
+  for (const auto &point : this->points_) {
+    ESP_LOGCONFIG(TAG, "  Point '%s'", point.name);
+    LOG_SENSOR("    ", "p50", point.p50);
+    LOG_SENSOR("    ", "p99", point.p99);
+    LOG_SENSOR("    ", "Max", point.max);
+    LOG_SENSOR("    ", "Calls", point.calls);
+  }
+}
+
+void LoopProfiler::update() {
+  for (ProfilePoint *point = ProfilePoint::first_point; point != nullptr; point = point->get_next()) {
+    const uint32_t calls = point->get_calls();
+    const uint32_t p50 = point->percentile_us(0.50f);
+    const uint32_t p99 = point->percentile_us(0.99f);
+    const uint32_t max = point->get_max_us();
+    point->reset();
+
+    if (this->log_) {
+      ESP_LOGD(TAG, "%-24s %7" PRIu32 " calls  p50 %6" PRIu32 " us  p99 %6" PRIu32 " us  max %7" PRIu32 " us",
+               point->get_name(), calls, p50, p99, max);
+    }
+    const PointSensors *sensors = this->find_sensors_(point->get_name());
+    if (sensors == nullptr)
+      continue;
+    // An idle window has no timings to report, only the call count.
+    if (sensors->calls != nullptr)
+      sensors->calls->publish_state(calls);
+    if (calls == 0)
+      continue;
+    if (sensors->p50 != nullptr)
+      sensors->p50->publish_state(p50);
+    if (sensors->p99 != nullptr)
+      sensors->p99->publish_state(p99);
+    if (sensors->max != nullptr)
+      sensors->max->publish_state(max);
+  }
+}
+
+const PointSensors *LoopProfiler::find_sensors_(const char *name) const {
+  for (const auto &point : this->points_) {
+    if (strcmp(point.name, name) == 0)
+      return &point;
+  }
+  return nullptr;
+}
+
+}  // namespace esphome::loop_profiler
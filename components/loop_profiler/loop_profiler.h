@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+#include "esphome/core/component.h"
+#include "esphome/components/sensor/sensor.h"
+
+#include "profile_point.h"
+
+namespace esphome::loop_profiler {
+
+/// Sensors reporting one named ProfilePoint.
+struct PointSensors {
+  const char *name{nullptr};
+  sensor::Sensor *p50{nullptr};
+  sensor::Sensor *p99{nullptr};
+  sensor::Sensor *max{nullptr};
+  sensor::Sensor *calls{nullptr};
+};
+
+/// Logs and publishes the timing of every profiled function once per update interval, then starts a fresh window.
+class LoopProfiler : public PollingComponent {
+ public:
+  void add_point(const char *name, sensor::Sensor *p50, sensor::Sensor *p99, sensor::Sensor *max,
+                 sensor::Sensor *calls) {
+    this->points_.push_back({name, p50, p99, max, calls});
+  }
+  void set_log(bool log) { this->log_ = log; }
+
+  void dump_config() override;
+  void update() override;
+
+ protected:
+  const PointSensors *find_sensors_(const char *name) const;
+
+  std::vector<PointSensors> points_;
+  bool log_{true};
+};
+
+}  // namespace esphome::loop_profiler
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include "esphome/core/hal.h"
+
+// Instrumentation for the loop profiler. Components include it through loop_profile/loop_profile.h and mark a
+// function with
+//
+//   LOOP_PROFILE("pool_controller");
+//
+// which times the rest of the enclosing scope. Each named point is a function-local static that is constant
+// initialised, so timing a call costs two micros() reads and a histogram increment, and nothing is allocated.
+
+namespace esphome::loop_profiler {
+
+/// Histogram buckets per point: two per octave of microseconds, the last one also counts everything longer (~0.8 s).
+static constexpr uint8_t PROFILE_BUCKETS = 40;
+
+class ProfilePoint {
+ public:
+  explicit constexpr ProfilePoint(const char *name) : name_(name) {}
+
+  void record(uint32_t elapsed_us) {
+    if (!this->registered_) {
+      this->next_ = first_point;
+      first_point = this;
+      this->registered_ = true;
+    }
+    this->buckets_[bucket_for(elapsed_us)]++;
+    this->calls_++;
+    if (elapsed_us > this->max_us_)
+      this->max_us_ = elapsed_us;
+  }
+
+  const char *get_name() const { return this->name_; }
+  ProfilePoint *get_next() const { return this->next_; }
+  uint32_t get_calls() const { return this->calls_; }
+  uint32_t get_max_us() const { return this->max_us_; }
+  /// Upper bound of the bucket holding the given fraction of the calls, never more than the slowest call.
+  uint32_t percentile_us(float fraction) const {
+    if (this->calls_ == 0)
+      return 0;
+    const uint32_t target = static_cast<uint32_t>(fraction * (this->calls_ - 1)) + 1;
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < PROFILE_BUCKETS; i++) {
+      seen += this->buckets_[i];
+      if (seen >= target)
+        return i == PROFILE_BUCKETS - 1 ? this->max_us_ : std::min(bucket_limit(i), this->max_us_);
+    }
+    return this->max_us_;
+  }
+  void reset() {
+    this->buckets_.fill(0);
+    this->calls_ = 0;
+    this->max_us_ = 0;
+  }
+
+  /// Every point that has been hit at least once, most recently registered first.
+  static inline ProfilePoint *first_point{nullptr};
+
+ protected:
+  static uint8_t bucket_for(uint32_t us) {
+    if (us < 2)
+      return us;
+    const uint8_t octave = 31 - __builtin_clz(us);
+    const uint8_t bucket = 2 * octave + ((us >> (octave - 1)) & 1);
+    return bucket < PROFILE_BUCKETS ? bucket : PROFILE_BUCKETS - 1;
+  }
+  /// Smallest duration (µs) above bucket `i`.
+  static uint32_t bucket_limit(uint8_t i) {
+    if (i < 2)
+      return i + 1;
+    const uint8_t octave = i / 2;
+    return (1u << octave) + (i % 2 + 1) * (1u << (octave - 1));
+  }
+
+  const char *name_;
+  ProfilePoint *next_{nullptr};
+  bool registered_{false};
+  uint32_t calls_{0};
+  uint32_t max_us_{0};
+  std::array<uint32_t, PROFILE_BUCKETS> buckets_{};
+};
+
+/// Records the time from construction to destruction in a ProfilePoint.
+class ScopedProfile {
+ public:
+  explicit ScopedProfile(ProfilePoint &point) : point_(point), start_(micros()) {}
+  ~ScopedProfile() { this->point_.record(micros() - this->start_); }
+
+ protected:
+  ProfilePoint &point_;
+  uint32_t start_;
+};
+
+}  // namespace esphome::loop_profiler
+
+#define LOOP_PROFILE(name) \
+  static ::esphome::loop_profiler::ProfilePoint loop_profile_point_{name}; \
+  ::esphome::loop_profiler::ScopedProfile loop_profile_scope_ { loop_profile_point_ }
@@ -16,6 +16,7 @@ from esphome.const import (
     CONF_MINUTE,
     CONF_SECOND,
 )
+from esphome.core import ID, HexInt
 from .const import (
     CONF_PRIMARY_PUMP,
     CONF_AUXILIARY_PUMPS,
@@ -38,7 +39,7 @@ from .const import (
     CONF_FLOW_TIMEOUT,
 )
 
-AUTO_LOAD = ["binary_sensor", "select", "switch", "water_heater"]
+AUTO_LOAD = ["binary_sensor", "loop_profile", "select", "switch", "water_heater"]
 DEPENDENCIES = ["time"]
 
 pool_controller_ns = cg.esphome_ns.namespace("pool_controller")
@@ -55,6 +56,8 @@ PrimaryPumpSwitch = pool_controller_ns.class_(
 AuxiliaryPumpSwitch = pool_controller_ns.class_(
     "AuxiliaryPumpSwitch", esphome_switch.Switch, cg.Component
 )
+Schedule = pool_controller_ns.struct("Schedule")
+ScheduleRuntime = pool_controller_ns.struct("ScheduleRuntime")
 PumpAnomalyTrigger = pool_controller_ns.class_(
     "PumpAnomalyTrigger", automation.Trigger.template(cg.std_string)
 )
@@ -285,6 +288,50 @@ CONFIG_SCHEMA = cv.Schema(
 # ── Codegen helpers ────────────────────────────────────────────────────────────
 
 
+def _pack_runtime(runtime):
+    """Pack a runtime into the 32-bit word decoded by ScheduleRuntime."""
+    return (
+        _time_to_minutes(runtime[CONF_END_TIME]) // 30 << 24
+        | _time_to_minutes(runtime[CONF_START_TIME]) // 30 << 16
+        | runtime[CONF_MINUTES_PER_HOUR] << 8
+        | _days_to_mask(runtime)
+    )
+
+
+def _schedules_to_code(var, pump_config):
+    """Emit a pump's schedules as constant tables in flash and point the pump at them.
+
+    Names go into one NUL separated string pool, each schedule is a word holding
+    its name offset and first runtime, followed by a sentinel word, and each
+    runtime is one packed word.
+    """
+    schedules = pump_config[CONF_SCHEDULES]
+    if not schedules:
+        return
+
+    names = ""
+    pool_size = 0
+    headers = []
+    runtimes = []
+    for schedule in schedules:
+        headers.append(pool_size << 16 | len(runtimes))
+        names += schedule[CONF_NAME] + "\0"
+        pool_size += len(schedule[CONF_NAME].encode("utf-8")) + 1
+        runtimes.extend(_pack_runtime(r) for r in schedule[CONF_RUNTIMES])
+    headers.append(pool_size << 16 | len(runtimes))
+
+    base = pump_config[CONF_ID].id
+    schedule_table = cg.progmem_array(
+        ID(f"{base}_schedules", is_declaration=True, type=Schedule),
+        [HexInt(h) for h in headers],
+    )
+    runtime_table = cg.progmem_array(
+        ID(f"{base}_schedule_runtimes", is_declaration=True, type=ScheduleRuntime),
+        [HexInt(r) for r in runtimes],
+    )
+    cg.add(var.set_schedules(names, schedule_table, runtime_table, len(schedules)))
+
+
 async def _pump_to_code(var, pump_config, delay_ms, disable_sensor):
     """Register a pump switch and emit all its configuration calls."""
     await esphome_switch.register_switch(var, pump_config)
@@ -297,17 +344,7 @@ async def _pump_to_code(var, pump_config, delay_ms, disable_sensor):
     if disable_sensor is not None:
         cg.add(var.set_disable_pumps_sensor(disable_sensor))
 
-    for schedule in pump_config[CONF_SCHEDULES]:
-        cg.add(var.add_schedule(schedule[CONF_NAME]))
-        for runtime in schedule[CONF_RUNTIMES]:
-            cg.add(
-                var.add_runtime_to_last_schedule(
-                    _time_to_minutes(runtime[CONF_START_TIME]),
-                    _time_to_minutes(runtime[CONF_END_TIME]),
-                    runtime[CONF_MINUTES_PER_HOUR],
-                    _days_to_mask(runtime),
-                )
-            )
+    _schedules_to_code(var, pump_config)
 
     if CONF_CURRENT_SENSOR in pump_config:
         current_sens = await cg.get_variable(pump_config[CONF_CURRENT_SENSOR])
@@ -340,6 +377,7 @@ async def _schedule_select_to_code(pump_var, pump_config, builtin_last_option):
     await esphome_select.register_select(sel, sel_conf, options=options)
     await cg.register_component(sel, sel_conf)
     cg.add(sel.set_pump_switch(pump_var))
+    cg.add(sel.set_builtin_last_option(builtin_last_option))
 
 
 # ── Top-level to_code ──────────────────────────────────────────────────────────
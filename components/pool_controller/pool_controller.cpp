@@ -4,6 +4,7 @@
 #include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
 #include "esphome/core/util.h"
+#include "esphome/components/loop_profile/loop_profile.h"
 
 #include <cinttypes>
 
@@ -22,6 +23,36 @@ void PoolController::setup() {
       }
     });
   }
+  this->register_service(&PoolController::set_pump_schedules, "set_pump_schedules", {"pump", "schedules"});
+}
+
+void PoolController::set_pump_schedules(std::string pump, std::string schedules) {
+  PumpSwitch *target = nullptr;
+  if (this->primary_pump_ != nullptr && this->primary_pump_->get_name() == pump)
+    target = this->primary_pump_;
+  for (auto *aux : this->auxiliary_pumps_) {
+    if (aux->get_name() == pump)
+      target = aux;
+  }
+  if (target == nullptr) {
+    ESP_LOGW(TAG, "set_pump_schedules: no pump named '%s'", pump.c_str());
+    return;
+  }
+
+  if (schedules.empty()) {
+    ESP_LOGI(TAG, "'%s' going back to the configured schedules", pump.c_str());
+    target->stage_schedules(nullptr);
+    return;
+  }
+  // Parse and validate here, outside the schedule tick; the tick only swaps the result in.
+  auto buffer = std::make_unique<ScheduleBuffer>();
+  const std::string error = ScheduleParser::parse(schedules, *buffer);
+  if (!error.empty()) {
+    ESP_LOGW(TAG, "set_pump_schedules: rejected schedules for '%s': %s", pump.c_str(), error.c_str());
+    return;
+  }
+  ESP_LOGI(TAG, "'%s' staged %u schedules", pump.c_str(), buffer->count);
+  target->stage_schedules(std::move(buffer));
 }
 
 void PoolController::reset_all_pump_runtimes_() {
@@ -34,6 +65,12 @@ void PoolController::reset_all_pump_runtimes_() {
 }
 
 void PoolController::tick_all_pump_schedules_(const ESPTime &now) {
+  // Schedules staged by set_pump_schedules take effect here, between ticks, never halfway through one.
+  if (this->primary_pump_ != nullptr)
+    this->primary_pump_->apply_staged_schedules();
+  for (auto *aux : this->auxiliary_pumps_)
+    aux->apply_staged_schedules();
+
   // If a delayed primary turn-off is in progress, only service the timer.
   if (this->primary_turn_off_pending_) {
     if (millis_64() >= this->primary_turn_off_at_ms_) {
@@ -97,8 +134,8 @@ void PoolController::tick_pump_schedule_(PumpSwitch *pump, const ESPTime &now) {
     // Target on-time for this 30-minute window:
     //   minutes_per_hour / 2 converted to seconds  =  minutes_per_hour * 30
     const ScheduleRuntime *rt = pump->find_active_runtime(slot_start, now.day_of_week);
-    if (rt != nullptr && rt->minutes_per_hour > 0)
-      target_seconds = static_cast<uint32_t>(rt->minutes_per_hour) * 30;
+    if (rt != nullptr && rt->minutes_per_hour() > 0)
+      target_seconds = static_cast<uint32_t>(rt->minutes_per_hour()) * 30;
   }
 
   const uint32_t current_runtime = pump->get_runtime_seconds();
@@ -168,9 +205,9 @@ bool PoolController::any_auxiliary_needs_primary_(uint16_t slot_start, uint8_t d
     if (aux->is_disabled())
       continue;
     const ScheduleRuntime *rt = aux->find_active_runtime(slot_start, day_of_week);
-    if (rt == nullptr || rt->minutes_per_hour == 0)
+    if (rt == nullptr || rt->minutes_per_hour() == 0)
       continue;
-    const uint32_t target = static_cast<uint32_t>(rt->minutes_per_hour) * 30;
+    const uint32_t target = static_cast<uint32_t>(rt->minutes_per_hour()) * 30;
     // A full-window auxiliary (60 min/hr) always needs the primary for the entire slot.
     if (target == 60u * 30u)
       return true;
@@ -181,6 +218,7 @@ bool PoolController::any_auxiliary_needs_primary_(uint16_t slot_start, uint8_t d
 }
 
 void PoolController::loop() {
+  LOOP_PROFILE("pool_controller");
   if (this->rtc_ == nullptr)
     return;
 
@@ -8,6 +8,7 @@
 #include "esphome/core/helpers.h"
 #include "esphome/core/optional.h"
 #include "esphome/core/time.h"
+#include "esphome/components/api/custom_api_device.h"
 #include "esphome/components/binary_sensor/binary_sensor.h"
 #include "esphome/components/time/real_time_clock.h"
 
@@ -16,7 +17,7 @@ namespace pool_controller {
 
 class PoolHeater;  // forward declaration — full type in pool_heater.h
 
-class PoolController : public Component {
+class PoolController : public Component, public api::CustomAPIDevice {
  public:
   float get_setup_priority() const override { return setup_priority::LATE; }
   void setup() override;
@@ -31,6 +32,10 @@ class PoolController : public Component {
   void set_disable_pumps_sensor(binary_sensor::BinarySensor *sensor) { this->disable_pumps_sensor_ = sensor; }
   void set_pool_heater(PoolHeater *heater) { this->pool_heater_ = heater; }
 
+  /// Handler of the set_pump_schedules service: validates `schedules` (see ScheduleParser) for the pump named
+  /// `pump` and stages them for the next schedule tick. An empty `schedules` goes back to the configured schedules.
+  void set_pump_schedules(std::string pump, std::string schedules);
+
  protected:
   PrimaryPumpSwitch *primary_pump_{nullptr};
   time::RealTimeClock *rtc_{nullptr};
@@ -3,6 +3,7 @@
 
 #include "esphome/core/hal.h"
 #include "esphome/core/log.h"
+#include "esphome/components/loop_profile/loop_profile.h"
 
 #include <cinttypes>
 #include <cmath>
@@ -36,6 +37,8 @@ void PoolHeater::setup() {
   // Invalidate reading whenever the primary pump starts so we wait 15 s before trusting the sensor.
   if (this->primary_pump_ != nullptr) {
     this->primary_pump_->add_on_state_callback([this](bool state) {
+      // Stopping or starting, the pump is no longer running down from a sequenced shutdown.
+      this->shutdown_pending_ = false;
       if (state) {
         this->has_reading_since_pump_on_ = false;
         ESP_LOGD(TAG, "Primary pump ON — deferring temperature reads for 15 s");
@@ -63,6 +66,7 @@ void PoolHeater::setup() {
 }
 
 void PoolHeater::loop() {
+  LOOP_PROFILE("pool_heater");
   this->update_temperature_();
   this->apply_control_();
 }
@@ -102,6 +106,8 @@ void PoolHeater::control(const water_heater::WaterHeaterCall &call) {
 // ── Integration helpers ────────────────────────────────────────────────────────
 
 void PoolHeater::request_heater_off() {
+  // The pump keeps running for the sequence delay; don't let the next loop fire the heater again meanwhile.
+  this->shutdown_pending_ = true;
   if (this->heater_active_) {
     ESP_LOGD(TAG, "Sequenced shutdown: forcing heater output OFF");
     this->heater_output_->set_state(false);
@@ -110,6 +116,12 @@ void PoolHeater::request_heater_off() {
   }
 }
 
+void PoolHeater::cancel_heater_off() {
+  if (this->shutdown_pending_)
+    ESP_LOGD(TAG, "Sequenced shutdown cancelled: heater may run again");
+  this->shutdown_pending_ = false;
+}
+
 // ── Internal helpers ───────────────────────────────────────────────────────────
 
 void PoolHeater::update_temperature_() {
@@ -157,9 +169,10 @@ void PoolHeater::apply_control_() {
   }
 
   // ── GAS mode ─────────────────────────────────────────────────────────────────
-  // Prerequisites: primary pump running and we have at least one stable reading.
+  // Prerequisites: primary pump running and not shutting down, and at least one stable reading.
   const bool pump_on = (this->primary_pump_ != nullptr && this->primary_pump_->state);
-  if (!pump_on || !this->has_reading_since_pump_on_ || std::isnan(this->current_temperature_)) {
+  if (!pump_on || this->shutdown_pending_ || !this->has_reading_since_pump_on_ ||
+      std::isnan(this->current_temperature_)) {
     if (this->heater_active_) {
       ESP_LOGD(TAG, "Pump not ready or no temperature reading — deactivating heater output");
       this->heater_output_->set_state(false);
@@ -33,8 +33,11 @@ class PoolHeater : public water_heater::WaterHeater, public Component {
   water_heater::WaterHeaterCallInternal make_call() override { return water_heater::WaterHeaterCallInternal(this); }
 
   // ── Integration helpers ────────────────────────────────────────────────────
-  /// Force heater off immediately — called during the primary pump sequenced shutdown.
+  /// Force heater off immediately and keep it off until the primary pump stops or next starts — called during the
+  /// primary pump sequenced shutdown.
   void request_heater_off();
+  /// Let the heater run again — called when the primary pump is turned back on before a sequenced shutdown stops it.
+  void cancel_heater_off();
 
   /// Returns true when the heater output is currently energised.
   bool is_heater_active() const { return this->heater_active_; }
@@ -68,6 +71,7 @@ class PoolHeater : public water_heater::WaterHeater, public Component {
   bool sensor_is_fahrenheit_{false};       ///< True when the sensor reports in °F.
   bool has_reading_since_pump_on_{false};  ///< Cleared each time the primary pump starts.
   bool heater_active_{false};              ///< True when heater_output_ is energised.
+  bool shutdown_pending_{false};           ///< A sequenced shutdown is stopping the pump; the heater is held off.
   /// current_temperature_ (inherited from WaterHeater) holds the last accepted
   /// °C reading. It starts as NAN and is only written by update_temperature_(),
   /// so it doubles as the "have I ever received a valid reading?" guard.
@@ -23,6 +23,13 @@ void PrimaryPumpSwitch::write_state(bool state) {
     return;
   }
 
+  // Turned back on while a sequenced shutdown is still running the pump down: keep it running instead.
+  if (state && this->cancel_timeout("primary_seq_off")) {
+    ESP_LOGD(TAG, "'%s' turned back on — sequenced shutdown cancelled", this->get_name().c_str());
+    if (this->pool_heater_ != nullptr)
+      this->pool_heater_->cancel_heater_off();
+  }
+
   if (!state) {
     // Turn auxiliary pumps and pool heater off immediately, then bring the
     // primary pump down after the sequence delay so everything settles first.
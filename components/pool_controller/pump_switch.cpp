@@ -2,6 +2,7 @@
 
 #include "esphome/core/hal.h"
 #include "esphome/core/log.h"
+#include "esphome/components/loop_profile/loop_profile.h"
 
 #include <cmath>
 #include <cinttypes>
@@ -10,10 +11,20 @@ namespace esphome {
 namespace pool_controller {
 
 static const char *const TAG = "pool_controller.switch";
-
-void PumpSwitch::dump_config() { LOG_SWITCH("", "Pool Controller Pump", this); }
+// Keeps the saved schedules apart from the runtime and anomaly preferences of the same switch.
+static constexpr uint32_t SCHEDULES_PREF_VERSION = 0x53434844;  // "SCHD"
+
+void PumpSwitch::dump_config() {
+  LOG_SWITCH("", "Pool Controller Pump", this);
+  for (size_t i = 0; i < this->schedule_count_; i++) {
+    ESP_LOGCONFIG(TAG, "  Schedule '%s': %u runtimes", this->get_schedule_name(i),
+                  this->schedules_[i + 1].first_runtime() - this->schedules_[i].first_runtime());
+  }
+}
 
 void PumpSwitch::setup() {
+  this->restore_schedules_();
+
   this->runtime_pref_ = this->make_entity_preference<uint32_t>();
   if (this->runtime_pref_.load(&this->runtime_seconds_)) {
     ESP_LOGD(TAG, "Restored runtime %" PRIu32 "s from flash", this->runtime_seconds_);
@@ -63,25 +74,79 @@ void PumpSwitch::track_runtime(bool new_state) {
   }
 }
 
+void PumpSwitch::restore_schedules_() {
+  this->schedules_pref_ = this->make_entity_preference<ScheduleBuffer>(SCHEDULES_PREF_VERSION);
+  auto loaded = std::make_unique<ScheduleBuffer>();
+  if (!this->schedules_pref_.load(loaded.get()) || loaded->count == 0 || loaded->count > MAX_LOADED_SCHEDULES)
+    return;
+  ESP_LOGD(TAG, "'%s' restored %u schedules loaded at runtime", this->get_name().c_str(), loaded->count);
+  this->loaded_schedules_ = std::move(loaded);
+  this->use_schedules_({this->loaded_schedules_->names, this->loaded_schedules_->schedules,
+                        this->loaded_schedules_->runtimes, this->loaded_schedules_->count});
+}
+
+void PumpSwitch::apply_staged_schedules() {
+  if (!this->schedules_staged_)
+    return;
+  this->schedules_staged_ = false;
+
+  // Remember the selection by name, the index of a user schedule may change and the old names are about to go.
+  const bool was_builtin_last = this->is_builtin_last_schedule();
+  std::string active_name;
+  if (this->active_schedule_idx_ >= 1 && this->active_schedule_idx_ <= this->schedule_count_)
+    active_name = this->get_schedule_name(this->active_schedule_idx_ - 1);
+
+  this->loaded_schedules_ = std::move(this->staged_schedules_);
+  if (this->loaded_schedules_ != nullptr) {
+    this->use_schedules_({this->loaded_schedules_->names, this->loaded_schedules_->schedules,
+                          this->loaded_schedules_->runtimes, this->loaded_schedules_->count});
+    this->schedules_pref_.save(this->loaded_schedules_.get());
+  } else {
+    this->use_schedules_(this->compiled_schedules_);
+    // A count of 0 marks the configured schedules as the ones to use after a reboot.
+    ScheduleBuffer none{};
+    this->schedules_pref_.save(&none);
+  }
+
+  size_t index = 0;
+  if (was_builtin_last) {
+    index = this->schedule_count_ + 1;
+  } else if (!active_name.empty()) {
+    for (size_t i = 0; i < this->schedule_count_; i++) {
+      if (active_name == this->get_schedule_name(i)) {
+        index = i + 1;
+        break;
+      }
+    }
+  }
+  ESP_LOGI(TAG, "'%s' now has %zu %s schedules, active schedule index %zu", this->get_name().c_str(),
+           this->schedule_count_, this->loaded_schedules_ != nullptr ? "loaded" : "configured", index);
+  this->active_schedule_idx_ = index;
+  this->schedules_changed_callback_.call();
+}
+
 const ScheduleRuntime *PumpSwitch::find_active_runtime(uint16_t slot_start_minute, uint8_t day_of_week) const {
   // active_schedule_idx_ 0 = Off, 1..N = user schedules (1-based), N+1 = builtin last.
-  if (this->active_schedule_idx_ == 0 || this->active_schedule_idx_ > this->schedules_.size())
+  if (this->active_schedule_idx_ == 0 || this->active_schedule_idx_ > this->schedule_count_)
     return nullptr;
 
-  const Schedule &schedule = this->schedules_[this->active_schedule_idx_ - 1];
+  const size_t schedule = this->active_schedule_idx_ - 1;
   // day_of_week: 1=Sun..7=Sat; bitmask: bit0=Sun..bit6=Sat
   uint8_t day_mask = static_cast<uint8_t>(1u << (day_of_week - 1));
 
-  for (const auto &rt : schedule.runtimes) {
-    if (slot_start_minute >= rt.start_minute && slot_start_minute < rt.end_minute) {
-      if (rt.days_of_week & day_mask)
-        return &rt;
+  const uint16_t end = this->schedules_[schedule + 1].first_runtime();
+  for (uint16_t i = this->schedules_[schedule].first_runtime(); i < end; i++) {
+    const ScheduleRuntime *rt = &this->schedule_runtimes_[i];
+    if (slot_start_minute >= rt->start_minute() && slot_start_minute < rt->end_minute()) {
+      if (rt->days_of_week() & day_mask)
+        return rt;
     }
   }
   return nullptr;
 }
 
 void PumpSwitch::loop() {
+  LOOP_PROFILE("pump_switch");
   const uint64_t now = millis_64();
 
 #ifdef USE_SENSOR
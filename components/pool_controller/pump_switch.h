@@ -2,32 +2,22 @@
 
 #include "esphome/core/automation.h"
 #include "esphome/core/component.h"
+#include "esphome/core/defines.h"
+#include "esphome/core/helpers.h"
 #include "esphome/core/preferences.h"
-#include "esphome/core/string_ref.h"
 #include "esphome/components/binary_sensor/binary_sensor.h"
 #include "esphome/components/output/binary_output.h"
 #include "esphome/components/switch/switch.h"
 #ifdef USE_SENSOR
 #include "esphome/components/sensor/sensor.h"
 #endif
+#include "schedule_table.h"
+
+#include <memory>
 
 namespace esphome {
 namespace pool_controller {
 
-/// A single time window within a schedule.
-struct ScheduleRuntime {
-  uint16_t start_minute;     ///< Minutes since midnight (0-1410)
-  uint16_t end_minute;       ///< Minutes since midnight (30-1440, 1440 = 24:00)
-  uint8_t minutes_per_hour;  ///< Minutes to run per hour within this window
-  uint8_t days_of_week;      ///< Bitmask: bit0=Sun, bit1=Mon, ..., bit6=Sat; 0x7F = every day
-};
-
-/// A named collection of runtime windows.
-struct Schedule {
-  StringRef name;
-  std::vector<ScheduleRuntime> runtimes;
-};
-
 /// Persisted baseline data for current-draw anomaly detection.
 struct AnomalyBaseline {
   float steady_state{0.0f};  ///< EMA baseline of steady-state run current (amps).
@@ -44,16 +34,37 @@ class PoolHeater;
 /// Base class for all pump switch types. Holds shared output and schedule state.
 class PumpSwitch : public switch_::Switch, public Component {
  public:
+  /// Also restores the schedules loaded at runtime, so ScheduleSelect sets up after the pumps.
   void setup() override;
   void loop() override;
   void dump_config() override;
 
   void set_output(output::BinaryOutput *output) { output_ = output; }
 
-  void add_schedule(const char *name) { schedules_.push_back({StringRef(name), {}}); }
-  void add_runtime_to_last_schedule(uint16_t start_minute, uint16_t end_minute, uint8_t minutes_per_hour,
-                                    uint8_t days_of_week) {
-    schedules_.back().runtimes.push_back({start_minute, end_minute, minutes_per_hour, days_of_week});
+  /// Points the pump at its generated schedule tables, nothing is copied. `names` is the NUL separated name pool,
+  /// `schedules` holds `count` + 1 entries.
+  void set_schedules(const char *names, const Schedule *schedules, const ScheduleRuntime *runtimes, size_t count) {
+    this->compiled_schedules_ = {names, schedules, runtimes, count};
+    this->use_schedules_(this->compiled_schedules_);
+  }
+  /// Queues schedules loaded at runtime, or nullptr to go back to the configured ones. Nothing changes until
+  /// PoolController calls apply_staged_schedules() between schedule ticks.
+  void stage_schedules(std::unique_ptr<ScheduleBuffer> schedules) {
+    this->staged_schedules_ = std::move(schedules);
+    this->schedules_staged_ = true;
+  }
+  /// Swaps in the staged schedules, if any, and saves them. The selection follows its schedule by name and falls
+  /// back to Off when that schedule is gone.
+  void apply_staged_schedules();
+  /// Registers a callback run after apply_staged_schedules() has swapped the schedules.
+  void add_on_schedules_changed_callback(std::function<void()> &&callback) {
+    this->schedules_changed_callback_.add(std::move(callback));
+  }
+  /// Number of user-defined schedules.
+  size_t get_schedule_count() const { return this->schedule_count_; }
+  /// Name of user-defined schedule `index` (0-based, not a select index).
+  const char *get_schedule_name(size_t index) const {
+    return this->schedule_names_ + this->schedules_[index].name_offset();
   }
 
   /// Returns total pump runtime in seconds since the last half-hour reset.
@@ -67,7 +78,7 @@ class PumpSwitch : public switch_::Switch, public Component {
   /// Returns the index of the currently active schedule.
   /// Index convention:
   ///   0       = Off (built-in, always first)
-  ///   1..N    = user-defined schedules (schedules_ vector, 1-based)
+  ///   1..N    = user-defined schedules (schedules_ table, 1-based)
   ///   N+1     = built-in last schedule ("Always" for primary, "When X is Running" for auxiliary)
   size_t get_active_schedule_index() const { return this->active_schedule_idx_; }
 
@@ -109,7 +120,7 @@ class PumpSwitch : public switch_::Switch, public Component {
 
   /// Returns true when the built-in last schedule is active
   /// ("Always" for PrimaryPumpSwitch, "When X is Running" for AuxiliaryPumpSwitch).
-  bool is_builtin_last_schedule() const { return this->active_schedule_idx_ == this->schedules_.size() + 1; }
+  bool is_builtin_last_schedule() const { return this->active_schedule_idx_ == this->schedule_count_ + 1; }
 
   /// Returns true when the pump has been off for at least 5 minutes (minimum off-time before restart).
   bool can_turn_on() const { return (millis_64() - this->last_off_ms_) >= (5u * 60u * 1000u); }
@@ -136,7 +147,32 @@ class PumpSwitch : public switch_::Switch, public Component {
   const ScheduleRuntime *find_active_runtime(uint16_t slot_start_minute, uint8_t day_of_week) const;
 
   output::BinaryOutput *output_ = nullptr;
-  std::vector<Schedule> schedules_;
+  /// The tables in use: the generated ones or those in loaded_schedules_.
+  struct ScheduleTables {
+    const char *names;
+    const Schedule *schedules;
+    const ScheduleRuntime *runtimes;
+    size_t count;
+  };
+  void use_schedules_(const ScheduleTables &tables) {
+    this->schedule_names_ = tables.names;
+    this->schedules_ = tables.schedules;
+    this->schedule_runtimes_ = tables.runtimes;
+    this->schedule_count_ = tables.count;
+  }
+  /// Loads the schedules saved by the last apply_staged_schedules(), if any.
+  void restore_schedules_();
+
+  const char *schedule_names_{nullptr};                ///< Name pool of the active schedule table.
+  const Schedule *schedules_{nullptr};                 ///< Active schedule table, schedule_count_ + 1 entries.
+  const ScheduleRuntime *schedule_runtimes_{nullptr};  ///< Active runtime table shared by all schedules.
+  size_t schedule_count_{0};
+  ScheduleTables compiled_schedules_{nullptr, nullptr, nullptr, 0};  ///< Generated tables from the configuration.
+  std::unique_ptr<ScheduleBuffer> loaded_schedules_;  ///< Schedules loaded at runtime, when in use.
+  std::unique_ptr<ScheduleBuffer> staged_schedules_;  ///< Schedules waiting for the next schedule tick.
+  bool schedules_staged_{false};                      ///< staged_schedules_ is pending, nullptr meaning revert.
+  ESPPreferenceObject schedules_pref_;                ///< Persists loaded_schedules_ across reboots.
+  CallbackManager<void()> schedules_changed_callback_;
 
   size_t active_schedule_idx_{0};  ///< Index into schedules_ for the currently active schedule.
   uint32_t runtime_seconds_ = 0;   ///< Accumulated runtime (seconds) since last half-hour reset.
@@ -10,6 +10,16 @@ static const char *const TAG = "pool_controller.select";
 void ScheduleSelect::setup() {
   this->pref_ = this->make_entity_preference<size_t>();
 
+  if (this->pump_ != nullptr) {
+    this->update_options_();
+    this->pump_->add_on_schedules_changed_callback([this]() {
+      this->update_options_();
+      size_t index = this->pump_->get_active_schedule_index();
+      this->pref_.save(&index);
+      this->publish_state(index);
+    });
+  }
+
   size_t index = 0;
   if (this->pref_.load(&index) && this->has_index(index)) {
     ESP_LOGD(TAG, "Restored schedule index %zu from flash", index);
@@ -25,6 +35,16 @@ void ScheduleSelect::setup() {
 
 void ScheduleSelect::dump_config() { LOG_SELECT("", "Pool Controller Schedule Select", this); }
 
+void ScheduleSelect::update_options_() {
+  FixedVector<const char *> options;
+  options.init(this->pump_->get_schedule_count() + 2);
+  options.push_back("Off");
+  for (size_t i = 0; i < this->pump_->get_schedule_count(); i++)
+    options.push_back(this->pump_->get_schedule_name(i));
+  options.push_back(this->builtin_last_option_);
+  this->traits.set_options(options);
+}
+
 void ScheduleSelect::control(size_t index) {
   this->pref_.save(&index);
   if (this->pump_ != nullptr)
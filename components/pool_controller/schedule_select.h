@@ -10,19 +10,26 @@ namespace esphome {
 namespace pool_controller {
 
 /// A Select entity whose options are the named schedules of a PumpSwitch.
-/// Selecting an option sets the pump's active schedule index.
+/// Selecting an option sets the pump's active schedule index. The options are rebuilt from the pump's schedule table
+/// whenever it changes, so they always point into the active name pool.
 class ScheduleSelect : public select::Select, public Component {
  public:
   void set_pump_switch(PumpSwitch *pump) { this->pump_ = pump; }
+  /// Label of the built-in last option ("Always" or "When X is Running").
+  void set_builtin_last_option(const char *option) { this->builtin_last_option_ = option; }
 
   void setup() override;
   void dump_config() override;
-  float get_setup_priority() const override { return setup_priority::HARDWARE; }
+  /// After the pump, whose setup() restores the schedules loaded at runtime that the saved index refers to.
+  float get_setup_priority() const override { return setup_priority::DATA - 1.0f; }
 
  protected:
   void control(size_t index) override;
+  /// Sets the options to Off, the pump's schedules and the built-in last option.
+  void update_options_();
 
   PumpSwitch *pump_{nullptr};
+  const char *builtin_last_option_{""};
   ESPPreferenceObject pref_;
 };
 
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// The packed schedule layout shared by the tables generated into flash (see _schedules_to_code in __init__.py) and
+// the schedules loaded at runtime through the set_pump_schedules service, plus the parser for the latter. Kept free
+// of ESPHome so schedule definitions can be checked on a PC.
+//
+// The ESP8266 can only read flash a whole aligned 32-bit word at a time, so every table entry is a single uint32_t.
+
+namespace esphome {
+namespace pool_controller {
+
+/// A single time window within a schedule, packed into one word:
+///   bits 0-6   days of week: bit0=Sun, bit1=Mon, ..., bit6=Sat; 0x7F = every day
+///   bits 8-13  minutes to run per hour within this window
+///   bits 16-21 start, in half hours since midnight (0-47)
+///   bits 24-29 end, in half hours since midnight (1-48, 48 = 24:00)
+struct ScheduleRuntime {
+  uint32_t packed;
+
+  static constexpr ScheduleRuntime pack(uint8_t start_half_hour, uint8_t end_half_hour, uint8_t minutes_per_hour,
+                                        uint8_t days_of_week) {
+    return {static_cast<uint32_t>(end_half_hour) << 24 | static_cast<uint32_t>(start_half_hour) << 16 |
+            static_cast<uint32_t>(minutes_per_hour) << 8 | days_of_week};
+  }
+
+  uint16_t start_minute() const { return ((this->packed >> 16) & 0x3F) * 30; }
+  uint16_t end_minute() const { return ((this->packed >> 24) & 0x3F) * 30; }
+  uint8_t minutes_per_hour() const { return (this->packed >> 8) & 0x3F; }
+  uint8_t days_of_week() const { return this->packed & 0x7F; }
+};
+
+/// A named collection of runtime windows, packed into one word:
+///   bits 0-15  index of its first runtime in the runtime table
+///   bits 16-31 offset of its name in the name pool
+/// A table of N schedules has N + 1 entries; the last one only marks where the runtimes of schedule N - 1 end.
+struct Schedule {
+  uint32_t packed;
+
+  static constexpr Schedule pack(uint16_t name_offset, uint16_t first_runtime) {
+    return {static_cast<uint32_t>(name_offset) << 16 | first_runtime};
+  }
+
+  uint16_t first_runtime() const { return this->packed & 0xFFFF; }
+  uint16_t name_offset() const { return this->packed >> 16; }
+};
+
+static constexpr uint8_t MAX_LOADED_SCHEDULES = 8;
+static constexpr uint8_t MAX_LOADED_RUNTIMES = 32;
+static constexpr uint8_t MAX_LOADED_NAME_POOL = 128;
+
+/// Schedules loaded at runtime, in the same layout as the generated tables and saved to flash as is.
+/// A `count` of 0 means no schedules are loaded and the ones from the configuration apply.
+struct ScheduleBuffer {
+  Schedule schedules[MAX_LOADED_SCHEDULES + 1];
+  ScheduleRuntime runtimes[MAX_LOADED_RUNTIMES];
+  char names[MAX_LOADED_NAME_POOL];
+  uint8_t count;
+};
+
+/// Parses a schedule definition into a ScheduleBuffer. Schedules are separated by `;`, each is `name=runtimes`
+/// with runtimes separated by `,`, and each runtime is `start-end/minutes_per_hour[/days]`, e.g.
+///
+///   Normal=4:00-6:00/20,6:00-21:00/40/MON-FRI;Weekend=0:00-24:00/15/SAT+SUN
+///
+/// The rules are the same as for the schedules in the configuration: times on the hour or half hour, 24:00 only as
+/// an end time, 1-60 minutes per hour, unique names and no overlapping runtimes on the same day.
+class ScheduleParser {
+ public:
+  /// Fills `buffer` from `definition`. Returns an empty string on success or a description of the first problem, in
+  /// which case `buffer` holds garbage.
+  static std::string parse(const std::string &definition, ScheduleBuffer &buffer) {
+    buffer = ScheduleBuffer{};
+    uint16_t pool_size = 0;
+    uint16_t runtime_count = 0;
+
+    for (const std::string &schedule_definition : split_(definition, ';')) {
+      if (schedule_definition.empty())
+        continue;
+      const size_t equals = schedule_definition.find('=');
+      if (equals == std::string::npos)
+        return "missing '=' in '" + schedule_definition + "'";
+      const std::string name = trim_(schedule_definition.substr(0, equals));
+      if (name.empty())
+        return "schedule without a name";
+      if (buffer.count == MAX_LOADED_SCHEDULES)
+        return "more than " + std::to_string(MAX_LOADED_SCHEDULES) + " schedules";
+      for (uint8_t i = 0; i < buffer.count; i++) {
+        if (name == &buffer.names[buffer.schedules[i].name_offset()])
+          return "duplicate schedule name '" + name + "'";
+      }
+      if (pool_size + name.size() + 1 > MAX_LOADED_NAME_POOL)
+        return "schedule names longer than " + std::to_string(MAX_LOADED_NAME_POOL) + " characters in total";
+
+      const uint16_t first_runtime = runtime_count;
+      buffer.schedules[buffer.count] = Schedule::pack(pool_size, first_runtime);
+      std::memcpy(&buffer.names[pool_size], name.c_str(), name.size() + 1);
+      pool_size += name.size() + 1;
+
+      for (const std::string &runtime_definition : split_(schedule_definition.substr(equals + 1), ',')) {
+        ScheduleRuntime runtime{};
+        const std::string error = parse_runtime_(runtime_definition, runtime);
+        if (!error.empty())
+          return "'" + name + "': " + error;
+        for (uint16_t i = first_runtime; i < runtime_count; i++) {
+          const ScheduleRuntime &other = buffer.runtimes[i];
+          if ((runtime.days_of_week() & other.days_of_week()) != 0 && runtime.start_minute() < other.end_minute() &&
+              other.start_minute() < runtime.end_minute())
+            return "'" + name + "': '" + trim_(runtime_definition) + "' overlaps another runtime on the same day";
+        }
+        if (runtime_count == MAX_LOADED_RUNTIMES)
+          return "more than " + std::to_string(MAX_LOADED_RUNTIMES) + " runtimes";
+        buffer.runtimes[runtime_count++] = runtime;
+      }
+      if (runtime_count == first_runtime)
+        return "'" + name + "' has no runtimes";
+      buffer.count++;
+    }
+
+    if (buffer.count == 0)
+      return "no schedules";
+    buffer.schedules[buffer.count] = Schedule::pack(pool_size, runtime_count);
+    return "";
+  }
+
+ protected:
+  static std::vector<std::string> split_(const std::string &value, char separator) {
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (true) {
+      const size_t end = value.find(separator, start);
+      parts.push_back(value.substr(start, end == std::string::npos ? std::string::npos : end - start));
+      if (end == std::string::npos)
+        return parts;
+      start = end + 1;
+    }
+  }
+
+  static std::string trim_(const std::string &value) {
+    const size_t start = value.find_first_not_of(" \t");
+    if (start == std::string::npos)
+      return "";
+    return value.substr(start, value.find_last_not_of(" \t") - start + 1);
+  }
+
+  /// Parses a whole non-negative number, returns -1 if `value` isn't one.
+  static int parse_number_(const std::string &value) {
+    if (value.empty() || value.size() > 4 || value.find_first_not_of("0123456789") != std::string::npos)
+      return -1;
+    int number = 0;
+    for (char c : value)
+      number = number * 10 + (c - '0');
+    return number;
+  }
+
+  /// Parses `H:MM` on the hour or half hour into half hours since midnight, returns -1 if it isn't one.
+  static int parse_half_hour_(const std::string &value) {
+    const size_t colon = value.find(':');
+    if (colon == std::string::npos)
+      return -1;
+    const int hour = parse_number_(value.substr(0, colon));
+    const std::string minute_part = value.substr(colon + 1);
+    const int minute = minute_part.size() == 2 ? parse_number_(minute_part) : -1;
+    if (hour < 0 || hour > 24 || (minute != 0 && minute != 30) || (hour == 24 && minute != 0))
+      return -1;
+    return hour * 2 + minute / 30;
+  }
+
+  /// Parses day names (SUN-SAT) joined by `+`, each a single day or a range like MON-FRI, into a days mask.
+  static int parse_days_(const std::string &value) {
+    static const char *const DAY_NAMES[] = {"SUN", "MON", "TUE", "WED", "THU", "FRI", "SAT"};
+    auto day_index = [](std::string day) -> int {
+      for (char &c : day)
+        c = static_cast<char>(c >= 'a' && c <= 'z' ? c - 'a' + 'A' : c);
+      for (int i = 0; i < 7; i++) {
+        if (day == DAY_NAMES[i])
+          return i;
+      }
+      return -1;
+    };
+
+    int mask = 0;
+    for (const std::string &part : split_(value, '+')) {
+      const size_t dash = part.find('-');
+      const int first = day_index(trim_(part.substr(0, dash)));
+      const int last = dash == std::string::npos ? first : day_index(trim_(part.substr(dash + 1)));
+      if (first < 0 || last < 0)
+        return -1;
+      // Ranges may wrap around the end of the week, e.g. FRI-MON
+      for (int day = first;; day = (day + 1) % 7) {
+        mask |= 1 << day;
+        if (day == last)
+          break;
+      }
+    }
+    return mask;
+  }
+
+  static std::string parse_runtime_(const std::string &definition, ScheduleRuntime &runtime) {
+    const std::vector<std::string> parts = split_(trim_(definition), '/');
+    if (parts.size() < 2 || parts.size() > 3)
+      return "'" + trim_(definition) + "' is not start-end/minutes_per_hour[/days]";
+
+    const size_t dash = parts[0].find('-');
+    if (dash == std::string::npos)
+      return "'" + parts[0] + "' is not start-end";
+    const int start = parse_half_hour_(trim_(parts[0].substr(0, dash)));
+    const int end = parse_half_hour_(trim_(parts[0].substr(dash + 1)));
+    if (start < 0 || end < 0)
+      return "'" + parts[0] + "' must use times on the hour or half hour";
+    if (start >= end)
+      return "'" + parts[0] + "' must start before it ends";
+
+    const int minutes_per_hour = parse_number_(trim_(parts[1]));
+    if (minutes_per_hour < 1 || minutes_per_hour > 60)
+      return "minutes per hour '" + parts[1] + "' must be 1-60";
+
+    int days = 0x7F;
+    if (parts.size() == 3) {
+      days = parse_days_(parts[2]);
+      if (days <= 0)
+        return "'" + parts[2] + "' is not a list of days like MON-FRI or SAT+SUN";
+    }
+
+    runtime = ScheduleRuntime::pack(start, end, minutes_per_hour, days);
+    return "";
+  }
+};
+
+}  // namespace pool_controller
+}  // namespace esphome
@@ -1,5 +1,5 @@
 import esphome.codegen as cg
-from esphome.components import light, output
+from esphome.components import light, output, text_sensor
 from esphome.components.light.effects import (
     BINARY_EFFECTS,
     register_binary_effect,
@@ -7,8 +7,25 @@ from esphome.components.light.effects import (
 )
 from esphome.components.light.types import LightEffect
 import esphome.config_validation as cv
-from esphome.const import CONF_EFFECTS, CONF_NAME, CONF_OUTPUT, CONF_OUTPUT_ID
+from esphome.const import (
+    CONF_EFFECTS,
+    CONF_NAME,
+    CONF_OUTPUT,
+    CONF_OUTPUT_ID,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+)
+from esphome.core import TimePeriod
+
+AUTO_LOAD = ["loop_profile", "text_sensor"]
+
+CONF_COLOR_CHANGE_OFF_TIME = "color_change_off_time"
+CONF_COLOR_CHANGE_ON_TIME = "color_change_on_time"
+CONF_TRANSITION_PLAN = "transition_plan"
+CONF_HARDWARE_TIMER = "hardware_timer"
+CONF_GROUP_OUTPUTS = "group_outputs"
 
+# Must match MAX_LIGHTS in treo_light.h, which includes the primary output.
+MAX_GROUP_OUTPUTS = 3
 
 treo_light_ns = cg.esphome_ns.namespace("treo_light")
 TreoPoolLightOutput = treo_light_ns.class_(
@@ -40,10 +57,29 @@ def _inject_treo_effects(config):
     return config
 
 
+# Step times are stored as 16 bit milliseconds in the compiled pulse sequence.
+_step_time = cv.All(
+    cv.positive_time_period_milliseconds,
+    cv.Range(max=TimePeriod(seconds=10)),
+)
+
 CONFIG_SCHEMA = light.BINARY_LIGHT_SCHEMA.extend(
     {
         cv.GenerateID(CONF_OUTPUT_ID): cv.declare_id(TreoPoolLightOutput),
         cv.Required(CONF_OUTPUT): cv.use_id(output.BinaryOutput),
+        cv.Optional(CONF_GROUP_OUTPUTS): cv.All(
+            cv.ensure_list(cv.use_id(output.BinaryOutput)),
+            cv.Length(min=1, max=MAX_GROUP_OUTPUTS),
+        ),
+        cv.Optional(CONF_COLOR_CHANGE_OFF_TIME, default="200ms"): _step_time,
+        cv.Optional(CONF_COLOR_CHANGE_ON_TIME, default="200ms"): _step_time,
+        cv.Optional(CONF_HARDWARE_TIMER, default=False): cv.All(
+            cv.boolean, cv.only_on_esp32
+        ),
+        cv.Optional(CONF_TRANSITION_PLAN): text_sensor.text_sensor_schema(
+            icon="mdi:routes",
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
         cv.Optional(CONF_EFFECTS): cv.invalid(
             "Treo LED pool light effects are fixed and cannot be customized. "
             "Remove the 'effects' key from your configuration."
@@ -58,4 +94,15 @@ async def to_code(config):
     await light.register_light(var, config)
 
     out = await cg.get_variable(config[CONF_OUTPUT])
-    cg.add(var.set_output(out))
+    cg.add(var.add_output(out))
+    for group_output in config.get(CONF_GROUP_OUTPUTS, []):
+        out = await cg.get_variable(group_output)
+        cg.add(var.add_output(out))
+    cg.add(var.set_color_change_off_time(config[CONF_COLOR_CHANGE_OFF_TIME]))
+    cg.add(var.set_color_change_on_time(config[CONF_COLOR_CHANGE_ON_TIME]))
+    if config[CONF_HARDWARE_TIMER]:
+        cg.add(var.set_use_hardware_timer(True))
+
+    if plan_config := config.get(CONF_TRANSITION_PLAN):
+        sens = await text_sensor.new_text_sensor(plan_config)
+        cg.add(var.set_transition_plan_sensor(sens))
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome::treo_light {
+
+/// Bookkeeping performed when a step starts, i.e. the moment its level is applied to the output.
+enum class StepEvent : uint8_t {
+  NONE,
+  ADVANCE,  ///< The light is powered back on after a short off period and moves to the next color.
+  RESET,    ///< The light is powered back on after the reset sequence and shows color 1.
+};
+
+/// Step mask selecting every light of a group.
+static constexpr uint8_t ALL_LIGHTS = 0xFF;
+
+/// One output level held for a fixed time. Lights outside `mask` stay on for the step and ignore its event.
+struct PulseStep {
+  uint16_t duration_ms;
+  bool level;
+  StepEvent event;
+  uint8_t mask;
+};
+
+/// Fixed-capacity list of steps making up a complete transition, compiled up front so playback never allocates.
+class PulseSequence {
+ public:
+  /// Large enough for a full reset followed by seven forward steps.
+  static constexpr size_t MAX_STEPS = 32;
+
+  void clear() { this->size_ = 0; }
+  bool add(bool level, uint32_t duration_ms, StepEvent event = StepEvent::NONE, uint8_t mask = ALL_LIGHTS) {
+    if (this->size_ >= MAX_STEPS)
+      return false;
+    this->steps_[this->size_++] = {static_cast<uint16_t>(duration_ms), level, event, mask};
+    return true;
+  }
+  size_t size() const { return this->size_; }
+  bool empty() const { return this->size_ == 0; }
+  const PulseStep &operator[](size_t index) const { return this->steps_[index]; }
+
+ protected:
+  std::array<PulseStep, MAX_STEPS> steps_{};
+  size_t size_{0};
+};
+
+}  // namespace esphome::treo_light
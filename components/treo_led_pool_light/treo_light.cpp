@@ -1,11 +1,33 @@
 #include "treo_light.h"
 
 #include "esphome/core/log.h"
+#include "esphome/components/loop_profile/loop_profile.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
 
 namespace esphome::treo_light {
 
 static const char *const TAG = "treo_led_pool_light";
-static constexpr uint16_t COLOR_CHANGE_ON_OFF_TIME = 200;
+// Color reset sequence from the Treo user guide: off for 5.5 s, toggle on/off 3 times 250 ms apart,
+// then off for another 5.5 s, after which the light is back on color 1.
+static constexpr uint32_t COLOR_RESET_OFF_TIME = 5500;
+static constexpr uint32_t COLOR_RESET_TOGGLE_TIME = 250;
+static constexpr uint32_t COLOR_RESET_DURATION = 2 * COLOR_RESET_OFF_TIME + 5 * COLOR_RESET_TOGGLE_TIME;
+static constexpr uint8_t COLOR_COUNT = 8;
+static constexpr uint32_t PROGRESS_HASH = 0x7472656F;  // "treo"
+
+static const char *strategy_to_string(TransitionStrategy strategy) {
+  switch (strategy) {
+    case TransitionStrategy::FORWARD:
+      return "Forward";
+    case TransitionStrategy::RESET_THEN_FORWARD:
+      return "Reset then forward";
+    default:
+      return "None";
+  }
+}
 
 light::LightTraits TreoPoolLightOutput::get_traits() {
   auto traits = light::LightTraits();
@@ -13,37 +35,122 @@ light::LightTraits TreoPoolLightOutput::get_traits() {
   return traits;
 }
 
-void TreoPoolLightOutput::setup() { register_service(&TreoPoolLightOutput::color_reset, "color_reset"); }
+void TreoPoolLightOutput::setup() {
+  register_service(&TreoPoolLightOutput::color_reset, "color_reset");
+
+#ifdef USE_ESP32
+  if (this->use_hardware_timer_) {
+    esp_timer_create_args_t args{};
+    args.callback = &TreoPoolLightOutput::hardware_timer_callback_;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "treo_pulse";
+    if (esp_timer_create(&args, &this->hardware_timer_) != ESP_OK) {
+      ESP_LOGE(TAG, "Failed to create the pulse timer, falling back to the main loop");
+      this->hardware_timer_ = nullptr;
+    }
+  }
+#endif
+
+  // The loop only has work to do while a sequence is playing.
+  this->disable_loop();
+}
 
 // skipcq: cxx-c2014
 void TreoPoolLightOutput::setup_state(light::LightState *state) {
   this->state_ = state;
 
-  this->color_pref_ = this->state_->make_entity_preference<uint32_t>();
-  if (this->color_pref_.load(&this->current_color_)) {
-    ESP_LOGD(TAG, "Restored color %u from flash", this->current_color_);
+  this->record_pref_ = this->state_->make_entity_preference<ColorRecord>(2);
+  this->progress_pref_ =
+      global_preferences->make_preference<ColorProgress>(this->state_->get_object_id_hash() ^ PROGRESS_HASH, false);
+
+  if (this->record_pref_.load(&this->record_)) {
+    this->colors_ = this->record_.colors;
+    if (this->record_.in_progress) {
+      if (this->progress_pref_.load(&this->progress_) && this->progress_.sequence == this->record_.sequence) {
+        // The next write replays the remaining steps from wherever the lights got to.
+        ESP_LOGW(TAG, "Transition %u -> %u was interrupted after %u of %u step(s), resuming from color %u",
+                 this->record_.colors[0], this->record_.target, this->progress_.events_done,
+                 this->record_.planned_steps, this->progress_.colors[0]);
+        this->colors_ = this->progress_.colors;
+      } else {
+        ESP_LOGW(TAG, "Transition %u -> %u was interrupted at an unknown step, a color reset will resync the light",
+                 this->record_.colors[0], this->record_.target);
+        this->set_current_color_(this->record_.target);
+        this->reset_on_boot_ = true;
+      }
+      this->commit_record_();
+    } else {
+      ESP_LOGD(TAG, "Restored color %u from flash", this->get_current_color_());
+    }
   } else {
-    this->set_current_color_(1);
+    // Fall back to the color saved by earlier versions, which stored nothing but the color of a single light.
+    // They declared the preference as uint32_t but saved and loaded a single uint8_t through it.
+    uint8_t legacy_color = 1;
+    if (this->state_->make_entity_preference<uint32_t>().load(&legacy_color))
+      ESP_LOGD(TAG, "Restored color %u from flash", legacy_color);
+    this->set_current_color_(legacy_color);
+    this->commit_record_();
   }
 
   // Set hardware to match the restored state from ESPHome
   bool restored_on = false;
   state->current_values_as_binary(&restored_on);
-  this->output_->set_state(restored_on);
+  this->write_outputs_(restored_on);
 }
 
 void TreoPoolLightOutput::dump_config() {
   ESP_LOGCONFIG(TAG, "Treo LED Pool Light:");
-  ESP_LOGCONFIG(TAG, "  Current Color: %u", this->get_current_color_());
+  for (uint8_t i = 0; i < this->light_count_; i++)
+    ESP_LOGCONFIG(TAG, "  Light %u Current Color: %u", i + 1, this->colors_[i]);
+  ESP_LOGCONFIG(TAG, "  Color Change Off Time: %" PRIu32 " ms", this->color_change_off_time_);
+  ESP_LOGCONFIG(TAG, "  Color Change On Time: %" PRIu32 " ms", this->color_change_on_time_);
+#ifdef USE_ESP32
+  ESP_LOGCONFIG(TAG, "  Pulse Clock: %s", this->hardware_timer_ != nullptr ? "hardware timer" : "main loop");
+#endif
+  LOG_TEXT_SENSOR("  ", "Transition Plan", this->transition_plan_sensor_);
+}
+
+void TreoPoolLightOutput::loop() {
+  LOOP_PROFILE("treo_light");
+  if (!this->is_changing_colors_) {
+    this->disable_loop();
+    return;
+  }
+
+  if (!this->timer_clock_) {
+    // Also picks up a sequence whose hardware timer failed to re-arm, so it still finishes.
+    this->high_freq_.start();
+    // Steps are timed from the moment they actually started, so a late loop can stretch a step but never
+    // shorten the next one below its configured time, which is what makes the light miss a color.
+    const uint32_t now = millis();
+    if (now - this->step_started_ms_ >= this->sequence_[this->step_index_].duration_ms) {
+      this->step_started_ms_ = now;
+      this->advance_step_();
+    }
+  }
+
+  this->process_steps_();
 }
 
 void TreoPoolLightOutput::write_state(light::LightState *state) {
-  if (this->is_changing_colors_)
+  if (this->is_changing_colors_) {
+    // Picked up at the next step boundary, only the latest command matters.
+    this->pending_.valid = true;
+    this->state_->current_values_as_binary(&this->pending_.state);
+    this->pending_.color = this->get_target_color_();
+    return;
+  }
+
+  if (this->reset_on_boot_) {
+    this->reset_on_boot_ = false;
+    this->color_reset();
     return;
+  }
 
   bool target_state;
   this->state_->current_values_as_binary(&target_state);
-  this->output_->set_state(target_state);
+  this->write_outputs_(target_state);
 
   if (target_state) {
     int effect_index = this->state_->get_current_effect_index();
@@ -53,52 +160,266 @@ void TreoPoolLightOutput::write_state(light::LightState *state) {
       auto call = this->state_->turn_on();
       call.set_effect(current_color);
       call.perform();
-    } else if (get_target_color_() != current_color) {
-      this->is_changing_colors_ = true;
-      this->set_timeout("COLOR_CHANGE", COLOR_CHANGE_ON_OFF_TIME, [this]() { this->color_change_off_(); });
+    } else if (!this->all_lights_at_(get_target_color_())) {
+      auto plan = this->plan_transition_(get_target_color_());
+      this->log_plan_(plan, current_color, get_target_color_());
+      this->compile_transition_(plan, get_target_color_(), target_state);
+      this->start_sequence_(plan, get_target_color_());
     }
   }
 }
 
-void TreoPoolLightOutput::color_change_off_() {
-  this->output_->set_state(false);
-  this->set_timeout("COLOR_CHANGE", COLOR_CHANGE_ON_OFF_TIME, [this]() { this->color_change_on_(); });
+void TreoPoolLightOutput::compile_transition_(const TransitionPlan &plan, uint8_t target, bool final_state) {
+  this->sequence_.clear();
+  const bool reset = plan.strategy == TransitionStrategy::RESET_THEN_FORWARD;
+
+  if (reset) {
+    // Off, three short on pulses, then off again; the next power on shows color 1.
+    this->sequence_.add(false, COLOR_RESET_OFF_TIME);
+    for (uint8_t i = 0; i < 3; i++) {
+      this->sequence_.add(true, COLOR_RESET_TOGGLE_TIME);
+      this->sequence_.add(false, i < 2 ? COLOR_RESET_TOGGLE_TIME : COLOR_RESET_OFF_TIME);
+    }
+    if (plan.steps > 0 || final_state) {
+      this->sequence_.add(true, this->color_change_on_time_, StepEvent::RESET);
+    } else {
+      // Leave the light off, a zero length step just records that it is back on color 1.
+      this->sequence_.add(false, 0, StepEvent::RESET);
+    }
+  } else {
+    // Give the light one on period before the first step.
+    this->sequence_.add(true, this->color_change_on_time_);
+  }
+
+  // Each light only takes the pulses it needs, lights that get there early stay on for the rest of the sequence.
+  std::array<uint8_t, MAX_LIGHTS> distance{};
+  for (uint8_t i = 0; i < this->light_count_; i++)
+    distance[i] = (target + COLOR_COUNT - (reset ? 1 : this->colors_[i])) % COLOR_COUNT;
+  for (uint8_t step = 0; step < plan.steps; step++) {
+    uint8_t mask = 0;
+    for (uint8_t i = 0; i < this->light_count_; i++) {
+      if (step < distance[i])
+        mask |= 1 << i;
+    }
+    this->sequence_.add(false, this->color_change_off_time_, StepEvent::NONE, mask);
+    this->sequence_.add(true, this->color_change_on_time_, StepEvent::ADVANCE, mask);
+  }
 }
 
-void TreoPoolLightOutput::color_change_on_() {
-  this->output_->set_state(true);
-  int old_color = this->get_current_color_();
-  int new_color = old_color < 8 ? old_color + 1 : 1;
-  this->set_current_color_(new_color);
-  int target_color = get_target_color_();
-  ESP_LOGV(TAG, "Color change step: current=%u, target=%u", new_color, target_color);
+void TreoPoolLightOutput::start_sequence_(const TransitionPlan &plan, uint8_t target) {
+  // One flash write for the whole transition, the per-step progress stays out of flash.
+  this->get_current_color_();
+  const bool was_idle = !this->record_.in_progress;
+  this->record_.colors = this->colors_;
+  this->record_.target = target;
+  this->record_.planned_steps = plan.steps + (plan.strategy == TransitionStrategy::RESET_THEN_FORWARD ? 1 : 0);
+  this->record_.sequence++;
+  this->record_.in_progress = true;
+  this->record_pref_.save(&this->record_);
+  // Don't wait for the periodic sync, a reboot before it would restore the color from before the transition and
+  // never know to resync. A re-target finds a record already marked in progress in flash, which is enough.
+  if (was_idle)
+    global_preferences->sync();
+  this->progress_.sequence = this->record_.sequence;
+  this->progress_.colors = this->colors_;
+  this->progress_.events_done = 0;
+  this->progress_pref_.save(&this->progress_);
 
-  if (new_color != target_color) {
-    this->set_timeout("COLOR_CHANGE", COLOR_CHANGE_ON_OFF_TIME, [this]() { this->color_change_off_(); });
-  } else {
-    bool target_state;
-    this->state_->current_values_as_binary(&target_state);
-    if (target_state) {
-      this->is_changing_colors_ = false;
+  this->is_changing_colors_ = true;
+  this->step_index_ = 0;
+  this->processed_index_ = 0;
+  this->write_step_(this->sequence_[0]);
+  this->handle_step_event_(this->sequence_[0]);
+  this->step_started_ms_ = millis();
+
+  this->timer_clock_ = false;
+#ifdef USE_ESP32
+  if (this->hardware_timer_ != nullptr) {
+    const esp_err_t err =
+        esp_timer_start_once(this->hardware_timer_, static_cast<uint64_t>(this->sequence_[0].duration_ms) * 1000);
+    if (err == ESP_OK) {
+      this->timer_clock_ = true;
     } else {
-      this->set_timeout("COLOR_CHANGE", COLOR_CHANGE_ON_OFF_TIME, [this]() {
-        this->is_changing_colors_ = false;
-        this->write_state(this->state_);
-      });
+      ESP_LOGW(TAG, "Failed to start the pulse timer (%s), timing this sequence from the main loop",
+               esp_err_to_name(err));
+    }
+  }
+#endif
+  if (!this->timer_clock_)
+    this->high_freq_.start();
+  this->enable_loop();
+}
+
+void TreoPoolLightOutput::write_step_(const PulseStep &step) {
+  for (uint8_t i = 0; i < this->light_count_; i++)
+    this->outputs_[i]->set_state((step.mask & (1 << i)) != 0 ? step.level : true);
+}
+
+void TreoPoolLightOutput::write_outputs_(bool state) {
+  for (uint8_t i = 0; i < this->light_count_; i++)
+    this->outputs_[i]->set_state(state);
+}
+
+void TreoPoolLightOutput::advance_step_() {
+  const uint8_t next = this->step_index_ + 1;
+  if (next < this->sequence_.size())
+    this->write_step_(this->sequence_[next]);
+  this->step_index_ = next;
+}
+
+#ifdef USE_ESP32
+void TreoPoolLightOutput::hardware_timer_callback_(void *arg) {
+  auto *light = static_cast<TreoPoolLightOutput *>(arg);
+  light->advance_step_();
+  const uint8_t index = light->step_index_;
+  if (index < light->sequence_.size())
+    light->restart_hardware_timer_(index);
+}
+
+void TreoPoolLightOutput::restart_hardware_timer_(uint8_t index) {
+  const esp_err_t err =
+      esp_timer_start_once(this->hardware_timer_, static_cast<uint64_t>(this->sequence_[index].duration_ms) * 1000);
+  if (err == ESP_OK)
+    return;
+  // loop() takes over the clock from the step that just started, it starts the high frequency loop itself as that
+  // can only be done on the main loop.
+  ESP_LOGW(TAG, "Failed to restart the pulse timer (%s), finishing the sequence from the main loop",
+           esp_err_to_name(err));
+  this->step_started_ms_ = millis();
+  this->timer_clock_ = false;
+}
+#endif
+
+void TreoPoolLightOutput::process_steps_() {
+  const uint8_t index = this->step_index_;
+  while (this->processed_index_ < index) {
+    this->processed_index_++;
+    if (this->processed_index_ < this->sequence_.size())
+      this->handle_step_event_(this->sequence_[this->processed_index_]);
+  }
+  if (index < this->sequence_.size()) {
+    // The light is on and showing a known color at the start of the first step, after the reset and after every
+    // forward step, so these are the only places a new plan can take over.
+    const PulseStep &step = this->sequence_[index];
+    if (this->pending_.valid && step.level && (index == 0 || step.event != StepEvent::NONE))
+      this->retarget_(index);
+    return;
+  }
+
+  this->finish_sequence_();
+}
+
+void TreoPoolLightOutput::retarget_(uint8_t index) {
+  const PendingCommand command = this->pending_;
+  const uint8_t current_color = this->get_current_color_();
+  // Turning the light off just stops stepping at the current color, the next turn on carries on from there.
+  const uint8_t target_color = command.state || command.reset ? command.color : current_color;
+  if (!command.reset && command.state && target_color == this->record_.target) {
+    this->pending_ = {};
+    return;
+  }
+
+#ifdef USE_ESP32
+  if (this->timer_clock_) {
+    // esp_timer_stop() doesn't wait for a callback that is already running, and a one-shot timer is disarmed
+    // while its callback runs, so anything but ESP_OK means the step is changing under us. Try again next loop.
+    if (esp_timer_stop(this->hardware_timer_) != ESP_OK)
+      return;
+    if (this->step_index_ != index) {
+      // Lost the race with the timer, give the step it just started its full time and try again later.
+      const uint8_t current = this->step_index_;
+      if (current < this->sequence_.size())
+        this->restart_hardware_timer_(current);
+      return;
     }
   }
+#endif
+
+  this->pending_ = {};
+  TransitionPlan plan;
+  if (command.reset) {
+    plan.strategy = TransitionStrategy::RESET_THEN_FORWARD;
+    plan.steps = target_color - 1;
+  } else {
+    plan = this->plan_transition_(target_color);
+  }
+  if (plan.strategy == TransitionStrategy::NONE) {
+    this->finish_sequence_();
+    return;
+  }
+
+  ESP_LOGD(TAG, "Re-targeting color change at step %u", index);
+  this->log_plan_(plan, current_color, target_color);
+  this->compile_transition_(plan, target_color, command.state);
+  this->start_sequence_(plan, target_color);
+}
+
+void TreoPoolLightOutput::finish_sequence_() {
+  this->high_freq_.stop();
+  this->timer_clock_ = false;
+  this->is_changing_colors_ = false;
+  this->commit_record_();
+  if (this->pending_.reset) {
+    this->pending_ = {};
+    this->color_reset();
+    return;
+  }
+  this->pending_ = {};
+  // Settle on the requested on/off state, and start over if a different color was picked while we were busy.
+  this->write_state(this->state_);
+}
+
+void TreoPoolLightOutput::handle_step_event_(const PulseStep &step) {
+  switch (step.event) {
+    case StepEvent::ADVANCE:
+      for (uint8_t i = 0; i < this->light_count_; i++) {
+        if ((step.mask & (1 << i)) != 0)
+          this->colors_[i] = this->colors_[i] < COLOR_COUNT ? this->colors_[i] + 1 : 1;
+      }
+      ESP_LOGV(TAG, "Color change step: current=%u, target=%u", this->get_current_color_(), this->get_target_color_());
+      this->save_progress_();
+      break;
+    case StepEvent::RESET:
+      ESP_LOGD(TAG, "Color reset complete");
+      this->set_current_color_(1);
+      this->save_progress_();
+      break;
+    default:
+      break;
+  }
 }
 
 uint8_t TreoPoolLightOutput::get_current_color_() {
-  if (this->current_color_ < 1 || this->current_color_ > 8) {
-    set_current_color_(1);
+  for (auto &color : this->colors_) {
+    if (color < 1 || color > COLOR_COUNT)
+      color = 1;
+  }
+  return this->colors_[0];
+}
+
+void TreoPoolLightOutput::set_current_color_(uint8_t color) { this->colors_.fill(color); }
+
+bool TreoPoolLightOutput::all_lights_at_(uint8_t color) const {
+  for (uint8_t i = 0; i < this->light_count_; i++) {
+    if (this->colors_[i] != color)
+      return false;
   }
-  return this->current_color_;
+  return true;
+}
+
+void TreoPoolLightOutput::save_progress_() {
+  this->progress_.colors = this->colors_;
+  this->progress_.events_done++;
+  this->progress_pref_.save(&this->progress_);
 }
 
-void TreoPoolLightOutput::set_current_color_(uint8_t color) {
-  this->current_color_ = color;
-  this->color_pref_.save(&this->current_color_);
+void TreoPoolLightOutput::commit_record_() {
+  this->get_current_color_();
+  this->record_.colors = this->colors_;
+  this->record_.target = this->colors_[0];
+  this->record_.planned_steps = 0;
+  this->record_.in_progress = false;
+  this->record_pref_.save(&this->record_);
 }
 
 int TreoPoolLightOutput::get_target_color_() {
@@ -110,9 +431,53 @@ int TreoPoolLightOutput::get_target_color_() {
   return this->get_current_color_();
 }
 
+TransitionPlan TreoPoolLightOutput::plan_transition_(uint8_t to) const {
+  TransitionPlan plan;
+  if (this->all_lights_at_(to))
+    return plan;
+
+  // Every forward step is an off/on power cycle; the light is given one on period before the first step.
+  const uint32_t step_time = this->color_change_off_time_ + this->color_change_on_time_;
+
+  // Lights step together, so the light furthest behind decides how many steps are needed.
+  uint8_t forward_steps = 0;
+  for (uint8_t i = 0; i < this->light_count_; i++)
+    forward_steps = std::max<uint8_t>(forward_steps, (to + COLOR_COUNT - this->colors_[i]) % COLOR_COUNT);
+  plan.strategy = TransitionStrategy::FORWARD;
+  plan.steps = forward_steps;
+  plan.duration_ms = this->color_change_on_time_ + forward_steps * step_time;
+
+  // The reset always lands on color 1, so it can only win for long forward distances with slow steps.
+  const uint8_t reset_steps = to - 1;
+  const uint32_t reset_duration = COLOR_RESET_DURATION + this->color_change_on_time_ + reset_steps * step_time;
+  if (reset_duration < plan.duration_ms) {
+    plan.strategy = TransitionStrategy::RESET_THEN_FORWARD;
+    plan.steps = reset_steps;
+    plan.duration_ms = reset_duration;
+  }
+  return plan;
+}
+
+void TreoPoolLightOutput::log_plan_(const TransitionPlan &plan, uint8_t from, uint8_t to) {
+  ESP_LOGD(TAG, "Color %u -> %u: %s, %u step(s), ~%" PRIu32 " ms", from, to, strategy_to_string(plan.strategy),
+           plan.steps, plan.duration_ms);
+  if (this->transition_plan_sensor_ != nullptr) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%s x%u (%" PRIu32 " ms)", strategy_to_string(plan.strategy), plan.steps,
+             plan.duration_ms);
+    this->transition_plan_sensor_->publish_state(buf);
+  }
+}
+
 void TreoPoolLightOutput::color_reset() {
   if (this->is_changing_colors_) {
-    ESP_LOGW(TAG, "Color reset requested while a color change is already in progress; ignoring.");
+    ESP_LOGD(TAG, "Color reset requested during a color change, starting it at the next step");
+    bool target_state;
+    this->state_->current_values_as_binary(&target_state);
+    this->pending_.valid = true;
+    this->pending_.state = target_state;
+    this->pending_.color = this->get_target_color_();
+    this->pending_.reset = true;
     return;
   }
 
@@ -123,37 +488,17 @@ void TreoPoolLightOutput::color_reset() {
   // * Wait for 5.5 seconds
   // * Toggle the light on/off 3 times with a 250ms delay between each change
   // * Wait for 5.5 seconds
-  // * Turn the light back on setting the color to the "current" color
+  // * Step forward to the "current" color, leaving the light in its requested on/off state
   // Use the effect index from the state as the target color
-  ESP_LOGI(TAG, "Starting color reset (target color: %u)", this->get_target_color_());
-  this->cancel_timeout("COLOR_CHANGE");
-  this->is_changing_colors_ = true;
-  this->output_->set_state(false);
-
-  this->set_timeout("COLOR_RESET_ON_1", 5500, [this]() {
-    this->output_->set_state(true);
-
-    this->set_timeout("COLOR_RESET_OFF_1", 250, [this]() { this->output_->set_state(false); });
-
-    this->set_timeout("COLOR_RESET_ON_2", 500, [this]() { this->output_->set_state(true); });
-
-    this->set_timeout("COLOR_RESET_OFF_2", 750, [this]() { this->output_->set_state(false); });
-
-    this->set_timeout("COLOR_RESET_ON_3", 1000, [this]() { this->output_->set_state(true); });
-
-    this->set_timeout("COLOR_RESET_OFF_3", 1250, [this]() { this->output_->set_state(false); });
-
-    this->set_timeout("COLOR_RESET_FINISH", 6750, [this]() {
-      this->set_current_color_(1);
-      this->is_changing_colors_ = false;
-      int target_color = this->get_target_color_();
-      if (target_color != 1) {
-        auto call = this->state_->turn_on();
-        call.set_effect(target_color);
-        call.perform();
-      }
-    });
-  });
+  uint8_t target_color = this->get_target_color_();
+  ESP_LOGI(TAG, "Starting color reset (target color: %u)", target_color);
+  TransitionPlan plan;
+  plan.strategy = TransitionStrategy::RESET_THEN_FORWARD;
+  plan.steps = target_color - 1;
+  bool target_state;
+  this->state_->current_values_as_binary(&target_state);
+  this->compile_transition_(plan, target_color, target_state);
+  this->start_sequence_(plan, target_color);
 }
 
 }  // namespace esphome::treo_light
@@ -1,18 +1,79 @@
 #pragma once
 
+#include "./pulse_sequence.h"
+
 #include "esphome/core/preferences.h"
 #include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
 #include "esphome/components/api/custom_api_device.h"
 #include "esphome/components/light/light_output.h"
 #include "esphome/components/output/binary_output.h"
+#include "esphome/components/text_sensor/text_sensor.h"
+
+#include <array>
+#include <atomic>
+
+#ifdef USE_ESP32
+#include <esp_timer.h>
+#endif
 
 namespace esphome::treo_light {
 
+/// Lights that can be driven in lockstep by one TreoPoolLightOutput.
+static constexpr uint8_t MAX_LIGHTS = 4;
+
+/// The ways the light can be brought from one color to another.
+enum class TransitionStrategy : uint8_t {
+  NONE,                ///< Already showing the target color.
+  FORWARD,             ///< Power-cycle the light once per color until it reaches the target.
+  RESET_THEN_FORWARD,  ///< Run the color reset sequence (back to color 1), then step forward.
+};
+
+struct TransitionPlan {
+  TransitionStrategy strategy{TransitionStrategy::NONE};
+  uint8_t steps{0};         ///< Forward color steps (after the reset, if any) needed by the furthest light.
+  uint32_t duration_ms{0};  ///< Estimated time until the light shows the target color.
+};
+
+/// Color state kept in flash. Written once when a transition starts and once when it completes.
+struct ColorRecord {
+  std::array<uint8_t, MAX_LIGHTS> colors{};  ///< Color each light showed when the record was written.
+  uint8_t target{1};         ///< Color the transition is heading for.
+  uint8_t planned_steps{0};  ///< Color events (reset plus forward steps) the transition was compiled with.
+  uint8_t sequence{0};       ///< Incremented for every transition, ties the progress record to this one.
+  bool in_progress{false};
+};
+
+/// Progress of the running transition, updated on every color event. Kept out of flash (RTC memory on ESP8266) so it
+/// survives a crash or watchdog reset but costs no flash writes.
+struct ColorProgress {
+  uint8_t sequence{0};
+  std::array<uint8_t, MAX_LIGHTS> colors{};
+  uint8_t events_done{0};
+};
+
+/// The latest command received while a transition was playing; a newer command replaces it.
+struct PendingCommand {
+  bool valid{false};
+  bool state{false};
+  uint8_t color{1};
+  bool reset{false};  ///< A color reset was requested.
+};
+
 class TreoPoolLightOutput : public light::LightOutput, public Component, public api::CustomAPIDevice {
  public:
-  void set_output(output::BinaryOutput *output) { output_ = output; }
+  /// Adds a light. Every light added is driven through the same pulses, the first one is the primary light.
+  void add_output(output::BinaryOutput *output) {
+    if (light_count_ < MAX_LIGHTS)
+      outputs_[light_count_++] = output;
+  }
+  void set_color_change_off_time(uint32_t off_time) { color_change_off_time_ = off_time; }
+  void set_color_change_on_time(uint32_t on_time) { color_change_on_time_ = on_time; }
+  void set_transition_plan_sensor(text_sensor::TextSensor *sensor) { transition_plan_sensor_ = sensor; }
+  void set_use_hardware_timer(bool use_hardware_timer) { use_hardware_timer_ = use_hardware_timer; }
   light::LightTraits get_traits() override;
   void setup() override;
+  void loop() override;
   void dump_config() override;
   void setup_state(light::LightState *state) override;
   void write_state(light::LightState *state) override;
@@ -20,17 +81,63 @@ class TreoPoolLightOutput : public light::LightOutput, public Component, public
   void color_reset();
 
  protected:
-  void color_change_off_();
-  void color_change_on_();
+  /// Compiles the power cycles for `plan` into sequence_, ending with the light in `final_state`.
+  void compile_transition_(const TransitionPlan &plan, uint8_t target, bool final_state);
+  /// Plays sequence_ from its first step; the light is locked against other changes until it finishes.
+  void start_sequence_(const TransitionPlan &plan, uint8_t target);
+  /// Applies `step` to every light.
+  void write_step_(const PulseStep &step);
+  void write_outputs_(bool state);
+  /// Moves the outputs on to the next step. Called from loop() or, with the hardware timer, from the timer task.
+  void advance_step_();
+  /// Handles the events of every step the clock has reached and finishes the sequence after the last one.
+  void process_steps_();
+  void handle_step_event_(const PulseStep &step);
+  /// Re-plans the running sequence from the step at `index` for the pending command. If the hardware timer can't be
+  /// stopped before it moves the step on, the command stays pending and is retried on the next loop.
+  void retarget_(uint8_t index);
+  void finish_sequence_();
+  /// Commits the color reached by the finished transition to flash.
+  void commit_record_();
+  /// Color of the primary light.
   uint8_t get_current_color_();
+  /// Sets every light to `color`.
   void set_current_color_(uint8_t color);
+  bool all_lights_at_(uint8_t color) const;
+  void save_progress_();
   int get_target_color_();
+  /// Picks the cheapest strategy for getting every light to color `to`.
+  TransitionPlan plan_transition_(uint8_t to) const;
+  void log_plan_(const TransitionPlan &plan, uint8_t from, uint8_t to);
 
-  output::BinaryOutput *output_ = nullptr;
+  std::array<output::BinaryOutput *, MAX_LIGHTS> outputs_{};
+  uint8_t light_count_ = 0;
   light::LightState *state_ = nullptr;
-  ESPPreferenceObject color_pref_;
-  uint8_t current_color_ = 1;
+  ESPPreferenceObject record_pref_;
+  ESPPreferenceObject progress_pref_;
+  ColorRecord record_{};
+  ColorProgress progress_{};
+  PendingCommand pending_{};
+  bool reset_on_boot_ = false;  ///< An interrupted transition left the color unknown, resync on the first write.
+  std::array<uint8_t, MAX_LIGHTS> colors_{1, 1, 1, 1};
   bool is_changing_colors_ = false;
+  uint32_t color_change_off_time_ = 200;
+  uint32_t color_change_on_time_ = 200;
+  text_sensor::TextSensor *transition_plan_sensor_ = nullptr;
+
+  PulseSequence sequence_;
+  std::atomic<uint8_t> step_index_{0};  ///< Step currently applied to the outputs, written only by the active clock.
+  uint8_t processed_index_{0};          ///< Last step whose event has been handled on the main loop.
+  uint32_t step_started_ms_{0};
+  std::atomic<bool> timer_clock_{false};  ///< The hardware timer is clocking the running sequence, else loop() is.
+  HighFrequencyLoopRequester high_freq_;
+  bool use_hardware_timer_{false};
+#ifdef USE_ESP32
+  static void hardware_timer_callback_(void *arg);
+  /// Times the step at `index` with the hardware timer, handing the clock back to loop() if it can't be armed.
+  void restart_hardware_timer_(uint8_t index);
+  esp_timer_handle_t hardware_timer_{nullptr};
+#endif
 };
 
 class TreoPoolLightEffect : public light::LightEffect {
@@ -0,0 +1,79 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import light, sensor, time
+from esphome.components import switch as esphome_switch
+from esphome.const import (
+    CONF_ENERGY,
+    CONF_ID,
+    CONF_LIGHT_ID,
+    CONF_POWER,
+    CONF_RESTORE,
+    CONF_SWITCH_ID,
+    CONF_TIME_ID,
+    DEVICE_CLASS_ENERGY,
+    DEVICE_CLASS_POWER,
+    STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
+    UNIT_WATT,
+    UNIT_WATT_HOURS,
+)
+
+CODEOWNERS = ["@nuttytree"]
+DEPENDENCIES = ["time"]
+AUTO_LOAD = ["sensor"]
+MULTI_CONF = True
+
+virtual_power_meter_ns = cg.esphome_ns.namespace("virtual_power_meter")
+VirtualPowerMeter = virtual_power_meter_ns.class_("VirtualPowerMeter", cg.Component)
+
+CONF_POWER_SENSOR = "power_sensor"
+CONF_ENERGY_SENSOR = "energy_sensor"
+CONF_ENERGY_INTERVAL = "energy_interval"
+
+CONFIG_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.GenerateID(): cv.declare_id(VirtualPowerMeter),
+            cv.GenerateID(CONF_TIME_ID): cv.use_id(time.RealTimeClock),
+            cv.Optional(CONF_SWITCH_ID): cv.use_id(esphome_switch.Switch),
+            cv.Optional(CONF_LIGHT_ID): cv.use_id(light.LightState),
+            cv.Required(CONF_POWER): cv.All(cv.power, cv.positive_float),
+            cv.Optional(CONF_POWER_SENSOR): sensor.sensor_schema(
+                unit_of_measurement=UNIT_WATT,
+                accuracy_decimals=1,
+                device_class=DEVICE_CLASS_POWER,
+                state_class=STATE_CLASS_MEASUREMENT,
+            ),
+            cv.Optional(CONF_ENERGY_SENSOR): sensor.sensor_schema(
+                unit_of_measurement=UNIT_WATT_HOURS,
+                accuracy_decimals=0,
+                device_class=DEVICE_CLASS_ENERGY,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+            ),
+            cv.Optional(
+                CONF_ENERGY_INTERVAL, default="60s"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_RESTORE, default=True): cv.boolean,
+        }
+    ).extend(cv.COMPONENT_SCHEMA),
+    cv.has_exactly_one_key(CONF_SWITCH_ID, CONF_LIGHT_ID),
+)
+
+
+async def to_code(config):
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+
+    if switch_id := config.get(CONF_SWITCH_ID):
+        cg.add(var.set_switch(await cg.get_variable(switch_id)))
+    if light_id := config.get(CONF_LIGHT_ID):
+        cg.add(var.set_light(await cg.get_variable(light_id)))
+    cg.add(var.set_power(config[CONF_POWER]))
+    cg.add(var.set_time(await cg.get_variable(config[CONF_TIME_ID])))
+    cg.add(var.set_energy_interval(config[CONF_ENERGY_INTERVAL]))
+    cg.add(var.set_restore(config[CONF_RESTORE]))
+
+    if power_config := config.get(CONF_POWER_SENSOR):
+        cg.add(var.set_power_sensor(await sensor.new_sensor(power_config)))
+    if energy_config := config.get(CONF_ENERGY_SENSOR):
+        cg.add(var.set_energy_sensor(await sensor.new_sensor(energy_config)))
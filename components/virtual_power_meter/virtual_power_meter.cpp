@@ -0,0 +1,100 @@
+#include "virtual_power_meter.h"
+
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <cinttypes>
+
+namespace esphome::virtual_power_meter {
+
+static const char *const TAG = "virtual_power_meter";
+// mW·ms in a mWh.
+static constexpr uint64_t MS_PER_HOUR = 60 * 60 * 1000;
+
+void VirtualPowerMeter::setup() {
+  if (this->restore_ && this->energy_sensor_ != nullptr) {
+    this->pref_ = this->energy_sensor_->make_entity_preference<EnergyRecord>();
+    if (!this->pref_.load(&this->record_))
+      this->record_ = {0, -1};
+  }
+  this->last_accumulate_ = millis();
+
+  bool on = false;
+#ifdef USE_SWITCH
+  if (this->switch_ != nullptr) {
+    on = this->switch_->state;
+    this->switch_->add_on_state_callback([this](bool state) { this->set_on_(state); });
+  }
+#endif
+#ifdef USE_LIGHT
+  if (this->light_ != nullptr) {
+    on = this->light_->remote_values.is_on();
+    this->light_->add_new_remote_values_callback([this]() { this->set_on_(this->light_->remote_values.is_on()); });
+  }
+#endif
+  this->on_ = on;
+  if (this->power_sensor_ != nullptr)
+    this->power_sensor_->publish_state(on ? this->milliwatts_ / 1000.0f : 0.0f);
+
+  this->update_energy_();
+  this->set_interval("energy", this->energy_interval_, [this]() { this->update_energy_(); });
+}
+
+void VirtualPowerMeter::dump_config() {
+  ESP_LOGCONFIG(TAG, "Virtual Power Meter:");
+  ESP_LOGCONFIG(TAG, "  Power: %.1f W", this->milliwatts_ / 1000.0f);
+  ESP_LOGCONFIG(TAG, "  Energy Interval: %" PRIu32 " ms", this->energy_interval_);
+  ESP_LOGCONFIG(TAG, "  Restore: %s", YESNO(this->restore_));
+  LOG_SENSOR("  ", "Power", this->power_sensor_);
+  LOG_SENSOR("  ", "Energy", this->energy_sensor_);
+}
+
+void VirtualPowerMeter::set_on_(bool on) {
+  if (on == this->on_)
+    return;
+  this->accumulate_(millis());
+  this->on_ = on;
+  if (this->power_sensor_ != nullptr)
+    this->power_sensor_->publish_state(on ? this->milliwatts_ / 1000.0f : 0.0f);
+}
+
+void VirtualPowerMeter::accumulate_(uint32_t now) {
+  if (this->on_)
+    this->record_.energy += static_cast<uint64_t>(this->milliwatts_) * (now - this->last_accumulate_);
+  this->last_accumulate_ = now;
+}
+
+void VirtualPowerMeter::update_energy_() {
+  const uint32_t now_ms = millis();
+  const ESPTime now = this->time_->now();
+  if (now.is_valid() && now.day_of_year != this->record_.day_of_year) {
+    // Energy from before the clock was set belongs to today; a saved day that has passed, e.g. across a power cut
+    // over midnight, doesn't.
+    if (this->record_.day_of_year != -1) {
+      // Only the time up to midnight belongs to the old day; its last value goes out before the reset.
+      const uint32_t since_midnight = (now.hour * 3600u + now.minute * 60u + now.second) * 1000u;
+      this->accumulate_(now_ms - std::min(now_ms - this->last_accumulate_, since_midnight));
+      if (this->energy_sensor_ != nullptr && this->record_.energy != this->published_energy_)
+        this->publish_energy_();
+      ESP_LOGD(TAG, "New day, resetting daily energy");
+      this->record_.energy = 0;
+    }
+    this->record_.day_of_year = now.day_of_year;
+  }
+  this->accumulate_(now_ms);
+
+  // Nothing to send while the load is off, the daily energy only changes while it is on.
+  if (this->energy_sensor_ == nullptr || this->record_.energy == this->published_energy_)
+    return;
+  this->publish_energy_();
+  if (this->restore_)
+    this->pref_.save(&this->record_);
+}
+
+void VirtualPowerMeter::publish_energy_() {
+  this->published_energy_ = this->record_.energy;
+  this->energy_sensor_->publish_state(static_cast<float>(this->record_.energy / MS_PER_HOUR) / 1000.0f);
+}
+
+}  // namespace esphome::virtual_power_meter
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/core/defines.h"
+#include "esphome/core/preferences.h"
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/components/time/real_time_clock.h"
+#ifdef USE_LIGHT
+#include "esphome/components/light/light_state.h"
+#endif
+#ifdef USE_SWITCH
+#include "esphome/components/switch/switch.h"
+#endif
+
+namespace esphome::virtual_power_meter {
+
+/// Daily energy persisted so a reboot doesn't lose the day so far.
+struct EnergyRecord {
+  uint64_t energy;      ///< mW·ms since midnight.
+  int16_t day_of_year;  ///< Local day `energy` belongs to, -1 if the time wasn't known yet.
+};
+
+/// Reports the power and daily energy of a load with a known, fixed power draw from the on/off state of the switch
+/// or light controlling it. Energy is integrated in integer milliwatts at each transition, so it is exact no matter
+/// how rarely anything is published.
+class VirtualPowerMeter : public Component {
+ public:
+#ifdef USE_SWITCH
+  void set_switch(switch_::Switch *source) { this->switch_ = source; }
+#endif
+#ifdef USE_LIGHT
+  void set_light(light::LightState *source) { this->light_ = source; }
+#endif
+  void set_power(float watts) { this->milliwatts_ = static_cast<uint32_t>(watts * 1000.0f); }
+  void set_power_sensor(sensor::Sensor *power_sensor) { this->power_sensor_ = power_sensor; }
+  void set_energy_sensor(sensor::Sensor *energy_sensor) { this->energy_sensor_ = energy_sensor; }
+  void set_time(time::RealTimeClock *time) { this->time_ = time; }
+  void set_energy_interval(uint32_t energy_interval) { this->energy_interval_ = energy_interval; }
+  void set_restore(bool restore) { this->restore_ = restore; }
+
+  float get_setup_priority() const override { return setup_priority::DATA; }
+  void setup() override;
+  void dump_config() override;
+
+ protected:
+  /// Closes the energy of the previous state and publishes the new power.
+  void set_on_(bool on);
+  /// Folds the energy used from the last call up to `now` (millis()) into energy_.
+  void accumulate_(uint32_t now);
+  /// Publishes and saves the daily energy if it has changed. When the local date has changed, the energy used before
+  /// midnight closes the old day, which is published once more, and the rest starts the new one.
+  void update_energy_();
+  void publish_energy_();
+
+#ifdef USE_SWITCH
+  switch_::Switch *switch_{nullptr};
+#endif
+#ifdef USE_LIGHT
+  light::LightState *light_{nullptr};
+#endif
+  uint32_t milliwatts_{0};  ///< Power drawn while on.
+  sensor::Sensor *power_sensor_{nullptr};
+  sensor::Sensor *energy_sensor_{nullptr};
+  time::RealTimeClock *time_{nullptr};
+  uint32_t energy_interval_{60000};
+  bool restore_{true};
+
+  bool on_{false};
+  uint32_t last_accumulate_{0};
+  EnergyRecord record_{0, -1};
+  uint64_t published_energy_{UINT64_MAX};
+  ESPPreferenceObject pref_;
+};
+
+}  // namespace esphome::virtual_power_meter
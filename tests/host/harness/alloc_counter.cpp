@@ -0,0 +1,52 @@
+#include "host.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <execinfo.h>
+#include <new>
+#include <unistd.h>
+
+// Replaces the global allocation functions so the benchmarks can count heap allocations made by the code under test.
+// With HOST_ALLOC_TRACE set in the environment every allocation counted by a benchmark prints a backtrace to stderr.
+
+namespace {
+std::atomic<uint64_t> allocations{0};
+bool tracing = false;
+
+void trace_allocation() {
+  tracing = false;  // backtrace() may allocate itself the first time.
+  void *frames[32];
+  const int depth = backtrace(frames, 32);
+  write(STDERR_FILENO, "allocation:\n", 12);
+  backtrace_symbols_fd(frames, depth, STDERR_FILENO);
+  tracing = true;
+}
+
+void *counted_alloc(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (tracing)
+    trace_allocation();
+  if (void *ptr = std::malloc(size == 0 ? 1 : size))
+    return ptr;
+  throw std::bad_alloc();
+}
+}  // namespace
+
+uint64_t esphome::host::allocation_count() { return allocations.load(std::memory_order_relaxed); }
+
+void esphome::host::trace_allocations(bool trace) { tracing = trace && std::getenv("HOST_ALLOC_TRACE") != nullptr; }
+
+void *operator new(std::size_t size) { return counted_alloc(size); }
+void *operator new[](std::size_t size) { return counted_alloc(size); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return std::malloc(size == 0 ? 1 : size);
+}
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return std::malloc(size == 0 ? 1 : size);
+}
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
@@ -0,0 +1,333 @@
+#include "econet_bus.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#include "esphome/core/hal.h"
+
+namespace esphome::host {
+
+using econet::EconetDatapoint;
+using econet::EconetDatapointType;
+using econet::host::EconetWrite;
+
+static const std::string EMPTY;
+
+static float hours(uint32_t ms) { return ms / 3600000.0f; }
+
+const EconetDatapoint *EconetDevice::find(const std::string &datapoint_id) const {
+  for (const auto &[id, datapoint] : this->datapoints_) {
+    if (id == datapoint_id)
+      return &datapoint;
+  }
+  return nullptr;
+}
+
+float EconetDevice::get_float(const char *datapoint_id) const {
+  for (const auto &[id, datapoint] : this->datapoints_) {
+    if (id == datapoint_id)
+      return datapoint.value_float;
+  }
+  return NAN;
+}
+
+uint8_t EconetDevice::get_enum(const char *datapoint_id) const {
+  for (const auto &[id, datapoint] : this->datapoints_) {
+    if (id == datapoint_id)
+      return datapoint.value_enum;
+  }
+  return 0;
+}
+
+const std::string &EconetDevice::get_text(const char *datapoint_id) const {
+  for (const auto &[id, datapoint] : this->datapoints_) {
+    if (id == datapoint_id)
+      return datapoint.value_string;
+  }
+  return EMPTY;
+}
+
+void EconetDevice::set_float(const char *datapoint_id, float value) {
+  this->datapoint_(datapoint_id, EconetDatapointType::FLOAT).value_float = value;
+}
+
+void EconetDevice::set_enum(const char *datapoint_id, uint8_t value) {
+  this->datapoint_(datapoint_id, EconetDatapointType::ENUM_TEXT).value_enum = value;
+}
+
+void EconetDevice::set_text(const char *datapoint_id, const char *value) {
+  auto &datapoint = this->datapoint_(datapoint_id, EconetDatapointType::TEXT);
+  if (datapoint.value_string != value)
+    datapoint.value_string = value;
+}
+
+void EconetDevice::write(const EconetWrite &write) {
+  for (auto &[id, datapoint] : this->datapoints_) {
+    if (id != write.datapoint_id)
+      continue;
+    if (datapoint.type == EconetDatapointType::FLOAT) {
+      datapoint.value_float = write.value_float;
+    } else {
+      datapoint.value_enum = write.value_enum;
+    }
+    return;
+  }
+}
+
+EconetDatapoint &EconetDevice::datapoint_(const char *datapoint_id, EconetDatapointType type) {
+  for (auto &[id, datapoint] : this->datapoints_) {
+    if (id == datapoint_id)
+      return datapoint;
+  }
+  EconetDatapoint datapoint;
+  datapoint.type = type;
+  this->datapoints_.emplace_back(datapoint_id, std::move(datapoint));
+  return this->datapoints_.back().second;
+}
+
+ZoneThermostat::ZoneThermostat(uint32_t address) : EconetDevice(address) {
+  this->set_enum("STATMODE", MODE_HEAT);
+  this->set_float("HEATSETP", 68.0f);
+  this->set_float("COOLSETP", 76.0f);
+  this->set_float("RELH7005", 45.0f);
+  this->set_enum("STAT_FAN", FAN_AUTOMATIC);
+  this->set_enum("STATNFAN", FAN_AUTOMATIC);
+  this->set_temperature(70.0f);
+}
+
+void ZoneThermostat::set_temperature(float temperature_f) {
+  this->temperature_ = temperature_f;
+  // Thermostats report to a tenth of a degree.
+  this->set_float("SPT", std::round(temperature_f * 10.0f) / 10.0f);
+}
+
+Furnace::Furnace(uint32_t address) : EconetDevice(address) { this->set_text("HVACMODE", "Off"); }
+
+void Furnace::step(uint32_t ms) {
+  if (this->zones_.empty())
+    return;
+  const uint8_t mode = this->zones_.front()->get_enum("STATMODE");
+  const bool can_heat = mode == ZoneThermostat::MODE_HEAT || mode == ZoneThermostat::MODE_HEAT_COOL;
+  const bool can_cool = mode == ZoneThermostat::MODE_COOL || mode == ZoneThermostat::MODE_HEAT_COOL;
+
+  bool any_cold = false;
+  bool all_warm = true;
+  bool any_hot = false;
+  bool all_cool = true;
+  uint8_t fan = 0;
+  for (const auto *zone : this->zones_) {
+    const float temperature = zone->temperature();
+    any_cold |= temperature < zone->get_float("HEATSETP") - 0.5f;
+    all_warm &= temperature > zone->get_float("HEATSETP") + 0.5f;
+    any_hot |= temperature > zone->get_float("COOLSETP") + 0.5f;
+    all_cool &= temperature < zone->get_float("COOLSETP") - 0.5f;
+    fan = std::max(fan, zone->get_enum("STAT_FAN"));
+  }
+  this->heating_ = can_heat && (this->heating_ ? !all_warm : any_cold);
+  this->cooling_ = can_cool && !this->heating_ && (this->cooling_ ? !all_cool : any_hot);
+  this->blowing_ = mode != ZoneThermostat::MODE_OFF && (fan != ZoneThermostat::FAN_AUTOMATIC ||
+                                                         mode == ZoneThermostat::MODE_FAN_ONLY);
+
+  if (this->heating_) {
+    this->set_text("HVACMODE", "Heat Stage 1");
+  } else if (this->cooling_) {
+    this->set_text("HVACMODE", "Cool Stage 1");
+  } else if (this->blowing_) {
+    this->set_text("HVACMODE", "Fan Only");
+  } else {
+    this->set_text("HVACMODE", "Off");
+  }
+
+  // Heating and cooling run the blower at full speed with every damper open. Otherwise it runs at the fastest speed a
+  // zone asks for and only the zones asking for a fan speed have their dampers open, so only they mix.
+  const float h = hours(ms);
+  const bool all_open = this->heating_ || this->cooling_ || mode == ZoneThermostat::MODE_FAN_ONLY;
+  float mixing = 0.0f;
+  if (this->heating_ || this->cooling_) {
+    mixing = this->mixing_per_h;
+  } else if (this->blowing_) {
+    mixing = this->mixing_per_h * std::max<uint8_t>(fan, 1) / ZoneThermostat::FAN_MAX;
+  }
+  float sum = 0.0f;
+  uint8_t open = 0;
+  for (const auto *zone : this->zones_) {
+    if (all_open || zone->get_enum("STAT_FAN") != ZoneThermostat::FAN_AUTOMATIC) {
+      sum += zone->temperature();
+      open++;
+    }
+  }
+  const float average = open > 0 ? sum / open : 0.0f;
+  for (auto *zone : this->zones_) {
+    float temperature = zone->temperature();
+    temperature += (zone->ambient_f - temperature) * h / zone->time_constant_h;
+    if (this->heating_)
+      temperature += this->heat_rate_f_per_h * zone->gain * h;
+    if (this->cooling_)
+      temperature -= this->cool_rate_f_per_h * zone->gain * h;
+    if (all_open || zone->get_enum("STAT_FAN") != ZoneThermostat::FAN_AUTOMATIC)
+      temperature += (average - temperature) * std::min(mixing * h, 1.0f);
+    zone->set_temperature(temperature);
+  }
+}
+
+HeatPumpWaterHeater::HeatPumpWaterHeater(uint32_t address) : EconetDevice(address) {
+  this->set_float("WHTRSETP", 125.0f);
+  this->set_enum("WHTRCNFG", MODE_HEAT_PUMP);
+  this->set_float("UPHTRTMP", this->upper_);
+  this->set_float("LOHTRTMP", this->lower_);
+}
+
+void HeatPumpWaterHeater::step(uint32_t ms) {
+  const float setpoint = this->get_float("WHTRSETP");
+  const bool on = this->get_enum("WHTRCNFG") != MODE_OFF;
+  this->heating_ = on && (this->heating_ ? this->lower_ < setpoint - 10.0f : this->lower_ < setpoint - 15.0f);
+
+  const float h = hours(ms);
+  const float ambient = 70.0f;
+  this->upper_ -= std::min(this->loss_f_per_h * h, std::max(this->upper_ - ambient, 0.0f));
+  this->lower_ -= std::min(this->loss_f_per_h * h, std::max(this->lower_ - ambient, 0.0f));
+  if (this->draw_left_ > 0) {
+    const uint32_t drawn = std::min(this->draw_left_, ms);
+    this->draw_left_ -= drawn;
+    this->lower_ -= this->draw_f_per_min * drawn / 60000.0f;
+    this->upper_ -= this->draw_f_per_min / 10.0f * drawn / 60000.0f;
+  }
+  if (this->heating_) {
+    this->lower_ += this->heat_rate_f_per_h * h;
+    // The top of the tank warms as the heated water rises, never past the setpoint.
+    this->upper_ = std::min(std::max(this->upper_, this->lower_ + 5.0f), setpoint);
+  }
+  this->set_float("UPHTRTMP", std::round(this->upper_ * 10.0f) / 10.0f);
+  this->set_float("LOHTRTMP", std::round(this->lower_ * 10.0f) / 10.0f);
+}
+
+ZoneThermostat *EconetBus::add_thermostat(uint32_t address) {
+  auto *thermostat = new ZoneThermostat(address);
+  this->devices_.emplace_back(thermostat);
+  this->thermostats_.push_back(thermostat);
+  if (this->furnace_ != nullptr)
+    this->furnace_->add_zone(thermostat);
+  return thermostat;
+}
+
+Furnace *EconetBus::add_furnace(uint32_t address) {
+  auto *furnace = new Furnace(address);
+  this->devices_.emplace_back(furnace);
+  for (auto *thermostat : this->thermostats_)
+    furnace->add_zone(thermostat);
+  this->furnace_ = furnace;
+  return furnace;
+}
+
+HeatPumpWaterHeater *EconetBus::add_water_heater(uint32_t address) {
+  auto *water_heater = new HeatPumpWaterHeater(address);
+  this->devices_.emplace_back(water_heater);
+  return water_heater;
+}
+
+void EconetBus::setup() {
+  this->pending_.reserve(32);
+  this->econet_->set_write_handler([this](const EconetWrite &write) {
+    this->writes_++;
+    this->count_write_(write.datapoint_id);
+    if (this->lost_()) {
+      this->lost_writes_++;
+      return;
+    }
+    this->pending_.push_back({millis() + this->options_.round_trip, -1, write});
+  });
+  this->set_interval("poll", this->options_.poll_interval, [this]() { this->poll_(); });
+  this->set_interval("model", 1000, [this]() {
+    for (auto &device : this->devices_)
+      device->step(1000);
+  });
+}
+
+void EconetBus::loop() {
+  const uint32_t now = millis();
+  // Delivered in the order they were sent; a response can send writes, which are due later.
+  for (size_t i = 0; i < this->pending_.size();) {
+    if (static_cast<int32_t>(now - this->pending_[i].due) < 0) {
+      i++;
+      continue;
+    }
+    const Pending pending = std::move(this->pending_[i]);
+    this->pending_.erase(this->pending_.begin() + i);
+    if (pending.write.datapoint_id.empty()) {
+      this->respond_(pending.request_mod);
+      continue;
+    }
+    for (auto &device : this->devices_) {
+      if (device->get_address() == pending.write.src_adr)
+        device->write(pending.write);
+    }
+  }
+}
+
+void EconetBus::poll_() {
+  // The next request_mod anyone listens to, in turn.
+  int next = INT_MAX;
+  int first = INT_MAX;
+  for (const auto &listener : this->econet_->get_listeners()) {
+    first = std::min<int>(first, listener.request_mod);
+    if (listener.request_mod > this->last_request_mod_)
+      next = std::min<int>(next, listener.request_mod);
+  }
+  if (first == INT_MAX)
+    return;
+  this->last_request_mod_ = next != INT_MAX ? next : first;
+
+  this->reads_++;
+  if (this->lost_()) {
+    this->lost_reads_++;
+    return;
+  }
+  this->pending_.push_back({millis() + this->options_.round_trip, this->last_request_mod_, {}});
+}
+
+void EconetBus::respond_(int8_t request_mod) {
+  // Listeners can write from their callback, so walk by index over the ones present now.
+  const size_t count = this->econet_->get_listeners().size();
+  for (size_t i = 0; i < count; i++) {
+    const auto &listener = this->econet_->get_listeners()[i];
+    if (listener.request_mod != request_mod)
+      continue;
+    const EconetDatapoint *datapoint = this->find_(listener.src_adr, listener.datapoint_id);
+    if (datapoint != nullptr)
+      listener.callback(*datapoint);
+  }
+}
+
+uint32_t EconetBus::get_writes(const std::string &datapoint_id) const {
+  for (const auto &[id, count] : this->writes_by_datapoint_) {
+    if (id == datapoint_id)
+      return count;
+  }
+  return 0;
+}
+
+void EconetBus::count_write_(const std::string &datapoint_id) {
+  for (auto &[id, count] : this->writes_by_datapoint_) {
+    if (id == datapoint_id) {
+      count++;
+      return;
+    }
+  }
+  this->writes_by_datapoint_.emplace_back(datapoint_id, 1);
+}
+
+bool EconetBus::lost_() {
+  return this->options_.packet_loss > 0.0f && this->chance_(this->random_) < this->options_.packet_loss;
+}
+
+const EconetDatapoint *EconetBus::find_(uint32_t address, const std::string &datapoint_id) const {
+  for (const auto &device : this->devices_) {
+    const EconetDatapoint *datapoint = device->get_address() == address ? device->find(datapoint_id) : nullptr;
+    if (datapoint != nullptr)
+      return datapoint;
+  }
+  return nullptr;
+}
+
+}  // namespace esphome::host
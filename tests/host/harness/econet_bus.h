@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "esphome/core/component.h"
+#include "esphome/components/econet/econet.h"
+
+// A simulated EcoNet bus behind the Econet stub: the devices on it answer the datapoints the clients registered
+// listeners for and apply the writes they send, with the delays and losses of a real bus. Datapoints are read one
+// request_mod at a time, in turn, each read answered after a round trip unless the response is lost; a write is
+// applied by its device after a round trip unless it is lost. Nothing is retried, the clients see a lost write when
+// they read the datapoint back.
+//
+// The devices have simple thermal models so the clients' decisions play out: the furnace heats, cools or runs the
+// blower for the zones, and the heat pump water heater keeps its tank in the band below its setpoint. Devices can share
+// an address, e.g. a furnace whose HVACMODE the primary zone's thermostat reports.
+
+namespace esphome::host {
+
+/// Timing and reliability of the simulated bus.
+struct EconetBusOptions {
+  uint32_t poll_interval{1000};  ///< Time between read requests; the request_mods are read in turn.
+  uint32_t round_trip{250};      ///< From a read or write being sent to its response arriving or it being applied.
+  float packet_loss{0.0f};       ///< Chance that a read response or a write is lost.
+  uint32_t seed{1};
+};
+
+/// A device on the bus: an address and the datapoints it reports.
+class EconetDevice {
+ public:
+  explicit EconetDevice(uint32_t address) : address_(address) {}
+  virtual ~EconetDevice() = default;
+
+  uint32_t get_address() const { return this->address_; }
+  /// The datapoint, or nullptr if the device doesn't have it.
+  const econet::EconetDatapoint *find(const std::string &datapoint_id) const;
+  float get_float(const char *datapoint_id) const;
+  uint8_t get_enum(const char *datapoint_id) const;
+  const std::string &get_text(const char *datapoint_id) const;
+  void set_float(const char *datapoint_id, float value);
+  void set_enum(const char *datapoint_id, uint8_t value);
+  void set_text(const char *datapoint_id, const char *value);
+
+  /// Applies a write that reached the device. Writes to datapoints the device doesn't have are ignored.
+  virtual void write(const econet::host::EconetWrite &write);
+  /// Advances the device's model by `ms`.
+  virtual void step(uint32_t ms) {}
+
+ protected:
+  econet::EconetDatapoint &datapoint_(const char *datapoint_id, econet::EconetDatapointType type);
+
+  uint32_t address_;
+  std::vector<std::pair<std::string, econet::EconetDatapoint>> datapoints_;
+};
+
+/// A zone thermostat: mode, heat and cool setpoints, room temperature (SPT, to 0.1°F), humidity and fan modes. The
+/// room drifts towards its ambient temperature and is heated, cooled or mixed with the other zones by the furnace.
+class ZoneThermostat : public EconetDevice {
+ public:
+  // STATMODE values, as configured in hvac.yaml.
+  static constexpr uint8_t MODE_HEAT = 0;
+  static constexpr uint8_t MODE_COOL = 1;
+  static constexpr uint8_t MODE_HEAT_COOL = 2;
+  static constexpr uint8_t MODE_FAN_ONLY = 3;
+  static constexpr uint8_t MODE_OFF = 4;
+  static constexpr uint8_t FAN_AUTOMATIC = 0;
+  static constexpr uint8_t FAN_MAX = 5;
+
+  explicit ZoneThermostat(uint32_t address);
+
+  float temperature() const { return this->temperature_; }
+  void set_temperature(float temperature_f);
+
+  float ambient_f{60.0f};      ///< What the room settles at with no heating or cooling.
+  float time_constant_h{8.0f};  ///< Time constant of the drift towards ambient.
+  float gain{1.0f};             ///< Share of the furnace's heating or cooling rate this zone gets.
+
+ protected:
+  float temperature_{70.0f};
+};
+
+/// The furnace and its blower. It runs for the primary zone's mode: heating while a zone is more than half a degree
+/// under its heat setpoint until every zone is half a degree over, the same for cooling, otherwise the blower while
+/// any zone asks for a fan speed. The blower mixes the zones whose dampers are open: every zone while heating or
+/// cooling, otherwise the zones asking for a fan speed. HVACMODE reports what it is doing.
+class Furnace : public EconetDevice {
+ public:
+  explicit Furnace(uint32_t address);
+
+  /// The zones it serves; the first one is the primary.
+  void add_zone(ZoneThermostat *zone) { this->zones_.push_back(zone); }
+  void step(uint32_t ms) override;
+
+  bool is_heating() const { return this->heating_; }
+  bool is_cooling() const { return this->cooling_; }
+  bool is_blowing() const { return this->blowing_; }
+
+  float heat_rate_f_per_h{4.0f};
+  float cool_rate_f_per_h{3.0f};
+  float mixing_per_h{2.0f};  ///< How fast the blower evens the open zones out at full speed.
+
+ protected:
+  std::vector<ZoneThermostat *> zones_;
+  bool heating_{false};
+  bool cooling_{false};
+  bool blowing_{false};
+};
+
+/// A heat pump water heater: setpoint (WHTRSETP), mode (WHTRCNFG, 0 is off) and the upper and lower tank
+/// temperatures (UPHTRTMP, LOHTRTMP). While on it heats once the lower tank is 15°F under the setpoint, until it is
+/// 10°F under.
+class HeatPumpWaterHeater : public EconetDevice {
+ public:
+  static constexpr uint8_t MODE_OFF = 0;
+  static constexpr uint8_t MODE_ECO = 1;
+  static constexpr uint8_t MODE_HEAT_PUMP = 2;
+  static constexpr uint8_t MODE_HIGH_DEMAND = 3;
+  static constexpr uint8_t MODE_ELECTRIC = 4;
+
+  explicit HeatPumpWaterHeater(uint32_t address);
+
+  void step(uint32_t ms) override;
+  /// Hot water is drawn for `ms`.
+  void draw(uint32_t ms) { this->draw_left_ += ms; }
+  bool is_heating() const { return this->heating_; }
+
+  float heat_rate_f_per_h{30.0f};
+  float loss_f_per_h{1.0f};
+  float draw_f_per_min{3.0f};  ///< How fast a draw cools the lower tank; the upper tank cools a tenth as fast.
+
+ protected:
+  float upper_{120.0f};
+  float lower_{115.0f};
+  bool heating_{false};
+  uint32_t draw_left_{0};
+};
+
+class EconetBus : public Component {
+ public:
+  explicit EconetBus(econet::Econet *econet, EconetBusOptions options = {})
+      : econet_(econet), options_(options), random_(options.seed) {}
+
+  ZoneThermostat *add_thermostat(uint32_t address);
+  /// Serves the thermostats added so far and any added later.
+  Furnace *add_furnace(uint32_t address);
+  HeatPumpWaterHeater *add_water_heater(uint32_t address);
+
+  void setup() override;
+  void loop() override;
+
+  EconetBusOptions &options() { return this->options_; }
+  uint32_t get_reads() const { return this->reads_; }
+  uint32_t get_lost_reads() const { return this->lost_reads_; }
+  uint32_t get_writes() const { return this->writes_; }
+  uint32_t get_lost_writes() const { return this->lost_writes_; }
+  /// Writes sent to `datapoint_id`, lost or not.
+  uint32_t get_writes(const std::string &datapoint_id) const;
+
+ protected:
+  struct Pending {
+    uint32_t due;
+    int8_t request_mod;  ///< The read being answered, if `write` is empty.
+    econet::host::EconetWrite write;
+  };
+
+  void poll_();
+  void respond_(int8_t request_mod);
+  bool lost_();
+  void count_write_(const std::string &datapoint_id);
+  const econet::EconetDatapoint *find_(uint32_t address, const std::string &datapoint_id) const;
+
+  econet::Econet *econet_;
+  EconetBusOptions options_;
+  std::mt19937 random_;
+  std::uniform_real_distribution<float> chance_{0.0f, 1.0f};
+  std::vector<std::unique_ptr<EconetDevice>> devices_;
+  std::vector<ZoneThermostat *> thermostats_;
+  Furnace *furnace_{nullptr};
+  std::vector<Pending> pending_;
+  int8_t last_request_mod_{-1};
+  uint32_t reads_{0};
+  uint32_t lost_reads_{0};
+  uint32_t writes_{0};
+  uint32_t lost_writes_{0};
+  std::vector<std::pair<std::string, uint32_t>> writes_by_datapoint_;
+};
+
+}  // namespace esphome::host
@@ -0,0 +1,69 @@
+#include "host.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <typeinfo>
+
+#include "esphome/components/api/custom_api_device.h"
+
+namespace esphome::host {
+
+void start_scenario() {
+  App.reset();
+  preferences().reset();
+  preferences().clear_stats();
+  reset_clock();
+  api::host::services().clear();
+}
+
+void end_scenario() { start_scenario(); }
+
+void restart(bool power_loss) {
+  App.reset();
+  preferences().restart(power_loss);
+  reset_clock();
+  api::host::services().clear();
+}
+
+static std::string component_name(const Component *component) {
+  int status = 0;
+  char *demangled = abi::__cxa_demangle(typeid(*component).name(), nullptr, nullptr, &status);
+  std::string name = status == 0 ? demangled : typeid(*component).name();
+  std::free(demangled);
+  return name;
+}
+
+void Bench::run(uint32_t ms) {
+  App.clear_stats();
+  preferences().clear_stats();
+  const uint64_t allocations_before = allocation_count();
+  trace_allocations(true);
+  App.run_for(ms);
+  trace_allocations(false);
+  this->allocations_ = allocation_count() - allocations_before;
+  this->loops_ = App.get_loop_count();
+  this->flash_writes_ = preferences().get_stats().flash_writes;
+  this->saves_ = preferences().get_stats().saves;
+
+  std::printf("\n== %s: %.1f h simulated, %" PRIu64 " loops ==\n", this->name_.c_str(), ms / 3600000.0, this->loops_);
+  for (const Component *component : App.get_components()) {
+    const ComponentStats &stats = App.get_stats(component);
+    if (stats.loop_calls == 0 && stats.scheduler_calls == 0 && stats.setup_allocations == 0)
+      continue;
+    std::printf("  %-48s loop: %10" PRIu64 " calls %8.1f ns/call   scheduler: %8" PRIu64 " runs %8.1f ns/run"
+                "   allocations: setup %4" PRIu64 " loop %6" PRIu64 " scheduler %6" PRIu64 "\n",
+                component_name(component).c_str(), stats.loop_calls,
+                stats.loop_calls ? static_cast<double>(stats.loop_ns) / stats.loop_calls : 0.0,
+                stats.scheduler_calls,
+                stats.scheduler_calls ? static_cast<double>(stats.scheduler_ns) / stats.scheduler_calls : 0.0,
+                stats.setup_allocations, stats.loop_allocations, stats.scheduler_allocations);
+  }
+  std::printf("  allocations: %" PRIu64 " (%.4f per loop)   preference saves: %" PRIu32 "   flash writes: %" PRIu32
+              "\n",
+              this->allocations_, this->loops_ ? static_cast<double>(this->allocations_) / this->loops_ : 0.0,
+              this->saves_, this->flash_writes_);
+}
+
+}  // namespace esphome::host
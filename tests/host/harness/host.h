@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "esphome/core/application.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/preferences.h"
+#include "esphome/components/output/binary_output.h"
+#include "esphome/components/switch/switch.h"
+
+// Helpers shared by the scenarios: resetting the simulated device, restarting it, fakes for the hardware the
+// components drive and the benchmark report.
+
+namespace esphome::host {
+
+/// Back to a freshly flashed device: no components, empty preferences, clock at 0. Run before and after every test.
+void start_scenario();
+void end_scenario();
+
+/// Simulates a restart. The components registered so far are forgotten (the scenario creates new ones, as the new
+/// firmware run would), the clock goes back to 0 and preferences saved since the last sync are lost, as is RTC memory
+/// on a power loss. Call App.run_safe_shutdown_hooks() first for a restart the device chose, e.g. an OTA.
+void restart(bool power_loss = false);
+
+/// Heap allocations (operator new) since the program started.
+uint64_t allocation_count();
+/// Prints a backtrace for every allocation while on, if HOST_ALLOC_TRACE is set. Bench::run() turns it on.
+void trace_allocations(bool trace);
+
+/// A binary output that records every level written to it with the time.
+class RecordingOutput : public output::BinaryOutput {
+ public:
+  bool state() const { return this->state_; }
+  /// Benchmarks turn the recording off so its growth doesn't count as an allocation of the component.
+  void set_recording(bool recording) { this->recording_ = recording; }
+  /// (millis(), level) for every write, including writes of an unchanged level.
+  const std::vector<std::pair<uint32_t, bool>> &get_writes() const { return this->writes_; }
+  /// Writes that changed the level.
+  uint32_t get_transitions() const { return this->transitions_; }
+  void clear() {
+    this->writes_.clear();
+    this->transitions_ = 0;
+  }
+
+ protected:
+  void write_state(bool state) override {
+    if (this->recording_)
+      this->writes_.emplace_back(millis(), state);
+    if (state != this->state_)
+      this->transitions_++;
+    this->state_ = state;
+  }
+
+  bool state_{false};
+  bool recording_{true};
+  std::vector<std::pair<uint32_t, bool>> writes_;
+  uint32_t transitions_{0};
+};
+
+/// A switch that simply takes on whatever state it is asked for, like an optimistic template switch.
+class TemplateSwitch : public switch_::Switch {
+ protected:
+  void write_state(bool state) override { this->publish_state(state); }
+};
+
+/// Measures the components registered with App over a stretch of simulated time and prints where the time and the
+/// allocations went.
+class Bench {
+ public:
+  explicit Bench(std::string name) : name_(std::move(name)) {}
+
+  /// Runs App for `ms` of simulated time with fresh counters, then prints the report.
+  void run(uint32_t ms);
+
+  uint64_t get_loops() const { return this->loops_; }
+  uint64_t get_allocations() const { return this->allocations_; }
+  uint32_t get_flash_writes() const { return this->flash_writes_; }
+  uint32_t get_preference_saves() const { return this->saves_; }
+
+ protected:
+  std::string name_;
+  uint64_t loops_{0};
+  uint64_t allocations_{0};
+  uint32_t flash_writes_{0};
+  uint32_t saves_{0};
+};
+
+}  // namespace esphome::host
@@ -0,0 +1,72 @@
+#include "host_test.h"
+#include "host.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace esphome::host::test {
+
+namespace {
+
+struct TestCase {
+  const char *name;
+  TestFunction function;
+  bool is_benchmark;
+};
+
+std::vector<TestCase> &registry() {
+  static std::vector<TestCase> tests;
+  return tests;
+}
+
+uint32_t failures = 0;
+
+}  // namespace
+
+Registrar::Registrar(const char *name, TestFunction function, bool is_benchmark) {
+  registry().push_back({name, function, is_benchmark});
+}
+
+void report_failure(const char *file, int line, const std::string &message) {
+  failures++;
+  std::fprintf(stderr, "%s:%d: %s\n", file, line, message.c_str());
+}
+
+}  // namespace esphome::host::test
+
+int main(int argc, char **argv) {
+  using namespace esphome::host;
+  bool bench = false;
+  const char *filter = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--bench") == 0) {
+      bench = true;
+    } else {
+      filter = argv[i];
+    }
+  }
+
+  uint32_t run = 0;
+  uint32_t failed = 0;
+  for (const auto &test : test::registry()) {
+    if (test.is_benchmark != bench)
+      continue;
+    if (filter != nullptr && std::strstr(test.name, filter) == nullptr)
+      continue;
+    run++;
+    const uint32_t failures_before = test::failures;
+    start_scenario();
+    try {
+      test.function();
+    } catch (const test::Abort &) {
+    }
+    end_scenario();
+    const bool passed = test::failures == failures_before;
+    if (!passed)
+      failed++;
+    std::printf("[%s] %s\n", passed ? "PASS" : "FAIL", test.name);
+  }
+  std::printf("%u %s, %u failed\n", run, bench ? "benchmark(s)" : "test(s)", failed);
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+// A deliberately small test runner for the host scenarios: no framework to fetch, and the scenarios read like the
+// components they exercise. TEST_CASE bodies always run; BENCHMARK bodies run with --bench (the `bench` target and
+// the *_bench tests) and print their report.
+
+namespace esphome::host::test {
+
+using TestFunction = void (*)();
+
+struct Registrar {
+  Registrar(const char *name, TestFunction function, bool is_benchmark);
+};
+
+/// Thrown by REQUIRE to end the running test.
+struct Abort {};
+
+void report_failure(const char *file, int line, const std::string &message);
+
+template<typename T> std::string describe(const T &value) {
+  if constexpr (requires(std::ostream &os) { os << value; }) {
+    std::ostringstream os;
+    if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, int8_t>) {
+      os << static_cast<int>(value);
+    } else {
+      os << value;
+    }
+    return os.str();
+  } else if constexpr (std::is_enum_v<T>) {
+    return std::to_string(static_cast<long long>(value));
+  } else {
+    return "?";
+  }
+}
+
+template<typename A, typename B>
+void check_eq(const A &actual, const B &expected, const char *actual_expr, const char *expected_expr, const char *file,
+              int line) {
+  if (actual == expected)
+    return;
+  report_failure(file, line,
+                 std::string("CHECK_EQ(") + actual_expr + ", " + expected_expr + "): " + describe(actual) +
+                     " != " + describe(expected));
+}
+
+inline void check_near(double actual, double expected, double tolerance, const char *actual_expr,
+                       const char *expected_expr, const char *file, int line) {
+  if (std::abs(actual - expected) <= tolerance)
+    return;
+  report_failure(file, line,
+                 std::string("CHECK_NEAR(") + actual_expr + ", " + expected_expr + "): " + describe(actual) +
+                     " not within " + describe(tolerance) + " of " + describe(expected));
+}
+
+}  // namespace esphome::host::test
+
+#define HOST_TEST_REGISTER_(name, is_benchmark) \
+  static void name(); \
+  static const esphome::host::test::Registrar name##_registrar_(#name, &name, is_benchmark); \
+  static void name()
+
+#define TEST_CASE(name) HOST_TEST_REGISTER_(name, false)
+#define BENCHMARK(name) HOST_TEST_REGISTER_(name, true)
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) \
+      esphome::host::test::report_failure(__FILE__, __LINE__, "CHECK(" #cond ")"); \
+  } while (0)
+
+#define REQUIRE(cond) \
+  do { \
+    if (!(cond)) { \
+      esphome::host::test::report_failure(__FILE__, __LINE__, "REQUIRE(" #cond ")"); \
+      throw esphome::host::test::Abort{}; \
+    } \
+  } while (0)
+
+#define CHECK_EQ(actual, expected) \
+  esphome::host::test::check_eq((actual), (expected), #actual, #expected, __FILE__, __LINE__)
+#define CHECK_NEAR(actual, expected, tolerance) \
+  esphome::host::test::check_near((actual), (expected), (tolerance), #actual, #expected, __FILE__, __LINE__)
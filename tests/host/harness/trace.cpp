@@ -0,0 +1,102 @@
+#include "trace.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace esphome::host {
+
+static bool parse_time(const std::string &text, uint32_t &ms) {
+  uint32_t seconds = 0;
+  uint32_t field = 0;
+  bool digits = false;
+  for (char c : text) {
+    if (c >= '0' && c <= '9') {
+      field = field * 10 + (c - '0');
+      digits = true;
+    } else if (c == ':' && digits) {
+      seconds = (seconds + field) * 60;
+      field = 0;
+      digits = false;
+    } else {
+      return false;
+    }
+  }
+  ms = (seconds + field) * 1000;
+  return digits;
+}
+
+bool Trace::load(const std::string &path) {
+  std::ifstream file(path);
+  if (!file) {
+    std::fprintf(stderr, "%s: can't be opened\n", path.c_str());
+    return false;
+  }
+  this->columns_.clear();
+  this->rows_.clear();
+
+  std::string line;
+  bool header = true;
+  for (int number = 1; std::getline(file, line); number++) {
+    const size_t start = line.find_first_not_of(" \t\r");
+    if (start == std::string::npos || line[start] == '#')
+      continue;
+    std::istringstream fields(line);
+    std::string time;
+    fields >> time;
+
+    if (header) {
+      // The first column is the time, the last one the label.
+      std::string name;
+      while (fields >> name)
+        this->columns_.push_back(name);
+      if (this->columns_.size() < 2) {
+        std::fprintf(stderr, "%s:%d: expected a time, value columns and a label\n", path.c_str(), number);
+        return false;
+      }
+      this->columns_.pop_back();
+      header = false;
+      continue;
+    }
+
+    Row row{};
+    if (!parse_time(time, row.ms)) {
+      std::fprintf(stderr, "%s:%d: '%s' isn't a time\n", path.c_str(), number, time.c_str());
+      return false;
+    }
+    for (size_t i = 0; i < this->columns_.size(); i++) {
+      float value;
+      if (!(fields >> value)) {
+        std::fprintf(stderr, "%s:%d: expected %zu values\n", path.c_str(), number, this->columns_.size());
+        return false;
+      }
+      row.values.push_back(value);
+    }
+    std::getline(fields >> std::ws, row.label);
+    while (!row.label.empty() && (row.label.back() == '\r' || row.label.back() == ' '))
+      row.label.pop_back();
+    if (!this->rows_.empty() && row.ms < this->rows_.back().ms) {
+      std::fprintf(stderr, "%s:%d: rows have to be in time order\n", path.c_str(), number);
+      return false;
+    }
+    this->rows_.push_back(std::move(row));
+  }
+  if (this->rows_.empty()) {
+    std::fprintf(stderr, "%s: no rows\n", path.c_str());
+    return false;
+  }
+  return true;
+}
+
+void Trace::add(uint32_t ms, std::vector<float> values, std::string label) {
+  this->rows_.push_back({ms, std::move(values), std::move(label)});
+}
+
+const Trace::Row &Trace::row_at(uint32_t ms) const {
+  auto after = std::upper_bound(this->rows_.begin(), this->rows_.end(), ms,
+                                [](uint32_t time, const Row &row) { return time < row.ms; });
+  return after == this->rows_.begin() ? *after : *(after - 1);
+}
+
+}  // namespace esphome::host
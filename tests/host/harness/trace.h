@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Recorded or synthetic input for a scenario: a value per column that holds from the time of its row until the next
+// row, and a label per row, e.g. what a person watching would say the state is. Traces are read from text files
+//
+//   # comments and blank lines are skipped
+//   time     Alice  Bob   expected
+//   0:00:00  1012   1009  Empty
+//   0:12:00  180    1009  Alice
+//   0:25:00  185    210   Alice and Bob
+//
+// where the first line names the columns, times are seconds or h:mm:ss and the label is the rest of the line, or
+// built in code with add().
+
+namespace esphome::host {
+
+class Trace {
+ public:
+  struct Row {
+    uint32_t ms;
+    std::vector<float> values;
+    std::string label;
+  };
+
+  Trace() = default;
+  explicit Trace(std::vector<std::string> columns) : columns_(std::move(columns)) {}
+
+  /// Replaces the trace with the one in `path`. Prints what is wrong with the file and returns false if it can't be
+  /// read.
+  bool load(const std::string &path);
+  /// Appends a row; rows have to be added in time order.
+  void add(uint32_t ms, std::vector<float> values, std::string label);
+
+  const std::vector<std::string> &get_columns() const { return this->columns_; }
+  const std::vector<Row> &get_rows() const { return this->rows_; }
+  /// Time of the last row.
+  uint32_t get_duration() const { return this->rows_.empty() ? 0 : this->rows_.back().ms; }
+
+  /// The value of `column` at `ms`: the one of the last row at or before it, or of the first row before that.
+  float value_at(size_t column, uint32_t ms) const { return this->row_at(ms).values[column]; }
+  const std::string &label_at(uint32_t ms) const { return this->row_at(ms).label; }
+
+ protected:
+  const Row &row_at(uint32_t ms) const;
+
+  std::vector<std::string> columns_;
+  std::vector<Row> rows_;
+};
+
+}  // namespace esphome::host
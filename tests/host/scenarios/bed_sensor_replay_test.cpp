@@ -0,0 +1,404 @@
+#include "host.h"
+#include "host_test.h"
+#include "trace.h"
+
+#include "esphome/components/bed_sensor/bed_sensor.h"
+
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+// Replays pad traces through BedSensor: the ADC reads the trace value of whichever zone is powered, and every
+// occupancy, count and status change published is compared with the state the trace's labels call for. The
+// benchmark prints how quickly and how cleanly each polling and filtering setup follows a night, so a change to the
+// thresholds, the filtering or the polling can be judged against the same nights. BED_SENSOR_TRACE=<file> replays a
+// recorded night instead of the synthetic one.
+
+using namespace esphome;
+
+namespace {
+
+constexpr uint32_t NIGHT = 8 * 60 * 60 * 1000;
+
+std::string trace_path(const char *name) { return std::string(HOST_TRACE_DIR) + "/bed_sensor/" + name; }
+
+std::string clock_time(uint32_t ms) {
+  char text[24];
+  std::snprintf(text, sizeof(text), "%" PRIu32 ":%02" PRIu32 ":%04.1f", ms / 3600000, ms / 60000 % 60,
+                ms % 60000 / 1000.0);
+  return text;
+}
+
+/// How the pads are read.
+struct ReplayOptions {
+  uint32_t update_interval{2000};
+  uint32_t min_interval{0};  ///< Adaptive polling between min_interval and max_interval when max_interval is set.
+  uint32_t max_interval{0};
+  float noise{0.0f};         ///< Every sample is off by up to this many counts.
+  float spike_chance{0.0f};  ///< Chance that a sample reads 0 or full scale instead, e.g. from a loose connector.
+  uint32_t seed{1};
+};
+
+template<typename T> using Timeline = std::vector<std::pair<uint32_t, T>>;
+
+/// The first difference between what was published and what was expected, or "" if every expected change was
+/// published, in order, within `max_latency` ms of it happening and nothing else was published.
+template<typename T>
+std::string compare_timeline(const char *name, const Timeline<T> &published, const Timeline<T> &expected,
+                             uint32_t max_latency) {
+  using host::test::describe;
+  for (size_t i = 0; i < std::max(published.size(), expected.size()); i++) {
+    if (i >= published.size()) {
+      return std::string(name) + ": " + describe(expected[i].second) + " from " + clock_time(expected[i].first) +
+             " was never published";
+    }
+    if (i >= expected.size() || published[i].second != expected[i].second) {
+      return std::string(name) + ": " + describe(published[i].second) + " published at " +
+             clock_time(published[i].first) + " wasn't expected";
+    }
+    if (published[i].first < expected[i].first || published[i].first - expected[i].first > max_latency) {
+      return std::string(name) + ": " + describe(expected[i].second) + " from " + clock_time(expected[i].first) +
+             " was published at " + clock_time(published[i].first);
+    }
+  }
+  return "";
+}
+
+/// How a replay followed the trace.
+struct ReplayReport {
+  uint32_t duration{0};
+  uint32_t polls{0};
+  uint32_t expected_changes{0};
+  uint32_t detected{0};  ///< Expected status changes published before the next one happened.
+  uint32_t max_latency_ms{0};
+  uint32_t max_latency_polls{0};
+  double mean_latency_ms{0.0};
+  double mean_latency_polls{0.0};
+  uint32_t false_transitions{0};  ///< Status changes published that weren't the detection of an expected change.
+  uint32_t status_publishes{0};
+  uint32_t count_publishes{0};
+  uint32_t occupancy_publishes{0};
+  uint32_t zone_publishes{0};
+  uint32_t someone_publishes{0};
+  uint32_t value_publishes{0};
+
+  double false_transitions_per_night() const {
+    return this->duration ? static_cast<double>(this->false_transitions) * NIGHT / this->duration : 0.0;
+  }
+};
+
+/// A bed with one zone per trace column, read from the trace.
+class Replay {
+ public:
+  static constexpr float FULL_SCALE = 1024.0f;
+
+  explicit Replay(const host::Trace &trace, ReplayOptions options = {})
+      : trace_(trace), options_(options), random_(options.seed) {
+    this->zone_count_ = std::min<size_t>(trace.get_columns().size(), bed_sensor::MAX_ZONES);
+    this->adc_.set_sampler([this]() { return this->sample_(); });
+    this->bed_.set_adc_sensor(&this->adc_);
+    for (size_t i = 0; i < this->zone_count_; i++) {
+      this->bed_.add_zone(trace.get_columns()[i].c_str(), &this->outputs_[i], &this->values_[i], &this->zones_[i]);
+      this->values_[i].add_on_state_callback([this](float) { this->report_.value_publishes++; });
+      this->zones_[i].add_on_state_callback([this](bool) { this->report_.zone_publishes++; });
+    }
+    this->bed_.set_someone_sensor(&this->someone_);
+    this->bed_.set_someone_name(SOMEONE);
+    this->bed_.set_count_sensor(&this->count_);
+    this->bed_.set_occupancy_sensor(&this->occupancy_);
+    this->bed_.set_status_sensor(&this->status_);
+    this->bed_.set_update_interval(options.update_interval);
+    if (options.max_interval != 0)
+      this->bed_.set_adaptive_update_interval(options.min_interval, options.max_interval);
+
+    this->someone_.add_on_state_callback([this](bool) { this->report_.someone_publishes++; });
+    this->count_.add_on_state_callback([this](float count) {
+      this->report_.count_publishes++;
+      this->count_timeline.emplace_back(millis(), count);
+    });
+    this->occupancy_.add_on_state_callback([this](float occupancy) {
+      this->report_.occupancy_publishes++;
+      this->occupancy_timeline.emplace_back(millis(), occupancy);
+    });
+    this->status_.add_on_state_callback([this](const std::string &status) {
+      this->report_.status_publishes++;
+      this->status_timeline.emplace_back(millis(), status);
+    });
+
+    // What the labels call for. Count and occupancy only change when the status changes them.
+    for (const auto &row : trace.get_rows()) {
+      const auto [occupancy, count] = this->decode_(row.label);
+      if (this->expected_status_.empty() || this->expected_status_.back().second != row.label)
+        this->expected_status_.emplace_back(row.ms, row.label);
+      if (this->expected_count_.empty() || this->expected_count_.back().second != count)
+        this->expected_count_.emplace_back(row.ms, count);
+      if (this->expected_occupancy_.empty() || this->expected_occupancy_.back().second != occupancy)
+        this->expected_occupancy_.emplace_back(row.ms, occupancy);
+    }
+
+    App.register_component(&this->bed_);
+    App.setup();
+  }
+
+  /// Replays the whole trace, and half a minute past its end for the last change to be read.
+  void run() { App.run_for(this->trace_.get_duration() + 30 * 1000); }
+
+  std::string compare_status(uint32_t max_latency) const {
+    return compare_timeline("status", this->status_timeline, this->expected_status_, max_latency);
+  }
+  std::string compare_count(uint32_t max_latency) const {
+    return compare_timeline("count", this->count_timeline, this->expected_count_, max_latency);
+  }
+  std::string compare_occupancy(uint32_t max_latency) const {
+    return compare_timeline("occupancy", this->occupancy_timeline, this->expected_occupancy_, max_latency);
+  }
+
+  ReplayReport report() const {
+    ReplayReport report = this->report_;
+    report.duration = this->trace_.get_duration();
+
+    // A poll powers the zone it reads.
+    std::vector<uint32_t> polls;
+    for (size_t i = 0; i < this->zone_count_; i++) {
+      for (const auto &[ms, state] : this->outputs_[i].get_writes()) {
+        if (state)
+          polls.push_back(ms);
+      }
+    }
+    std::sort(polls.begin(), polls.end());
+    report.polls = polls.size();
+
+    // An expected change is detected by the first publish of its status before the next change happens.
+    report.expected_changes = this->expected_status_.size();
+    uint64_t latency_ms = 0;
+    uint64_t latency_polls = 0;
+    size_t published = 0;
+    for (size_t i = 0; i < this->expected_status_.size(); i++) {
+      const auto &[from, status] = this->expected_status_[i];
+      const uint32_t until = i + 1 < this->expected_status_.size() ? this->expected_status_[i + 1].first : UINT32_MAX;
+      while (published < this->status_timeline.size() && this->status_timeline[published].first < from)
+        published++;
+      for (; published < this->status_timeline.size() && this->status_timeline[published].first < until;
+           published++) {
+        if (this->status_timeline[published].second != status)
+          continue;
+        const uint32_t at = this->status_timeline[published].first;
+        const uint32_t ms = at - from;
+        const uint32_t polls_taken = std::upper_bound(polls.begin(), polls.end(), at) -
+                                     std::upper_bound(polls.begin(), polls.end(), from);
+        report.detected++;
+        latency_ms += ms;
+        latency_polls += polls_taken;
+        report.max_latency_ms = std::max(report.max_latency_ms, ms);
+        report.max_latency_polls = std::max(report.max_latency_polls, polls_taken);
+        published++;
+        break;
+      }
+    }
+    if (report.detected != 0) {
+      report.mean_latency_ms = static_cast<double>(latency_ms) / report.detected;
+      report.mean_latency_polls = static_cast<double>(latency_polls) / report.detected;
+    }
+    report.false_transitions = this->status_timeline.size() - report.detected;
+    return report;
+  }
+
+  void print_report(const std::string &name) const {
+    const ReplayReport report = this->report();
+    std::printf("\n== %s: %.1f h ==\n", name.c_str(), report.duration / 3600000.0);
+    std::printf("  polls: %" PRIu32 "   status changes detected: %" PRIu32 "/%" PRIu32 "\n", report.polls,
+                report.detected, report.expected_changes);
+    std::printf("  latency: mean %.1f s (%.1f polls), max %.1f s (%" PRIu32 " polls)\n",
+                report.mean_latency_ms / 1000.0, report.mean_latency_polls, report.max_latency_ms / 1000.0,
+                report.max_latency_polls);
+    std::printf("  false transitions: %" PRIu32 " (%.1f per night)\n", report.false_transitions,
+                report.false_transitions_per_night());
+    std::printf("  publishes: status %" PRIu32 "  count %" PRIu32 "  occupancy %" PRIu32 "  zones %" PRIu32
+                "  someone %" PRIu32 "  values %" PRIu32 "\n",
+                report.status_publishes, report.count_publishes, report.occupancy_publishes, report.zone_publishes,
+                report.someone_publishes, report.value_publishes);
+  }
+
+  Timeline<std::string> status_timeline;
+  Timeline<float> count_timeline;
+  Timeline<float> occupancy_timeline;
+
+ protected:
+  static constexpr const char *SOMEONE = "Someone";
+
+  float sample_() {
+    int powered = -1;
+    for (size_t i = 0; i < this->zone_count_; i++) {
+      if (this->outputs_[i].state())
+        powered = i;
+    }
+    if (powered == -1)
+      return FULL_SCALE;
+    if (this->options_.spike_chance > 0.0f && this->chance_(this->random_) < this->options_.spike_chance)
+      return this->chance_(this->random_) < 0.5f ? 0.0f : FULL_SCALE - 1.0f;
+    float value = this->trace_.value_at(powered, millis());
+    if (this->options_.noise > 0.0f)
+      value += (this->chance_(this->random_) * 2.0f - 1.0f) * this->options_.noise;
+    return std::clamp(value, 0.0f, FULL_SCALE - 1.0f);
+  }
+
+  /// The occupancy bitmask and count of a status text: "Empty", the someone name or zone names joined by ", " and
+  /// " and ".
+  std::pair<float, float> decode_(const std::string &status) const {
+    if (status == SOMEONE)
+      return {0.0f, 1.0f};
+    uint32_t occupancy = 0;
+    for (size_t i = 0; i < this->zone_count_; i++) {
+      const std::string &name = this->trace_.get_columns()[i];
+      for (size_t at = status.find(name); at != std::string::npos; at = status.find(name, at + 1)) {
+        const size_t end = at + name.size();
+        if ((at == 0 || status[at - 1] == ' ') && (end == status.size() || status[end] == ',' || status[end] == ' '))
+          occupancy |= 1u << i;
+      }
+    }
+    return {static_cast<float>(occupancy), static_cast<float>(__builtin_popcount(occupancy))};
+  }
+
+  const host::Trace &trace_;
+  ReplayOptions options_;
+  std::minstd_rand random_;
+  std::uniform_real_distribution<float> chance_{0.0f, 1.0f};
+  size_t zone_count_{0};
+
+  adc::ADCSensor adc_;
+  std::array<host::RecordingOutput, bed_sensor::MAX_ZONES> outputs_;
+  std::array<sensor::Sensor, bed_sensor::MAX_ZONES> values_;
+  std::array<binary_sensor::BinarySensor, bed_sensor::MAX_ZONES> zones_;
+  binary_sensor::BinarySensor someone_;
+  sensor::Sensor count_;
+  sensor::Sensor occupancy_;
+  text_sensor::TextSensor status_;
+  bed_sensor::BedSensor bed_;
+
+  Timeline<std::string> expected_status_;
+  Timeline<float> expected_count_;
+  Timeline<float> expected_occupancy_;
+  ReplayReport report_;
+};
+
+// With 2 s polling each of the two zones is read every 4 s, plus the settle time.
+constexpr uint32_t FIXED_LATENCY = 4100;
+// With adaptive polling a quiet two zone bed is polled every 5 s, so each zone is read at least every 10 s.
+constexpr uint32_t ADAPTIVE_LATENCY = 10100;
+constexpr ReplayOptions ADAPTIVE{.min_interval = 1000, .max_interval = 10000};
+
+}  // namespace
+
+TEST_CASE(a_night_is_followed_with_fixed_polling) {
+  host::Trace trace;
+  REQUIRE(trace.load(trace_path("two_zone_night.txt")));
+  Replay replay(trace);
+  replay.run();
+
+  CHECK_EQ(replay.compare_status(FIXED_LATENCY), std::string());
+  CHECK_EQ(replay.compare_count(FIXED_LATENCY), std::string());
+  CHECK_EQ(replay.compare_occupancy(FIXED_LATENCY), std::string());
+  const ReplayReport report = replay.report();
+  CHECK_EQ(report.detected, report.expected_changes);
+  CHECK_EQ(report.false_transitions, 0u);
+  // Nothing is published while nothing changes.
+  CHECK_EQ(report.status_publishes, report.expected_changes);
+}
+
+TEST_CASE(noise_and_spikes_cause_no_false_transitions) {
+  host::Trace trace;
+  REQUIRE(trace.load(trace_path("two_zone_night.txt")));
+  Replay replay(trace, {.noise = 12.0f, .spike_chance = 0.01f});
+  replay.run();
+
+  CHECK_EQ(replay.compare_status(FIXED_LATENCY), std::string());
+  CHECK_EQ(replay.compare_count(FIXED_LATENCY), std::string());
+  CHECK_EQ(replay.compare_occupancy(FIXED_LATENCY), std::string());
+  CHECK_EQ(replay.report().false_transitions, 0u);
+}
+
+TEST_CASE(adaptive_polling_polls_less_within_its_latency) {
+  host::Trace trace;
+  REQUIRE(trace.load(trace_path("two_zone_night.txt")));
+  uint32_t fixed_polls;
+  {
+    Replay replay(trace);
+    replay.run();
+    fixed_polls = replay.report().polls;
+  }
+  host::restart();
+
+  Replay replay(trace, ADAPTIVE);
+  replay.run();
+  CHECK_EQ(replay.compare_status(ADAPTIVE_LATENCY), std::string());
+  CHECK_EQ(replay.compare_count(ADAPTIVE_LATENCY), std::string());
+  CHECK_EQ(replay.compare_occupancy(ADAPTIVE_LATENCY), std::string());
+  CHECK(replay.report().polls * 2 < fixed_polls);
+}
+
+TEST_CASE(noisy_pads_let_adaptive_polling_back_off) {
+  host::Trace trace;
+  REQUIRE(trace.load(trace_path("two_zone_night.txt")));
+  uint32_t quiet_polls;
+  {
+    Replay replay(trace, ADAPTIVE);
+    replay.run();
+    quiet_polls = replay.report().polls;
+  }
+  host::restart();
+
+  // Sample noise and spikes move the raw readings by more than value_delta, but not the pressure level.
+  ReplayOptions noisy = ADAPTIVE;
+  noisy.noise = 12.0f;
+  noisy.spike_chance = 0.01f;
+  Replay replay(trace, noisy);
+  replay.run();
+  CHECK_EQ(replay.compare_status(ADAPTIVE_LATENCY), std::string());
+  CHECK_EQ(replay.report().false_transitions, 0u);
+  CHECK(replay.report().polls * 10 < quiet_polls * 11);
+}
+
+TEST_CASE(a_pad_hovering_at_the_threshold_does_not_flap) {
+  // Alice lies on the edge of her pad, her pressure wavering between 77% and 72% of full scale: above the 75% the
+  // zone is entered at, then only ever between that and the 70% it clears at.
+  host::Trace trace({"Alice", "Bob"});
+  trace.add(0, {1012.0f, 1010.0f}, "Empty");
+  for (uint32_t s = 60; s < 30 * 60; s += 5)
+    trace.add(s * 1000, {(s / 5) % 2 == 0 ? 235.0f : 285.0f, 1010.0f}, "Alice");
+  trace.add(30 * 60 * 1000, {1012.0f, 1010.0f}, "Empty");
+  Replay replay(trace);
+  replay.run();
+
+  CHECK_EQ(replay.compare_status(FIXED_LATENCY), std::string());
+  CHECK_EQ(replay.report().status_publishes, 3u);
+}
+
+BENCHMARK(bed_sensor_replay_nights) {
+  const char *recorded = std::getenv("BED_SENSOR_TRACE");
+  const std::string path = recorded != nullptr ? recorded : trace_path("two_zone_night.txt");
+  host::Trace trace;
+  REQUIRE(trace.load(path));
+  const std::string name = "bed_sensor replay of " + path.substr(path.find_last_of('/') + 1);
+
+  const std::pair<const char *, ReplayOptions> setups[] = {
+      {"2 s polling", {}},
+      {"2 s polling, noisy pads", {.noise = 12.0f, .spike_chance = 0.01f}},
+      {"adaptive 1-10 s polling", ADAPTIVE},
+      {"adaptive 1-10 s polling, noisy pads",
+       {.min_interval = 1000, .max_interval = 10000, .noise = 12.0f, .spike_chance = 0.01f}},
+  };
+  for (const auto &[setup, options] : setups) {
+    {
+      Replay replay(trace, options);
+      replay.run();
+      replay.print_report(name + ", " + setup);
+      // A recorded night is only reported on, its labels are someone's best guess.
+      if (recorded == nullptr)
+        CHECK_EQ(replay.report().detected, replay.report().expected_changes);
+    }
+    host::restart();
+  }
+}
@@ -0,0 +1,269 @@
+#include "host.h"
+#include "host_test.h"
+
+#include "esphome/components/bed_sensor/bed_sensor.h"
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
+
+using namespace esphome;
+using esphome::host::RecordingOutput;
+
+namespace {
+
+/// Two pressure pads on one ADC. A pad reads full scale when nobody is on it and drops with the pressure on it; the
+/// ADC only sees the pad whose output is powered.
+struct Bed {
+  static constexpr float FULL_SCALE = 1024.0f;
+
+  adc::ADCSensor adc;
+  std::array<RecordingOutput, 2> outputs;
+  std::array<sensor::Sensor, 2> values;
+  std::array<binary_sensor::BinarySensor, 2> zones;
+  std::array<sensor::Sensor, 2> thresholds;
+  binary_sensor::BinarySensor someone;
+  sensor::Sensor count;
+  sensor::Sensor occupancy;
+  text_sensor::TextSensor status;
+  bed_sensor::BedSensor bed;
+  std::array<float, 2> pressure{0.0f, 0.0f};  ///< Percent pressure on each pad.
+  uint32_t samples_with_bad_power{0};
+
+  explicit Bed(bool auto_calibrate = false) {
+    this->zones[0].set_name("Alice Side");
+    this->zones[1].set_name("Bob Side");
+    this->adc.set_sampler([this]() {
+      int powered = -1;
+      for (int i = 0; i < 2; i++) {
+        if (this->outputs[i].state()) {
+          if (powered != -1)
+            this->samples_with_bad_power++;
+          powered = i;
+        }
+      }
+      if (powered == -1) {
+        this->samples_with_bad_power++;
+        return FULL_SCALE;
+      }
+      return FULL_SCALE * (1.0f - this->pressure[powered] / 100.0f);
+    });
+    this->bed.set_adc_sensor(&this->adc);
+    this->bed.add_zone("Alice", &this->outputs[0], &this->values[0], &this->zones[0]);
+    this->bed.set_last_zone_threshold_sensor(&this->thresholds[0]);
+    this->bed.add_zone("Bob", &this->outputs[1], &this->values[1], &this->zones[1]);
+    this->bed.set_last_zone_threshold_sensor(&this->thresholds[1]);
+    this->bed.set_someone_sensor(&this->someone);
+    this->bed.set_someone_name("Someone");
+    this->bed.set_count_sensor(&this->count);
+    this->bed.set_occupancy_sensor(&this->occupancy);
+    this->bed.set_status_sensor(&this->status);
+    this->bed.set_update_interval(1000);
+    this->bed.set_auto_calibrate(auto_calibrate);
+    App.register_component(&this->bed);
+    App.setup();
+  }
+};
+
+/// A bunk room: four pads on one ADC, one per sleeper.
+struct BunkBeds {
+  static constexpr size_t ZONES = 4;
+
+  adc::ADCSensor adc;
+  std::array<RecordingOutput, ZONES> outputs;
+  std::array<sensor::Sensor, ZONES> values;
+  std::array<binary_sensor::BinarySensor, ZONES> zones;
+  sensor::Sensor count;
+  sensor::Sensor occupancy;
+  text_sensor::TextSensor status;
+  bed_sensor::BedSensor bed;
+  std::array<float, ZONES> pressure{};
+  uint32_t samples_with_bad_power{0};
+
+  BunkBeds() {
+    this->adc.set_sampler([this]() {
+      int powered = -1;
+      for (size_t i = 0; i < ZONES; i++) {
+        if (this->outputs[i].state()) {
+          if (powered != -1)
+            this->samples_with_bad_power++;
+          powered = static_cast<int>(i);
+        }
+      }
+      if (powered == -1) {
+        this->samples_with_bad_power++;
+        return Bed::FULL_SCALE;
+      }
+      return Bed::FULL_SCALE * (1.0f - this->pressure[powered] / 100.0f);
+    });
+    this->bed.set_adc_sensor(&this->adc);
+    const char *const names[ZONES] = {"Ann", "Ben", "Cat", "Dev"};
+    for (size_t i = 0; i < ZONES; i++)
+      this->bed.add_zone(names[i], &this->outputs[i], &this->values[i], &this->zones[i]);
+    this->bed.set_count_sensor(&this->count);
+    this->bed.set_occupancy_sensor(&this->occupancy);
+    this->bed.set_status_sensor(&this->status);
+    this->bed.set_update_interval(1000);
+    App.register_component(&this->bed);
+    App.setup();
+  }
+
+  /// The pads in the order they were powered up for a reading.
+  std::vector<size_t> powered_order() const {
+    std::vector<std::pair<uint32_t, size_t>> edges;
+    for (size_t i = 0; i < ZONES; i++) {
+      const auto &writes = this->outputs[i].get_writes();
+      for (size_t w = 0; w < writes.size(); w++) {
+        if (writes[w].second && (w == 0 || !writes[w - 1].second))
+          edges.emplace_back(writes[w].first, i);
+      }
+    }
+    std::stable_sort(edges.begin(), edges.end());
+    std::vector<size_t> order;
+    for (const auto &edge : edges)
+      order.push_back(edge.second);
+    return order;
+  }
+};
+
+}  // namespace
+
+TEST_CASE(getting_in_and_out_of_bed) {
+  Bed bed;
+  App.run_for(5000);
+  CHECK_EQ(bed.status.state, std::string("Empty"));
+  CHECK_EQ(bed.count.state, 0.0f);
+
+  bed.pressure[0] = 90.0f;
+  App.run_for(3000);
+  CHECK_EQ(bed.status.state, std::string("Alice"));
+  CHECK(bed.zones[0].state);
+  CHECK(!bed.zones[1].state);
+  CHECK_EQ(bed.occupancy.state, 1.0f);
+  CHECK_EQ(bed.count.state, 1.0f);
+
+  bed.pressure[1] = 85.0f;
+  App.run_for(3000);
+  CHECK_EQ(bed.status.state, std::string("Alice and Bob"));
+  CHECK_EQ(bed.occupancy.state, 3.0f);
+  CHECK_EQ(bed.count.state, 2.0f);
+
+  bed.pressure = {0.0f, 0.0f};
+  App.run_for(3000);
+  CHECK_EQ(bed.status.state, std::string("Empty"));
+  CHECK_EQ(bed.count.state, 0.0f);
+  CHECK_EQ(bed.samples_with_bad_power, 0u);
+}
+
+TEST_CASE(someone_in_the_middle_of_the_bed) {
+  Bed bed;
+  bed.pressure = {50.0f, 50.0f};
+  App.run_for(5000);
+  CHECK(bed.someone.state);
+  CHECK_EQ(bed.status.state, std::string("Someone"));
+  CHECK_EQ(bed.count.state, 1.0f);
+  CHECK_EQ(bed.occupancy.state, 0.0f);
+}
+
+TEST_CASE(only_the_zone_being_read_is_powered) {
+  Bed bed;
+  bed.pressure = {90.0f, 20.0f};
+  App.run_for(60 * 1000);
+  CHECK(bed.adc.get_sample_count() > 0);
+  CHECK_EQ(bed.samples_with_bad_power, 0u);
+}
+
+TEST_CASE(the_sample_count_is_kept_within_the_burst_buffer) {
+  Bed bed;
+  bed.pressure = {90.0f, 0.0f};
+  App.run_for(1500);
+
+  bed.bed.set_sample_count(40);
+  uint32_t before = bed.adc.get_sample_count();
+  App.run_for(1000);
+  CHECK_EQ(bed.adc.get_sample_count() - before, static_cast<uint32_t>(bed_sensor::MAX_SAMPLES));
+
+  bed.bed.set_sample_count(0);
+  before = bed.adc.get_sample_count();
+  App.run_for(1000);
+  CHECK_EQ(bed.adc.get_sample_count() - before, 1u);
+  App.run_for(2000);
+  CHECK_EQ(bed.status.state, std::string("Alice"));
+}
+
+TEST_CASE(four_zones_are_read_in_turn_and_named_together) {
+  BunkBeds beds;
+  App.run_for(8500);
+  CHECK_EQ(beds.status.state, std::string("Empty"));
+  // Every zone in turn, round and round.
+  const std::vector<size_t> order = beds.powered_order();
+  REQUIRE(order.size() >= 2 * BunkBeds::ZONES);
+  for (size_t i = 0; i < order.size(); i++)
+    CHECK_EQ(order[i], i % BunkBeds::ZONES);
+
+  beds.pressure = {90.0f, 0.0f, 85.0f, 0.0f};
+  App.run_for(4000);
+  CHECK_EQ(beds.status.state, std::string("Ann and Cat"));
+  CHECK_EQ(beds.occupancy.state, 5.0f);
+  CHECK_EQ(beds.count.state, 2.0f);
+  CHECK(beds.zones[0].state && !beds.zones[1].state && beds.zones[2].state && !beds.zones[3].state);
+
+  beds.pressure = {90.0f, 80.0f, 85.0f, 0.0f};
+  App.run_for(4000);
+  CHECK_EQ(beds.status.state, std::string("Ann, Ben and Cat"));
+  CHECK_EQ(beds.occupancy.state, 7.0f);
+
+  beds.pressure = {0.0f, 80.0f, 85.0f, 95.0f};
+  App.run_for(4000);
+  CHECK_EQ(beds.status.state, std::string("Ben, Cat and Dev"));
+  CHECK_EQ(beds.occupancy.state, 14.0f);
+  CHECK_EQ(beds.count.state, 3.0f);
+
+  beds.pressure = {85.0f, 80.0f, 85.0f, 95.0f};
+  App.run_for(4000);
+  CHECK_EQ(beds.status.state, std::string("Ann, Ben, Cat and Dev"));
+  CHECK_EQ(beds.occupancy.state, 15.0f);
+  CHECK_EQ(beds.count.state, 4.0f);
+  CHECK_EQ(beds.samples_with_bad_power, 0u);
+}
+
+TEST_CASE(calibration_survives_a_power_loss) {
+  float learned;
+  {
+    Bed bed(true);
+    // Alternate between an empty and an occupied bed on Alice's side until calibration has enough of both.
+    for (int i = 0; i < 4; i++) {
+      bed.pressure[0] = i % 2 == 0 ? 10.0f : 80.0f;
+      App.run_for(15 * 60 * 1000);
+    }
+    App.run_for(11 * 60 * 1000);  // Past the next flash write.
+    REQUIRE(bed.thresholds[0].has_state());
+    learned = bed.thresholds[0].state;
+    CHECK(learned > 30.0f && learned < 60.0f);
+  }
+
+  host::restart(true);
+  Bed bed(true);
+  REQUIRE(bed.thresholds[0].has_state());
+  CHECK_EQ(bed.thresholds[0].state, learned);
+}
+
+BENCHMARK(bed_sensor_night) {
+  Bed bed(true);
+  for (auto &output : bed.outputs)
+    output.set_recording(false);
+  host::Bench bench("bed_sensor, 2 zones, 1 s polling, one night");
+  // Warm up so the one-off allocations of the first readings aren't counted.
+  App.run_for(10 * 1000);
+  bed.pressure = {85.0f, 0.0f};
+  App.run_for(10 * 1000);
+  bench.run(8 * 60 * 60 * 1000);
+  CHECK(bench.get_loops() > 0);
+  // The poll loop itself must not allocate; the only steady-state publishes in a still night are none at all.
+  CHECK_EQ(bench.get_allocations(), 0u);
+  // One calibration save per zone per hour at most, written at the next sync.
+  CHECK(bench.get_flash_writes() <= 2u * 8u);
+  // setup() builds the status text for each of the 4 combinations of zones, and its calibration and timers.
+  CHECK(App.get_stats(&bed.bed).setup_allocations <= 12u);
+}
@@ -0,0 +1,180 @@
+#include "host.h"
+#include "host_test.h"
+
+#include "esphome/components/brew_controller/brew_controller.h"
+
+#include <functional>
+
+using namespace esphome;
+using brew_controller::BrewButton;
+
+namespace {
+
+/// A button wired across one of the coffee maker's switches, calling `on_press` when it is pushed down.
+class Button : public output::BinaryOutput {
+ public:
+  std::function<void()> on_press;
+  uint32_t presses{0};
+
+ protected:
+  void write_state(bool state) override {
+    if (state && !this->down_) {
+      this->presses++;
+      if (this->on_press)
+        this->on_press();
+    }
+    this->down_ = state;
+  }
+
+  bool down_{false};
+};
+
+/// A drip coffee maker: the power button toggles brewing, the bold button toggles the bold setting (which the coffee
+/// maker forgets when it is turned off), and it turns itself off once `brew_time` of brewing has passed.
+struct CoffeeMaker {
+  binary_sensor::BinarySensor power_light;
+  binary_sensor::BinarySensor bold_light;
+  Button power_button;
+  Button bold_button;
+  brew_controller::BrewController controller;
+  brew_controller::BrewSwitch power_switch{&controller, BrewButton::POWER};
+  brew_controller::BrewSwitch bold_switch{&controller, BrewButton::BOLD};
+  text_sensor::TextSensor stage;
+  uint32_t brew_time{6 * 60 * 1000};
+  uint32_t brewed{0};  ///< ms spent brewing.
+  uint32_t last_update{0};
+
+  CoffeeMaker() {
+    this->power_light.publish_initial_state(false);
+    this->bold_light.publish_initial_state(false);
+    this->power_button.on_press = [this]() {
+      this->update();
+      const bool on = !this->power_light.state;
+      if (!on)
+        this->bold_light.publish_state(false);
+      this->power_light.publish_state(on);
+    };
+    this->bold_button.on_press = [this]() { this->bold_light.publish_state(!this->bold_light.state); };
+
+    this->controller.set_power_light(&this->power_light);
+    this->controller.set_bold_light(&this->bold_light);
+    this->controller.set_power_button(&this->power_button);
+    this->controller.set_bold_button(&this->bold_button);
+    this->controller.set_power_switch(&this->power_switch);
+    this->controller.set_bold_switch(&this->bold_switch);
+    this->controller.set_stage_sensor(&this->stage);
+    App.register_component(&this->controller);
+    App.setup();
+  }
+
+  /// Brews for the time passed since the last update, and turns off when the pot is full.
+  void update() {
+    const uint32_t now = millis();
+    if (this->power_light.state)
+      this->brewed += now - this->last_update;
+    this->last_update = now;
+    if (this->power_light.state && this->brewed >= this->brew_time) {
+      this->bold_light.publish_state(false);
+      this->power_light.publish_state(false);
+    }
+  }
+
+  /// Runs the device for `ms`, with the coffee maker brewing alongside it.
+  void run(uint32_t ms) {
+    for (uint32_t elapsed = 0; elapsed < ms; elapsed += 100) {
+      App.run_for(100);
+      this->update();
+    }
+  }
+};
+
+}  // namespace
+
+TEST_CASE(a_brew_pauses_for_the_bloom) {
+  CoffeeMaker maker;
+  CHECK_EQ(maker.stage.state, std::string("Off"));
+
+  maker.power_switch.turn_on();
+  maker.run(1000);
+  CHECK(maker.power_light.state);
+  CHECK(maker.power_switch.state);
+  CHECK_EQ(maker.stage.state, std::string("Pre-Wet"));
+
+  maker.run(75 * 1000);
+  CHECK_EQ(maker.stage.state, std::string("Bloom"));
+  CHECK(!maker.power_light.state);
+
+  maker.run(46 * 1000);
+  CHECK_EQ(maker.stage.state, std::string("Brew"));
+  CHECK(maker.power_light.state);
+
+  maker.run(6 * 60 * 1000);
+  CHECK_EQ(maker.stage.state, std::string("Off"));
+  CHECK(!maker.power_light.state);
+  CHECK_EQ(maker.power_button.presses, 3u);
+}
+
+TEST_CASE(the_bold_setting_is_restored_after_the_bloom) {
+  CoffeeMaker maker;
+  maker.bold_switch.turn_on();
+  maker.run(1000);
+  CHECK(maker.bold_light.state);
+  maker.power_switch.turn_on();
+  maker.run(1000);
+
+  maker.run(75 * 1000);
+  CHECK_EQ(maker.stage.state, std::string("Bloom"));
+  CHECK(!maker.bold_light.state);
+
+  maker.run(46 * 1000);
+  CHECK_EQ(maker.stage.state, std::string("Brew"));
+  CHECK(maker.bold_light.state);
+  CHECK(maker.bold_switch.state);
+}
+
+TEST_CASE(turning_off_during_the_bloom_cancels_the_brew) {
+  CoffeeMaker maker;
+  maker.power_switch.turn_on();
+  maker.run(76 * 1000);
+  REQUIRE(maker.stage.state == "Bloom");
+  const uint32_t presses = maker.power_button.presses;
+
+  maker.power_switch.turn_off();
+  maker.run(60 * 1000);
+  CHECK_EQ(maker.stage.state, std::string("Off"));
+  CHECK(!maker.power_light.state);
+  CHECK_EQ(maker.power_button.presses, presses);
+}
+
+TEST_CASE(turning_on_by_hand_during_the_bloom_skips_the_rest_of_it) {
+  CoffeeMaker maker;
+  maker.power_switch.turn_on();
+  maker.run(76 * 1000);
+  REQUIRE(maker.stage.state == "Bloom");
+
+  maker.power_button.on_press();
+  maker.run(1000);
+  CHECK_EQ(maker.stage.state, std::string("Brew"));
+  maker.run(60 * 1000);
+  // Nothing presses power again when the bloom would have ended.
+  CHECK(maker.power_light.state);
+}
+
+BENCHMARK(brew_controller_brew) {
+  CoffeeMaker maker;
+  // A first brew, so the scheduler has items to reuse.
+  maker.power_switch.turn_on();
+  maker.run(10 * 60 * 1000);
+  REQUIRE(maker.stage.state == "Off");
+
+  host::Bench bench("brew_controller, one brew");
+  maker.brewed = 0;
+  maker.power_switch.turn_on();
+  bench.run(10 * 60 * 1000);
+  // The bench runs App on its own, so the pot never fills and the brew is still going.
+  CHECK_EQ(maker.stage.state, std::string("Brew"));
+  CHECK_EQ(maker.power_button.presses, 6u);
+  // Presses are queued in a fixed array and timed by the scheduler, nothing is allocated per press.
+  CHECK_EQ(bench.get_allocations(), 0u);
+  CHECK_EQ(bench.get_flash_writes(), 0u);
+}
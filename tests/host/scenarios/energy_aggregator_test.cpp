@@ -0,0 +1,101 @@
+#include "host.h"
+#include "host_test.h"
+
+#include "esphome/components/energy_aggregator/energy_aggregator.h"
+
+#include <array>
+
+using namespace esphome;
+
+namespace {
+
+/// 2024-03-10 23:30:00 UTC.
+constexpr time_t LATE_EVENING = 1710113400;
+
+/// A panel with two mains legs and `Circuits` clamped circuits, read every second.
+template<size_t Circuits> struct Panel {
+  std::array<sensor::Sensor, 2> mains;
+  std::array<sensor::Sensor, Circuits> circuits;
+  std::array<sensor::Sensor, 2> main_power, main_energy;
+  std::array<sensor::Sensor, Circuits> circuit_power, circuit_energy;
+  sensor::Sensor total_power, total_energy, balance_power, balance_energy;
+  time::RealTimeClock clock;
+  energy_aggregator::EnergyAggregator aggregator;
+
+  explicit Panel(time_t epoch) {
+    this->clock.synchronize_epoch(epoch);
+    for (size_t i = 0; i < 2; i++)
+      this->aggregator.add_main(&this->mains[i], &this->main_power[i], &this->main_energy[i]);
+    for (size_t i = 0; i < Circuits; i++)
+      this->aggregator.add_circuit(&this->circuits[i], &this->circuit_power[i], &this->circuit_energy[i]);
+    this->aggregator.set_total_sensors(&this->total_power, &this->total_energy);
+    this->aggregator.set_balance_sensors(&this->balance_power, &this->balance_energy);
+    this->aggregator.set_time(&this->clock);
+    this->aggregator.set_update_interval(1000);
+    App.register_component(&this->aggregator);
+    App.setup();
+  }
+};
+
+}  // namespace
+
+TEST_CASE(an_hour_of_constant_load) {
+  Panel<1> panel(LATE_EVENING - 3 * 60 * 60);
+  panel.mains[0].publish_state(1000.0f);
+  panel.mains[1].publish_state(500.0f);
+  panel.circuits[0].publish_state(300.0f);
+
+  // The first update only takes the readings, and the energy published on the hour is from the update before it, so
+  // an hour in the published energy covers 3598 s.
+  App.run_for(60 * 60 * 1000 + 1000);
+  const float hours = 3598.0f / 3600.0f;
+  CHECK_NEAR(panel.main_energy[0].state, 1000.0f * hours, 0.01f);
+  CHECK_NEAR(panel.main_energy[1].state, 500.0f * hours, 0.01f);
+  CHECK_NEAR(panel.circuit_energy[0].state, 300.0f * hours, 0.01f);
+  CHECK_NEAR(panel.total_energy.state, 1500.0f * hours, 0.01f);
+  CHECK_NEAR(panel.balance_energy.state, 1200.0f * hours, 0.01f);
+  CHECK_NEAR(panel.total_power.state, 1500.0f, 0.001f);
+  CHECK_NEAR(panel.balance_power.state, 1200.0f, 0.001f);
+}
+
+TEST_CASE(small_loads_are_not_lost_to_rounding) {
+  Panel<1> panel(LATE_EVENING - 12 * 60 * 60);
+  panel.mains[0].publish_state(0.4f);
+  panel.mains[1].publish_state(0.0f);
+  panel.circuits[0].publish_state(0.0f);
+
+  App.run_for(10 * 60 * 60 * 1000 + 1000);
+  CHECK_NEAR(panel.total_energy.state, 4.0f, 0.01f);
+}
+
+TEST_CASE(energy_resets_at_midnight) {
+  Panel<1> panel(LATE_EVENING);
+  panel.mains[0].publish_state(1200.0f);
+  panel.mains[1].publish_state(0.0f);
+  panel.circuits[0].publish_state(-3.0f);  // CT clamp noise counts as nothing.
+
+  App.run_for(29 * 60 * 1000);
+  CHECK_NEAR(panel.total_energy.state, 1200.0f * 28 / 60, 25.0f);
+  CHECK_EQ(panel.circuit_energy[0].state, 0.0f);
+
+  // Midnight was half a minute ago, the reset was published straight away.
+  App.run_for(90 * 1000);
+  CHECK_EQ(panel.total_energy.state, 0.0f);
+  CHECK_EQ(panel.main_energy[0].state, 0.0f);
+  App.run_for(60 * 60 * 1000);
+  CHECK_NEAR(panel.total_energy.state, 1200.0f, 25.0f);
+}
+
+BENCHMARK(energy_aggregator_day) {
+  Panel<8> panel(LATE_EVENING);
+  for (auto &main : panel.mains)
+    main.publish_state(2400.0f);
+  for (size_t i = 0; i < panel.circuits.size(); i++)
+    panel.circuits[i].publish_state(100.0f * i);
+  App.run_for(10 * 1000);
+
+  host::Bench bench("energy_aggregator, 2 mains and 8 circuits, 1 s updates, one day");
+  bench.run(24 * 60 * 60 * 1000);
+  CHECK_EQ(bench.get_allocations(), 0u);
+  CHECK_EQ(bench.get_flash_writes(), 0u);
+}
@@ -0,0 +1,394 @@
+#include "econet_bus.h"
+#include "host.h"
+#include "host_test.h"
+
+#include "esphome/components/econet/econet_water_heater.h"
+#include "esphome/components/high_temp_water_heater/high_temp_water_heater.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+using namespace esphome;
+using namespace esphome::water_heater;
+
+namespace {
+
+/// A heat pump water heater on a bus, like the EcoNet one: commands take effect after `latency_ms` and can be lost,
+/// and it heats for as long as it isn't off. It reports the bottom of the tank as its current temperature.
+class SourceHeater : public WaterHeater, public Component {
+ public:
+  uint32_t latency_ms{2000};
+  uint32_t commands_to_drop{0};  ///< The next this many commands are lost on the bus.
+  uint32_t commands{0};
+
+  SourceHeater() {
+    this->set_name("Heat Pump Water Heater");
+    this->target_temperature_ = 50.0f;
+  }
+
+  void loop() override {
+    if (!this->pending_ || millis() - this->sent_ms_ < this->latency_ms)
+      return;
+    this->pending_ = false;
+    if (this->pending_mode_.has_value())
+      this->set_mode_(*this->pending_mode_);
+    if (this->pending_away_.has_value())
+      this->set_state_flag_(WATER_HEATER_STATE_AWAY, *this->pending_away_);
+    this->publish_state();
+  }
+  WaterHeaterCallInternal make_call() override { return WaterHeaterCallInternal(this); }
+  void report_temperature(float temperature) {
+    if (temperature != this->current_temperature_) {
+      this->set_current_temperature(temperature);
+      this->publish_state();
+    }
+  }
+  /// Someone changed the mode at the heater itself.
+  void set_mode_locally(WaterHeaterMode mode) {
+    this->set_mode_(mode);
+    this->publish_state();
+  }
+
+ protected:
+  WaterHeaterTraits traits() override {
+    WaterHeaterTraits traits;
+    traits.add_feature_flags(WATER_HEATER_SUPPORTS_CURRENT_TEMPERATURE | WATER_HEATER_SUPPORTS_TARGET_TEMPERATURE |
+                             WATER_HEATER_SUPPORTS_OPERATION_MODE | WATER_HEATER_SUPPORTS_AWAY_MODE);
+    traits.set_supported_modes(
+        {WATER_HEATER_MODE_OFF, WATER_HEATER_MODE_ECO, WATER_HEATER_MODE_HEAT_PUMP, WATER_HEATER_MODE_HIGH_DEMAND});
+    traits.set_min_temperature(43.0f);
+    traits.set_max_temperature(60.0f);
+    return traits;
+  }
+  void control(const WaterHeaterCall &call) override {
+    this->commands++;
+    if (this->commands_to_drop > 0) {
+      this->commands_to_drop--;
+      return;
+    }
+    this->pending_ = true;
+    this->sent_ms_ = millis();
+    this->pending_mode_ = call.get_mode();
+    this->pending_away_ = call.get_away();
+  }
+
+  bool pending_{false};
+  uint32_t sent_ms_{0};
+  optional<WaterHeaterMode> pending_mode_;
+  optional<bool> pending_away_;
+};
+
+/// The tank as two layers. The heater warms both, standing losses cool both, and a draw pulls cold water into the
+/// bottom much faster than it cools the top. Sensors on each layer report every 30 s.
+class Tank : public Component {
+ public:
+  static constexpr uint32_t STEP_MS = 30000;
+  float top{45.0f};
+  float bottom{44.0f};
+  float heating_rate{0.5f};  ///< °C/min while the source heats.
+  float loss_rate{1.0f};     ///< °C/h.
+  uint32_t draw_until{0};
+  sensor::Sensor top_sensor;
+  sensor::Sensor bottom_sensor;
+  float min_top{NAN};
+  float max_top{NAN};
+
+  explicit Tank(SourceHeater *source) : source_(source) {
+    this->top_sensor.set_name("Tank Top");
+    this->top_sensor.set_unit_of_measurement("\xc2\xb0\x43");
+    this->bottom_sensor.set_name("Tank Bottom");
+    this->bottom_sensor.set_unit_of_measurement("\xc2\xb0\x43");
+  }
+  float get_setup_priority() const override { return setup_priority::HARDWARE; }
+  void setup() override {
+    this->report_();
+    this->set_interval("tank", STEP_MS, [this]() { this->step_(); });
+  }
+  void draw(uint32_t minutes) { this->draw_until = millis() + minutes * 60000; }
+  void clear_extremes() { this->min_top = this->max_top = this->top; }
+
+ protected:
+  void step_() {
+    const float minutes = STEP_MS / 60000.0f;
+    if (this->source_->get_mode() != WATER_HEATER_MODE_OFF) {
+      this->top += this->heating_rate * minutes;
+      this->bottom += this->heating_rate * minutes;
+    }
+    this->top -= this->loss_rate * minutes / 60.0f;
+    this->bottom -= this->loss_rate * minutes / 60.0f;
+    if (static_cast<int32_t>(this->draw_until - millis()) > 0) {
+      this->top -= 0.3f * minutes;
+      this->bottom -= 3.0f * minutes;
+    }
+    this->min_top = std::isnan(this->min_top) ? this->top : std::min(this->min_top, this->top);
+    this->max_top = std::isnan(this->max_top) ? this->top : std::max(this->max_top, this->top);
+    this->report_();
+  }
+  void report_() {
+    // Sensors resolve 0.1 °C.
+    this->top_sensor.publish_state(std::round(this->top * 10.0f) / 10.0f);
+    this->bottom_sensor.publish_state(std::round(this->bottom * 10.0f) / 10.0f);
+    this->source_->report_temperature(std::round(this->bottom));
+  }
+
+  SourceHeater *source_;
+};
+
+struct Installation {
+  SourceHeater source;
+  Tank tank{&this->source};
+  sensor::Sensor retries;
+  sensor::Sensor mismatches;
+  sensor::Sensor cycles;
+  sensor::Sensor recovery_time;
+  sensor::Sensor duty_cycle;
+  high_temp_water_heater::HighTempWaterHeater heater;
+
+  explicit Installation(float draw_rate = NAN) {
+    this->heater.set_name("High Temp Water Heater");
+    this->heater.set_source_water_heater(&this->source);
+    this->heater.add_temperature_sensor(&this->tank.top_sensor, 0.0f, 1.0f);
+    this->heater.add_temperature_sensor(&this->tank.bottom_sensor, 0.0f, 1.0f);
+    this->heater.set_last_temperature_sensor_draw_rate(draw_rate);
+    this->heater.set_min_temperature(40.0f);
+    this->heater.set_max_temperature(65.0f);
+    this->heater.set_dead_band(5.0f);
+    this->heater.set_command_timeout(30000);
+    this->heater.set_command_retries_sensor(&this->retries);
+    this->heater.set_command_mismatches_sensor(&this->mismatches);
+    this->heater.set_cycle_count_sensor(&this->cycles);
+    this->heater.set_recovery_time_sensor(&this->recovery_time);
+    this->heater.set_duty_cycle_sensor(&this->duty_cycle);
+    App.register_component(&this->source);
+    App.register_component(&this->tank);
+    App.register_component(&this->heater);
+    App.setup();
+  }
+
+  void set(WaterHeaterMode mode, float target) {
+    auto call = this->heater.make_call();
+    call.set_mode(mode);
+    call.set_target_temperature(target);
+    call.perform();
+  }
+
+  /// Tank average, which is what the heater regulates.
+  float average() const { return (this->tank.top + this->tank.bottom) / 2.0f; }
+};
+
+float f_to_c(float f) { return (f - 32.0f) * 5.0f / 9.0f; }
+
+/// The same heater over a simulated EcoNet bus: an EcoNet heat pump water heater as the source, its upper and lower
+/// tank temperatures as the sensors. The heat pump's own setpoint is 140°F, which it only heats to within 10°F of.
+struct EconetInstallation {
+  static constexpr uint32_t WATER_HEATER = 0x1040;
+  econet::Econet econet;
+  host::EconetBus bus;
+  host::HeatPumpWaterHeater *tank;
+  econet::EconetWaterHeater source;
+  sensor::Sensor upper;
+  sensor::Sensor lower;
+  sensor::Sensor retries;
+  sensor::Sensor cycles;
+  high_temp_water_heater::HighTempWaterHeater heater;
+
+  explicit EconetInstallation(host::EconetBusOptions options) : bus(&this->econet, options) {
+    this->tank = this->bus.add_water_heater(WATER_HEATER);
+    this->tank->set_float("WHTRSETP", 140.0f);
+    this->source.set_name("Heat Pump Water Heater");
+    this->source.set_econet_parent(&this->econet);
+    this->source.set_src_adr(WATER_HEATER);
+    this->source.add_mode(host::HeatPumpWaterHeater::MODE_OFF, WATER_HEATER_MODE_OFF);
+    this->source.add_mode(host::HeatPumpWaterHeater::MODE_ECO, WATER_HEATER_MODE_ECO);
+    this->source.add_mode(host::HeatPumpWaterHeater::MODE_HEAT_PUMP, WATER_HEATER_MODE_HEAT_PUMP);
+    this->source.add_mode(host::HeatPumpWaterHeater::MODE_HIGH_DEMAND, WATER_HEATER_MODE_HIGH_DEMAND);
+    this->source.add_mode(host::HeatPumpWaterHeater::MODE_ELECTRIC, WATER_HEATER_MODE_ELECTRIC);
+    const std::pair<const char *, sensor::Sensor *> sensors[] = {{"UPHTRTMP", &this->upper},
+                                                                  {"LOHTRTMP", &this->lower}};
+    for (const auto &[datapoint_id, sens] : sensors) {
+      this->econet.register_listener(
+          datapoint_id, 0, false, [sens](const econet::EconetDatapoint &datapoint) {
+            sens->publish_state(f_to_c(datapoint.value_float));
+          },
+          false, WATER_HEATER);
+    }
+
+    this->heater.set_name("High Temp Water Heater");
+    this->heater.set_source_water_heater(&this->source);
+    this->heater.add_temperature_sensor(&this->upper, 0.0f, 1.0f);
+    this->heater.add_temperature_sensor(&this->lower, 0.0f, 1.0f);
+    this->heater.set_min_temperature(f_to_c(110.0f));
+    this->heater.set_max_temperature(f_to_c(150.0f));
+    this->heater.set_dead_band(5.0f * 5.0f / 9.0f);
+    this->heater.set_command_timeout(30000);
+    this->heater.set_command_retries_sensor(&this->retries);
+    this->heater.set_cycle_count_sensor(&this->cycles);
+    App.register_component(&this->econet);
+    App.register_component(&this->bus);
+    App.register_component(&this->source);
+    App.register_component(&this->heater);
+    App.setup();
+  }
+
+  /// Tank average in °F, as the bus reports it.
+  float average() const { return (this->tank->get_float("UPHTRTMP") + this->tank->get_float("LOHTRTMP")) / 2.0f; }
+};
+
+constexpr uint32_t MINUTE = 60 * 1000;
+constexpr uint32_t HOUR = 60 * MINUTE;
+
+}  // namespace
+
+TEST_CASE(heats_the_tank_past_the_source_setpoint) {
+  Installation hw;
+  App.run_for(MINUTE);
+  CHECK_EQ(hw.source.get_mode(), WATER_HEATER_MODE_OFF);
+
+  hw.set(WATER_HEATER_MODE_ECO, 60.0f);
+  App.run_for(5000);
+  CHECK_EQ(hw.source.get_mode(), WATER_HEATER_MODE_ECO);
+  CHECK_EQ(hw.cycles.state, 1.0f);
+
+  // 15.5 °C at 0.5 °C/min.
+  App.run_for(35 * MINUTE);
+  CHECK_EQ(hw.source.get_mode(), WATER_HEATER_MODE_OFF);
+  CHECK(hw.average() >= 60.0f);
+  CHECK(hw.average() < 61.0f);
+  CHECK_NEAR(hw.recovery_time.state, 32.5f, 1.0f);
+  // The source was told once to heat and once to stop.
+  CHECK_EQ(hw.source.commands, 2u);
+  CHECK_EQ(hw.retries.state, 0.0f);
+}
+
+TEST_CASE(standing_losses_are_made_up_within_the_dead_band) {
+  Installation hw;
+  hw.set(WATER_HEATER_MODE_ECO, 60.0f);
+  App.run_for(HOUR);
+  hw.tank.clear_extremes();
+
+  App.run_for(24 * HOUR);
+  // 24 °C lost over the day, made up in 5 °C cycles.
+  CHECK(hw.cycles.state >= 5.0f && hw.cycles.state <= 6.0f);
+  CHECK(hw.tank.min_top >= 55.0f - 0.5f);
+  CHECK(hw.tank.max_top <= 60.0f + 1.5f);
+  CHECK_NEAR(hw.duty_cycle.state, 24.0f * 100.0f / (0.5f * 60.0f * 25.0f), 2.0f);
+}
+
+TEST_CASE(a_lost_command_is_retried) {
+  Installation hw;
+  hw.source.commands_to_drop = 1;
+  hw.set(WATER_HEATER_MODE_ECO, 60.0f);
+  App.run_for(20000);
+  CHECK_EQ(hw.source.get_mode(), WATER_HEATER_MODE_OFF);
+  CHECK_EQ(hw.source.commands, 1u);
+
+  App.run_for(20000);
+  CHECK_EQ(hw.source.commands, 2u);
+  CHECK_EQ(hw.retries.state, 1.0f);
+  CHECK_EQ(hw.source.get_mode(), WATER_HEATER_MODE_ECO);
+}
+
+TEST_CASE(a_slow_bus_is_not_flooded_with_commands) {
+  Installation hw;
+  hw.source.latency_ms = 20000;
+  hw.set(WATER_HEATER_MODE_ECO, 60.0f);
+  App.run_for(25000);
+  CHECK_EQ(hw.source.get_mode(), WATER_HEATER_MODE_ECO);
+  CHECK_EQ(hw.source.commands, 1u);
+  CHECK_EQ(hw.retries.state, 0.0f);
+}
+
+TEST_CASE(a_mode_changed_at_the_heater_is_put_back) {
+  Installation hw;
+  hw.set(WATER_HEATER_MODE_ECO, 60.0f);
+  App.run_for(5 * MINUTE);
+  CHECK_EQ(hw.source.get_mode(), WATER_HEATER_MODE_ECO);
+
+  hw.source.set_mode_locally(WATER_HEATER_MODE_OFF);
+  App.run_for(5000);
+  CHECK_EQ(hw.source.get_mode(), WATER_HEATER_MODE_ECO);
+  CHECK_EQ(hw.mismatches.state, 1.0f);
+}
+
+TEST_CASE(matching_targets_hand_control_to_the_source) {
+  Installation hw;
+  hw.set(WATER_HEATER_MODE_HEAT_PUMP, 50.0f);
+  App.run_for(5000);
+  // The source regulates its own setpoint, so it just gets the mode.
+  CHECK_EQ(hw.source.get_mode(), WATER_HEATER_MODE_HEAT_PUMP);
+  CHECK_EQ(hw.cycles.state, 0.0f);
+}
+
+TEST_CASE(a_large_draw_starts_recovery_early) {
+  Installation hw(1.0f);
+  hw.set(WATER_HEATER_MODE_ECO, 60.0f);
+  App.run_for(HOUR);
+  CHECK_EQ(hw.source.get_mode(), WATER_HEATER_MODE_OFF);
+  CHECK_EQ(hw.cycles.state, 1.0f);
+
+  // The bottom falls 3 °C/min, the average is still above the dead band when the draw is spotted.
+  hw.tank.draw(2);
+  App.run_for(3 * MINUTE);
+  CHECK(hw.average() > 55.0f);
+  CHECK_EQ(hw.cycles.state, 2.0f);
+  CHECK_EQ(hw.source.get_mode(), WATER_HEATER_MODE_ECO);
+}
+
+TEST_CASE(settings_survive_a_restart) {
+  {
+    Installation hw;
+    hw.set(WATER_HEATER_MODE_ECO, 58.0f);
+    App.run_for(11 * MINUTE);
+  }
+  host::restart(true);
+  Installation hw;
+  CHECK_EQ(hw.heater.get_mode(), WATER_HEATER_MODE_ECO);
+  CHECK_EQ(hw.heater.get_target_temperature(), 58.0f);
+}
+
+TEST_CASE(holds_the_tank_over_a_lossy_econet_bus) {
+  EconetInstallation hw({.packet_loss = 0.3f});
+  auto call = hw.heater.make_call();
+  call.set_mode(WATER_HEATER_MODE_HEAT_PUMP);
+  call.set_target_temperature(f_to_c(130.0f));
+  call.perform();
+  App.run_for(HOUR);
+  CHECK(hw.average() > 125.0f);
+  CHECK(!hw.tank->is_heating());
+
+  // A day of standing losses and two showers; between them the tank stays in the 5°F band under 130°F.
+  float lowest = INFINITY;
+  float highest = -INFINITY;
+  for (uint32_t hour = 0; hour < 24; hour++) {
+    if (hour == 7 || hour == 19)
+      hw.tank->draw(10 * MINUTE);
+    for (uint32_t minute = 0; minute < 60; minute++) {
+      App.run_for(MINUTE);
+      if (hour != 7 && hour != 19) {
+        lowest = std::min(lowest, hw.average());
+        highest = std::max(highest, hw.average());
+      }
+    }
+  }
+  CHECK(lowest > 124.0f);
+  CHECK(highest < 131.0f);
+  CHECK(hw.cycles.state >= 3.0f);
+  // Every mode change lost on the way was sent again once it timed out.
+  CHECK(hw.bus.get_lost_writes() > 0u);
+  CHECK_EQ(hw.retries.state, static_cast<float>(hw.bus.get_lost_writes()));
+}
+
+BENCHMARK(high_temp_water_heater_day) {
+  Installation hw(1.0f);
+  hw.set(WATER_HEATER_MODE_ECO, 60.0f);
+  App.run_for(2 * HOUR);
+
+  host::Bench bench("high_temp_water_heater, two tank sensors, one day");
+  const float cycles_before = hw.cycles.state;
+  hw.tank.draw(3);
+  bench.run(24 * HOUR);
+  CHECK_EQ(bench.get_allocations(), 0u);
+  // Our mode and target don't change; only the source's saved mode does, when a cycle starts and stops.
+  CHECK(bench.get_flash_writes() <= 2u * static_cast<uint32_t>(hw.cycles.state - cycles_before));
+}
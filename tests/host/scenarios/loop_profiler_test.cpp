@@ -0,0 +1,117 @@
+#include "host.h"
+#include "host_test.h"
+
+#include "esphome/components/bed_sensor/bed_sensor.h"
+#include "esphome/components/loop_profiler/loop_profiler.h"
+
+#include <array>
+
+using namespace esphome;
+using esphome::loop_profiler::ProfilePoint;
+
+namespace {
+
+/// A pad output behind a slow GPIO expander: every write takes `write_us` of simulated time, which is what the
+/// profiler sees in bed_sensor's update().
+class SlowOutput : public host::RecordingOutput {
+ public:
+  uint32_t write_us{50};
+
+ protected:
+  void write_state(bool state) override {
+    delayMicroseconds(this->write_us);
+    host::RecordingOutput::write_state(state);
+  }
+};
+
+/// A two zone bed polled every second, profiled once a minute.
+struct ProfiledBed {
+  adc::ADCSensor adc;
+  std::array<SlowOutput, 2> outputs;
+  std::array<sensor::Sensor, 2> values;
+  std::array<binary_sensor::BinarySensor, 2> zones;
+  sensor::Sensor count;
+  text_sensor::TextSensor status;
+  bed_sensor::BedSensor bed;
+  sensor::Sensor p50;
+  sensor::Sensor p99;
+  sensor::Sensor max;
+  sensor::Sensor calls;
+  loop_profiler::LoopProfiler profiler;
+
+  ProfiledBed() {
+    // Points are static and outlive a scenario; start from empty windows.
+    for (ProfilePoint *point = ProfilePoint::first_point; point != nullptr; point = point->get_next())
+      point->reset();
+
+    this->adc.set_sampler([]() { return 1024.0f; });
+    this->bed.set_adc_sensor(&this->adc);
+    this->bed.add_zone("Alice", &this->outputs[0], &this->values[0], &this->zones[0]);
+    this->bed.add_zone("Bob", &this->outputs[1], &this->values[1], &this->zones[1]);
+    this->bed.set_count_sensor(&this->count);
+    this->bed.set_status_sensor(&this->status);
+    this->bed.set_update_interval(1000);
+    this->profiler.add_point("bed_sensor", &this->p50, &this->p99, &this->max, &this->calls);
+    this->profiler.set_update_interval(60 * 1000);
+    this->profiler.set_log(false);
+    App.register_component(&this->bed);
+    App.register_component(&this->profiler);
+    App.setup();
+  }
+};
+
+}  // namespace
+
+TEST_CASE(each_window_reports_the_timing_of_the_point) {
+  ProfiledBed device;
+  CHECK(!device.calls.has_state());
+  App.run_for(90 * 1000);
+
+  // One update a second, each writing both pad outputs.
+  CHECK_NEAR(device.calls.state, 60.0f, 1.0f);
+  CHECK_EQ(device.p50.state, 100.0f);
+  CHECK_EQ(device.p99.state, 100.0f);
+  CHECK_EQ(device.max.state, 100.0f);
+}
+
+TEST_CASE(a_single_slow_call_shows_in_max_only_and_for_one_window) {
+  ProfiledBed device;
+  App.run_for(90 * 1000);
+
+  // One write stalls for 5 ms in the second window.
+  device.outputs[0].write_us = 5000;
+  App.run_for(1000);
+  device.outputs[0].write_us = 50;
+  App.run_for(60 * 1000);
+  CHECK_EQ(device.max.state, 5050.0f);
+  // Percentiles are bucket bounds, which are no longer clamped to the 100 µs of every other call.
+  CHECK_EQ(device.p50.state, 128.0f);
+  CHECK_EQ(device.p99.state, 128.0f);
+
+  App.run_for(60 * 1000);
+  CHECK_EQ(device.max.state, 100.0f);
+}
+
+TEST_CASE(an_idle_window_reports_no_calls_and_keeps_the_last_timing) {
+  ProfiledBed device;
+  App.run_for(90 * 1000);
+  CHECK_EQ(device.max.state, 100.0f);
+
+  device.bed.stop_poller();
+  App.run_for(2 * 60 * 1000);
+  CHECK_EQ(device.calls.state, 0.0f);
+  CHECK_EQ(device.max.state, 100.0f);
+}
+
+BENCHMARK(loop_profiler_overhead) {
+  ProfiledBed device;
+  for (auto &output : device.outputs)
+    output.set_recording(false);
+  App.run_for(2 * 60 * 1000);
+
+  host::Bench bench("loop_profiler, bed_sensor profiled, one hour");
+  bench.run(60 * 60 * 1000);
+  // Timing a call and publishing a window must not allocate.
+  CHECK_EQ(bench.get_allocations(), 0u);
+  CHECK_EQ(bench.get_flash_writes(), 0u);
+}
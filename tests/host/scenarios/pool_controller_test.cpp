@@ -0,0 +1,266 @@
+#include "host.h"
+#include "host_test.h"
+
+#include "esphome/components/api/custom_api_device.h"
+#include "esphome/components/pool_controller/pool_controller.h"
+#include "esphome/components/pool_controller/pool_heater.h"
+
+using namespace esphome;
+using namespace esphome::pool_controller;
+using esphome::host::RecordingOutput;
+
+namespace {
+
+/// Monday 2024-06-03 05:55:00 UTC.
+constexpr time_t MONDAY_EARLY = 1717394100;
+constexpr uint32_t SECOND = 1000;
+constexpr uint32_t MINUTE = 60 * SECOND;
+constexpr uint32_t HOUR = 60 * MINUTE;
+
+// What _schedules_to_code() generates for
+//   schedules:
+//     - name: Normal
+//       runtimes: [{start: "6:00", end: "8:00", minutes_per_hour: 30}, {start: "18:00", end: "19:00", ...: 60}]
+const char FILTER_SCHEDULE_NAMES[] = "Normal\0";
+const Schedule FILTER_SCHEDULES[] = {Schedule::pack(0, 0), Schedule::pack(7, 2)};
+const ScheduleRuntime FILTER_RUNTIMES[] = {ScheduleRuntime::pack(12, 16, 30, 0x7F), ScheduleRuntime::pack(36, 38, 60, 0x7F)};
+const Schedule NO_SCHEDULES[] = {Schedule::pack(0, 0)};
+
+struct Pool {
+  time::RealTimeClock rtc;
+  RecordingOutput filter_output;
+  RecordingOutput cleaner_output;
+  RecordingOutput heater_output;
+  PrimaryPumpSwitch filter;
+  AuxiliaryPumpSwitch cleaner;
+  ScheduleSelect filter_schedule;
+  ScheduleSelect cleaner_schedule;
+  sensor::Sensor water_temperature;
+  PoolHeater heater;
+  PoolController controller;
+
+  explicit Pool(time_t epoch = MONDAY_EARLY) {
+    this->rtc.synchronize_epoch(epoch);
+
+    this->filter.set_name("Filter Pump");
+    this->filter.set_output(&this->filter_output);
+    this->filter.set_schedules(FILTER_SCHEDULE_NAMES, FILTER_SCHEDULES, FILTER_RUNTIMES, 1);
+    this->filter.set_pool_heater(&this->heater);
+    this->cleaner.set_name("Cleaner Pump");
+    this->cleaner.set_output(&this->cleaner_output);
+    this->cleaner.set_schedules("", NO_SCHEDULES, nullptr, 0);
+    this->cleaner.set_primary_pump(&this->filter);
+
+    this->filter_schedule.set_name("Filter Pump Schedule");
+    this->filter_schedule.set_pump_switch(&this->filter);
+    this->filter_schedule.set_builtin_last_option("Always");
+    this->cleaner_schedule.set_name("Cleaner Pump Schedule");
+    this->cleaner_schedule.set_pump_switch(&this->cleaner);
+    this->cleaner_schedule.set_builtin_last_option("When Filter Pump is Running");
+
+    this->water_temperature.set_name("Water Temperature");
+    this->water_temperature.set_unit_of_measurement("\xc2\xb0\x43");
+    this->water_temperature.publish_state(25.0f);
+    this->heater.set_name("Pool Heater");
+    this->heater.set_temperature_sensor(&this->water_temperature);
+    this->heater.set_heater_output(&this->heater_output);
+    this->heater.set_primary_pump(&this->filter);
+
+    this->controller.set_rtc(&this->rtc);
+    this->controller.set_primary_pump(&this->filter);
+    this->controller.set_auxiliary_pumps({&this->cleaner});
+    this->controller.set_pool_heater(&this->heater);
+
+    App.register_component(&this->rtc);
+    App.register_component(&this->filter);
+    App.register_component(&this->cleaner);
+    App.register_component(&this->filter_schedule);
+    App.register_component(&this->cleaner_schedule);
+    App.register_component(&this->heater);
+    App.register_component(&this->controller);
+    App.setup();
+  }
+
+  static void select(ScheduleSelect &schedule, const char *option) {
+    auto call = schedule.make_call();
+    call.set_option(option);
+    call.perform();
+  }
+  /// millis() of the last write of `level` to `output`.
+  static uint32_t last_write(const RecordingOutput &output, bool level) {
+    uint32_t at = 0;
+    for (const auto &write : output.get_writes()) {
+      if (write.second == level)
+        at = write.first;
+    }
+    return at;
+  }
+};
+
+}  // namespace
+
+TEST_CASE(pumps_wait_five_minutes_after_boot) {
+  Pool pool;
+  CHECK_EQ(std::string(pool.filter_schedule.current_option()), std::string("Off"));
+  Pool::select(pool.filter_schedule, "Always");
+
+  App.run_for(4 * MINUTE + 59 * SECOND);
+  CHECK(!pool.filter_output.state());
+  App.run_for(2 * SECOND);
+  CHECK(pool.filter_output.state());
+}
+
+TEST_CASE(a_schedule_runs_its_minutes_in_each_half_hour) {
+  Pool pool;
+  Pool::select(pool.filter_schedule, "Normal");
+
+  // 05:55 to 06:00: outside the schedule.
+  App.run_for(5 * MINUTE - SECOND);
+  CHECK(!pool.filter_output.state());
+  App.run_for(2 * SECOND);
+  CHECK(pool.filter_output.state());
+
+  // 30 minutes per hour is 15 minutes per half hour.
+  App.run_for(15 * MINUTE - 2 * SECOND);
+  CHECK(pool.filter_output.state());
+  App.run_for(4 * SECOND);
+  CHECK(!pool.filter_output.state());
+  // The sequenced shutdown lets the pump run on for the 2 s sequence delay.
+  CHECK_EQ(pool.filter.get_runtime_seconds(), 15u * 60u + 2u);
+
+  // Back on for the next half hour, then off for good at 08:00.
+  App.run_for(15 * MINUTE);
+  CHECK(pool.filter_output.state());
+  App.run_for(HOUR + 30 * MINUTE);
+  CHECK(!pool.filter_output.state());
+  CHECK_EQ(pool.filter_output.get_transitions(), 8u);  // Four runs from 06:00 to 08:00.
+}
+
+TEST_CASE(the_cleaner_follows_the_filter_pump_in_sequence) {
+  Pool pool;
+  Pool::select(pool.filter_schedule, "Always");
+  Pool::select(pool.cleaner_schedule, "When Filter Pump is Running");
+  App.run_for(6 * MINUTE);
+  CHECK(pool.filter_output.state());
+  CHECK(pool.cleaner_output.state());
+  CHECK(Pool::last_write(pool.cleaner_output, true) - Pool::last_write(pool.filter_output, true) >= 2 * SECOND);
+
+  // Shutting down stops the cleaner first and the filter 2 s later.
+  Pool::select(pool.filter_schedule, "Off");
+  App.run_for(5 * SECOND);
+  CHECK(!pool.filter_output.state());
+  CHECK(!pool.cleaner_output.state());
+  CHECK(Pool::last_write(pool.filter_output, false) - Pool::last_write(pool.cleaner_output, false) >= 2 * SECOND);
+}
+
+TEST_CASE(the_heater_only_runs_with_water_flowing) {
+  Pool pool;
+  auto call = pool.heater.make_call();
+  call.set_mode(water_heater::WATER_HEATER_MODE_GAS);
+  call.set_target_temperature(28.0f);
+  call.perform();
+  Pool::select(pool.filter_schedule, "Always");
+
+  App.run_for(5 * MINUTE + 5 * SECOND);
+  CHECK(pool.filter_output.state());
+  CHECK(!pool.heater_output.state());  // Waiting for a reading of the water now moving past the sensor.
+  App.run_for(15 * SECOND);
+  CHECK(pool.heater_output.state());
+
+  pool.water_temperature.publish_state(28.3f);
+  App.run_for(SECOND);
+  CHECK(!pool.heater_output.state());
+  pool.water_temperature.publish_state(27.5f);
+  App.run_for(SECOND);
+  CHECK(pool.heater_output.state());
+
+  // The heater goes off before the pump stops, and stays off while the pump runs down.
+  const uint32_t transitions = pool.heater_output.get_transitions();
+  Pool::select(pool.filter_schedule, "Off");
+  App.run_for(5 * SECOND);
+  CHECK_EQ(pool.heater_output.get_transitions(), transitions + 1);
+  CHECK(!pool.heater_output.state());
+  CHECK(!pool.filter_output.state());
+  CHECK(Pool::last_write(pool.filter_output, false) - Pool::last_write(pool.heater_output, false) >= 2 * SECOND);
+}
+
+TEST_CASE(turning_the_pump_back_on_during_shutdown_keeps_it_heating) {
+  Pool pool;
+  auto call = pool.heater.make_call();
+  call.set_mode(water_heater::WATER_HEATER_MODE_GAS);
+  call.set_target_temperature(28.0f);
+  call.perform();
+  Pool::select(pool.filter_schedule, "Always");
+  App.run_for(5 * MINUTE + 20 * SECOND);
+  REQUIRE(pool.heater_output.state());
+
+  // Off by hand, then back on within the sequence delay.
+  pool.filter.turn_off();
+  App.run_for(SECOND);
+  CHECK(!pool.heater_output.state());
+  CHECK(pool.filter_output.state());
+  pool.filter.turn_on();
+  App.run_for(5 * SECOND);
+  CHECK(pool.filter_output.state());
+  CHECK_EQ(pool.filter_output.get_transitions(), 1u);
+  CHECK(pool.heater_output.state());
+
+  // A shutdown that runs to the end doesn't hold the heater off once the pump is back.
+  pool.filter.turn_off();
+  App.run_for(5 * SECOND);
+  CHECK(!pool.filter_output.state());
+  pool.filter.turn_on();
+  App.run_for(20 * SECOND);
+  CHECK(pool.filter_output.state());
+  CHECK(pool.heater_output.state());
+}
+
+TEST_CASE(schedules_loaded_by_the_service_survive_a_restart) {
+  {
+    Pool pool;
+    Pool::select(pool.filter_schedule, "Normal");
+    CHECK(api::host::call_service("set_pump_schedules", {"Filter Pump", "Normal=5:00-7:00/60;Night=0:00-2:00/20"}));
+    // Staged until the next schedule tick.
+    CHECK_EQ(pool.filter_schedule.size(), 3u);
+    App.run_for(2 * SECOND);
+    CHECK_EQ(pool.filter_schedule.size(), 4u);
+    CHECK_EQ(std::string(pool.filter_schedule.option_at(2)), std::string("Night"));
+    // Still on Normal, now the loaded one: 05:00-07:00 all the time.
+    CHECK_EQ(std::string(pool.filter_schedule.current_option()), std::string("Normal"));
+    App.run_for(5 * MINUTE);
+    CHECK(pool.filter_output.state());
+
+    // A bad definition is rejected and changes nothing.
+    CHECK(api::host::call_service("set_pump_schedules", {"Filter Pump", "Broken=5:15-7:00/60"}));
+    App.run_for(2 * SECOND);
+    CHECK_EQ(pool.filter_schedule.size(), 4u);
+    App.run_for(10 * MINUTE);
+  }
+
+  host::restart(true);
+  Pool pool(MONDAY_EARLY + 16 * 60);
+  CHECK_EQ(pool.filter_schedule.size(), 4u);
+  CHECK_EQ(std::string(pool.filter_schedule.current_option()), std::string("Normal"));
+  App.run_for(6 * MINUTE);
+  CHECK(pool.filter_output.state());
+}
+
+BENCHMARK(pool_controller_day) {
+  Pool pool;
+  auto call = pool.heater.make_call();
+  call.set_mode(water_heater::WATER_HEATER_MODE_GAS);
+  call.set_target_temperature(28.0f);
+  call.perform();
+  Pool::select(pool.filter_schedule, "Normal");
+  Pool::select(pool.cleaner_schedule, "When Filter Pump is Running");
+  pool.filter_output.set_recording(false);
+  pool.cleaner_output.set_recording(false);
+  pool.heater_output.set_recording(false);
+  App.run_for(HOUR);
+
+  host::Bench bench("pool_controller, filter on a schedule, cleaner following, heater, one day");
+  bench.run(24 * HOUR);
+  CHECK_EQ(bench.get_allocations(), 0u);
+  // The runtime counters are saved every half hour but only change while a pump runs.
+  CHECK(bench.get_flash_writes() <= 48u);
+}
@@ -0,0 +1,390 @@
+#include "host.h"
+#include "host_test.h"
+
+#include "esphome/components/api/custom_api_device.h"
+#include "esphome/components/treo_led_pool_light/treo_light.h"
+
+using namespace esphome;
+
+namespace {
+
+/// A Treo LED pool light on the end of a relay. Power cycling it within 2 s moves it on to the next of its 8 colors;
+/// being switched off for over 5 s, toggled on and off 3 times and switched off for over 5 s again brings it back to color 1
+/// on the next power on. Anything else leaves the color alone.
+class TreoLamp : public host::RecordingOutput {
+ public:
+  static constexpr uint32_t MIN_OFF_TIME = 50;       ///< Shorter drops don't reach the light's controller.
+  static constexpr uint32_t MAX_TOGGLE_TIME = 500;   ///< Longest on period counted as a reset toggle.
+  static constexpr uint32_t MAX_OFF_TIME = 2000;     ///< Longer off periods keep the color.
+  static constexpr uint32_t RESET_OFF_TIME = 5000;   ///< Shortest off period around the reset toggles.
+
+  TreoLamp() { this->restart(); }
+
+  uint8_t color() const { return this->color_; }
+  /// Puts the light on another color behind the controller's back, e.g. after someone flicked the breaker.
+  void set_color(uint8_t color) { this->color_ = color; }
+  uint32_t get_color_changes() const { return this->color_changes_; }
+  uint32_t get_resets() const { return this->resets_; }
+  /// The light has been without power for longer than a reset, e.g. the relay dropped out with the controller.
+  void restart() {
+    this->state_ = false;
+    this->off_since_ = millis() - RESET_OFF_TIME;
+    this->toggles_ = 0;
+    this->counting_toggles_ = false;
+  }
+
+ protected:
+  void write_state(bool state) override {
+    const bool was_on = this->state_;
+    host::RecordingOutput::write_state(state);
+    if (state == was_on)
+      return;
+    const uint32_t now = millis();
+    if (!state) {
+      if (this->counting_toggles_ && now - this->on_since_ <= MAX_TOGGLE_TIME) {
+        this->toggles_++;
+      } else {
+        this->counting_toggles_ = false;
+      }
+      this->off_since_ = now;
+      return;
+    }
+
+    this->on_since_ = now;
+    const uint32_t off_time = now - this->off_since_;
+    if (off_time >= RESET_OFF_TIME) {
+      if (this->counting_toggles_ && this->toggles_ == 3) {
+        this->color_ = 1;
+        this->resets_++;
+      }
+      this->counting_toggles_ = true;
+      this->toggles_ = 0;
+    } else if (off_time >= MIN_OFF_TIME && off_time <= MAX_OFF_TIME) {
+      this->color_ = this->color_ < 8 ? this->color_ + 1 : 1;
+      this->color_changes_++;
+    }
+  }
+
+  uint8_t color_{1};
+  uint32_t color_changes_{0};
+  uint32_t resets_{0};
+  uint32_t on_since_{0};
+  uint32_t off_since_{0};
+  uint8_t toggles_{0};
+  bool counting_toggles_{false};
+};
+
+struct Pool {
+  treo_light::TreoPoolLightOutput treo;
+  light::LightState light{&this->treo};
+  text_sensor::TextSensor plan;
+  treo_light::TreoPoolLightEffect slow_change{"Slow Change"}, white{"White"}, blue{"Blue"}, green{"Green"},
+      red{"Red"}, amber{"Amber"}, magenta{"Magenta"}, fast_change{"Fast Change"};
+
+  explicit Pool(TreoLamp *lamp, uint32_t off_time = 200, uint32_t on_time = 200)
+      : Pool(std::vector<TreoLamp *>{lamp}, off_time, on_time) {}
+  /// Several lamps on their own relays, driven in lockstep.
+  explicit Pool(const std::vector<TreoLamp *> &lamps, uint32_t off_time = 200, uint32_t on_time = 200) {
+    this->light.set_name("Pool Light");
+    this->light.add_effects({&this->slow_change, &this->white, &this->blue, &this->green, &this->red, &this->amber,
+                             &this->magenta, &this->fast_change});
+    for (auto *lamp : lamps)
+      this->treo.add_output(lamp);
+    this->treo.set_color_change_off_time(off_time);
+    this->treo.set_color_change_on_time(on_time);
+    this->treo.set_transition_plan_sensor(&this->plan);
+    App.register_component(&this->treo);
+    App.register_component(&this->light);
+    App.setup();
+    App.run_for(100);
+  }
+
+  void pick(const char *effect) {
+    auto call = this->light.turn_on();
+    call.set_effect(effect);
+    call.perform();
+  }
+};
+
+/// Steps through the colors from the main loop, like an automation changing the light every `period` ms.
+class ColorCycler : public Component {
+ public:
+  ColorCycler(light::LightState *light, uint32_t period) : light_(light), period_(period) {}
+  void setup() override {
+    this->set_interval("cycle", this->period_, [this]() {
+      this->next_ = this->next_ < 8 ? this->next_ + 1 : 1;
+      auto call = this->light_->turn_on();
+      call.set_effect(this->next_);
+      call.perform();
+    });
+  }
+
+ protected:
+  light::LightState *light_;
+  uint32_t period_;
+  uint32_t next_{1};
+};
+
+/// (start, end) of every time `lamp` was switched off since `since`.
+std::vector<std::pair<uint32_t, uint32_t>> off_periods(const TreoLamp &lamp, uint32_t since) {
+  std::vector<std::pair<uint32_t, uint32_t>> periods;
+  const auto &writes = lamp.get_writes();
+  for (size_t i = 1; i < writes.size(); i++) {
+    if (writes[i - 1].first >= since && writes[i - 1].second && !writes[i].second)
+      periods.emplace_back(writes[i].first, UINT32_MAX);
+    else if (!periods.empty() && !writes[i - 1].second && writes[i].second && periods.back().second == UINT32_MAX)
+      periods.back().second = writes[i].first;
+  }
+  return periods;
+}
+
+}  // namespace
+
+TEST_CASE(turning_on_shows_the_current_color) {
+  TreoLamp lamp;
+  Pool pool(&lamp);
+  CHECK(!lamp.state());
+
+  pool.light.turn_on().perform();
+  App.run_for(100);
+  CHECK(lamp.state());
+  CHECK_EQ(pool.light.get_effect_name(), std::string("Slow Change"));
+  CHECK_EQ(lamp.get_transitions(), 1u);
+}
+
+TEST_CASE(picking_a_color_steps_the_light_forward) {
+  TreoLamp lamp;
+  Pool pool(&lamp);
+  pool.light.turn_on().perform();
+  App.run_for(100);
+
+  const uint32_t picked = millis();
+  pool.pick("Red");
+  App.run_for(2000);
+  CHECK(lamp.state());
+  CHECK_EQ(lamp.color(), 5);
+  CHECK_EQ(lamp.get_color_changes(), 4u);
+  CHECK_EQ(pool.plan.state, std::string("Forward x4 (1800 ms)"));
+
+  // Every off period is the configured time, never shorter, or the light could miss a color.
+  const auto &writes = lamp.get_writes();
+  for (size_t i = 1; i < writes.size(); i++) {
+    if (writes[i - 1].first >= picked && !writes[i - 1].second && writes[i].second)
+      CHECK(writes[i].first - writes[i - 1].first >= 200);
+  }
+
+  // Wrapping around past Fast Change.
+  pool.pick("White");
+  App.run_for(3000);
+  CHECK_EQ(lamp.color(), 2);
+  CHECK_EQ(lamp.get_color_changes(), 9u);
+}
+
+TEST_CASE(slow_steps_go_the_short_way_round_through_a_reset) {
+  TreoLamp lamp;
+  Pool pool(&lamp, 1000, 1000);
+  pool.light.turn_on().perform();
+  App.run_for(100);
+  pool.pick("White");
+  App.run_for(5000);
+  CHECK_EQ(lamp.color(), 2);
+
+  // Seven forward steps would take 15 s, the reset gets back to color 1 in about 13 s.
+  pool.pick("Slow Change");
+  App.run_for(100);
+  CHECK_EQ(pool.plan.state, std::string("Reset then forward x0 (13250 ms)"));
+  App.run_for(15000);
+  CHECK_EQ(lamp.get_resets(), 1u);
+  CHECK_EQ(lamp.color(), 1);
+  CHECK(lamp.state());
+}
+
+TEST_CASE(color_reset_resyncs_a_light_that_drifted) {
+  TreoLamp lamp;
+  Pool pool(&lamp);
+  pool.light.turn_on().perform();
+  App.run_for(100);
+  pool.pick("Green");
+  App.run_for(2000);
+  CHECK_EQ(lamp.color(), 4);
+
+  lamp.set_color(7);
+  CHECK(api::host::call_service("color_reset"));
+  App.run_for(15000);
+  CHECK_EQ(lamp.get_resets(), 1u);
+  CHECK_EQ(lamp.color(), 4);
+  CHECK(lamp.state());
+}
+
+TEST_CASE(a_color_picked_during_a_transition_takes_over) {
+  TreoLamp lamp;
+  Pool pool(&lamp);
+  pool.light.turn_on().perform();
+  App.run_for(100);
+
+  pool.pick("Magenta");
+  App.run_for(700);
+  pool.pick("Blue");
+  App.run_for(3000);
+  CHECK_EQ(lamp.color(), 3);
+  CHECK(lamp.state());
+
+  // Going past the new color and back round would have taken at least 8 changes.
+  CHECK(lamp.get_color_changes() < 8u);
+}
+
+TEST_CASE(turning_off_during_a_transition_stops_on_a_known_color) {
+  TreoLamp lamp;
+  Pool pool(&lamp);
+  pool.light.turn_on().perform();
+  App.run_for(100);
+
+  pool.pick("Magenta");
+  App.run_for(700);
+  pool.light.turn_off().perform();
+  App.run_for(3000);
+  CHECK(!lamp.state());
+  const uint8_t stopped_at = lamp.color();
+  CHECK(stopped_at > 1 && stopped_at < 7);
+
+  // Turned back on, it carries on from where the light is.
+  pool.pick("Magenta");
+  App.run_for(3000);
+  CHECK_EQ(lamp.color(), 7);
+  CHECK_EQ(lamp.get_color_changes(), 6u);
+}
+
+TEST_CASE(lamps_on_different_colors_meet_on_the_target) {
+  // Saved when the lamps were last seen: the first on Blue, the second on Amber.
+  treo_light::ColorRecord record;
+  record.colors = {3, 6, 1, 1};
+  record.target = 3;
+  global_preferences->make_preference<treo_light::ColorRecord>(fnv1_hash("pool_light") ^ 2).save(&record);
+  global_preferences->sync();
+  host::restart();
+
+  TreoLamp first;
+  TreoLamp second;
+  first.set_color(3);
+  second.set_color(6);
+  Pool pool({&first, &second});
+  pool.light.turn_on().perform();
+  App.run_for(100);
+
+  const uint32_t picked = millis();
+  pool.pick("Magenta");
+  App.run_for(3000);
+  CHECK_EQ(first.color(), 7);
+  CHECK_EQ(second.color(), 7);
+  CHECK(first.state());
+  CHECK(second.state());
+
+  // Both lamps are clocked by the same pulses: the second takes the one it needs together with the first and stays
+  // on through the rest, and every off period is the configured time.
+  const auto first_pulses = off_periods(first, picked);
+  const auto second_pulses = off_periods(second, picked);
+  REQUIRE(first_pulses.size() == 4u);
+  REQUIRE(second_pulses.size() == 1u);
+  CHECK(second_pulses[0] == first_pulses[0]);
+  for (const auto &[off, on] : first_pulses)
+    CHECK_EQ(on - off, 200u);
+}
+
+TEST_CASE(a_color_reset_brings_a_drifted_lamp_back_in_step) {
+  TreoLamp first;
+  TreoLamp second;
+  Pool pool({&first, &second});
+  pool.light.turn_on().perform();
+  App.run_for(100);
+  pool.pick("Green");
+  App.run_for(2000);
+
+  // Someone flicked the second lamp's breaker, the controller doesn't know.
+  second.set_color(6);
+  const uint32_t reset = millis();
+  CHECK(api::host::call_service("color_reset"));
+  App.run_for(15000);
+  CHECK_EQ(first.color(), 4);
+  CHECK_EQ(second.color(), 4);
+  CHECK_EQ(first.get_resets(), 1u);
+  CHECK_EQ(second.get_resets(), 1u);
+  CHECK(off_periods(first, reset) == off_periods(second, reset));
+}
+
+TEST_CASE(a_transition_cut_short_by_a_crash_resumes) {
+  TreoLamp lamp;
+  {
+    Pool pool(&lamp);
+    pool.light.turn_on().perform();
+    App.run_for(100);
+    pool.pick("Magenta");
+    // Well inside the first minute, before any periodic sync.
+    App.run_for(1100);
+  }
+  const uint8_t reached = lamp.color();
+  CHECK(reached > 1 && reached < 7);
+
+  host::restart(false);
+  lamp.restart();
+  Pool pool(&lamp);
+  pool.pick("Magenta");
+  App.run_for(3000);
+  // The progress in RTC memory tells it where the light got to, no reset needed.
+  CHECK_EQ(lamp.get_resets(), 0u);
+  CHECK_EQ(lamp.color(), 7);
+}
+
+TEST_CASE(a_transition_cut_short_by_a_power_loss_is_resynced) {
+  TreoLamp lamp;
+  {
+    Pool pool(&lamp);
+    pool.light.turn_on().perform();
+    App.run_for(100);
+    pool.pick("Magenta");
+    App.run_for(1100);
+  }
+
+  host::restart(true);
+  lamp.restart();
+  Pool pool(&lamp);
+  pool.pick("Magenta");
+  App.run_for(20000);
+  CHECK_EQ(lamp.get_resets(), 1u);
+  CHECK_EQ(lamp.color(), 7);
+  CHECK(lamp.state());
+}
+
+TEST_CASE(the_color_saved_by_the_single_light_firmware_is_kept) {
+  // Earlier versions saved a single byte under the light's own preference.
+  const uint8_t saved = 5;
+  global_preferences->make_preference<uint32_t>(fnv1_hash("pool_light")).save(&saved);
+  global_preferences->sync();
+  host::restart();
+
+  TreoLamp lamp;
+  lamp.set_color(5);
+  Pool pool(&lamp);
+  pool.pick("Magenta");
+  App.run_for(3000);
+  CHECK_EQ(lamp.color(), 7);
+  CHECK_EQ(lamp.get_color_changes(), 2u);
+  CHECK_EQ(lamp.get_resets(), 0u);
+}
+
+BENCHMARK(treo_led_pool_light_evening) {
+  TreoLamp lamp;
+  Pool pool(&lamp);
+  pool.treo.set_transition_plan_sensor(nullptr);  // Publishing the plan builds a string, not what is measured here.
+  lamp.set_recording(false);
+  ColorCycler cycler(&pool.light, 10 * 60 * 1000);
+  App.register_component(&cycler);
+  cycler.setup();
+  App.run_for(20 * 60 * 1000);  // Warm up the scheduler's item pool.
+
+  host::Bench bench("treo_led_pool_light, color changed every 10 min, 4 h");
+  bench.run(4 * 60 * 60 * 1000);
+  CHECK_EQ(bench.get_allocations(), 0u);
+  CHECK_EQ(static_cast<uint32_t>(lamp.color()), pool.light.get_current_effect_index());
+  // The record synced as a transition starts, and the completed one at the next periodic sync.
+  CHECK(bench.get_flash_writes() <= 2u * 24u);
+}
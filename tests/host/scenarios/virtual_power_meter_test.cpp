@@ -0,0 +1,161 @@
+#include "host.h"
+#include "host_test.h"
+
+#include "esphome/components/light/light_output.h"
+#include "esphome/components/virtual_power_meter/virtual_power_meter.h"
+
+#include <vector>
+
+using namespace esphome;
+
+namespace {
+
+/// 2024-06-01 12:00:00 UTC.
+constexpr time_t NOON = 1717243200;
+
+struct Meter {
+  host::TemplateSwitch source;
+  sensor::Sensor power;
+  sensor::Sensor energy;
+  time::RealTimeClock clock;
+  virtual_power_meter::VirtualPowerMeter meter;
+
+  explicit Meter(time_t epoch, bool on = false) {
+    this->energy.set_name("Pump Energy");
+    this->source.publish_state(on);
+    this->clock.synchronize_epoch(epoch);
+    this->meter.set_switch(&this->source);
+    this->meter.set_power(100.0f);
+    this->meter.set_power_sensor(&this->power);
+    this->meter.set_energy_sensor(&this->energy);
+    this->meter.set_time(&this->clock);
+    App.register_component(&this->meter);
+    App.setup();
+  }
+};
+
+class OnOffLight : public light::LightOutput {
+ public:
+  light::LightTraits get_traits() override {
+    light::LightTraits traits;
+    traits.set_supported_color_modes({light::ColorMode::ON_OFF});
+    return traits;
+  }
+  void write_state(light::LightState *state) override {}
+};
+
+/// Toggles a switch every `period` ms from the main loop, like an automation would.
+class Toggler : public Component {
+ public:
+  Toggler(switch_::Switch *target, uint32_t period) : target_(target), period_(period) {}
+  void setup() override {
+    this->set_interval("toggle", this->period_, [this]() { this->target_->toggle(); });
+  }
+
+ protected:
+  switch_::Switch *target_;
+  uint32_t period_;
+};
+
+}  // namespace
+
+TEST_CASE(an_hour_on_at_100_w) {
+  Meter meter(NOON);
+  CHECK_EQ(meter.power.state, 0.0f);
+
+  meter.source.turn_on();
+  CHECK_EQ(meter.power.state, 100.0f);
+  App.run_for(60 * 60 * 1000);
+  meter.source.turn_off();
+  CHECK_EQ(meter.power.state, 0.0f);
+  App.run_for(60 * 1000);
+  CHECK_NEAR(meter.energy.state, 100.0f, 0.001f);
+
+  // Nothing is used while off.
+  App.run_for(60 * 60 * 1000);
+  CHECK_NEAR(meter.energy.state, 100.0f, 0.001f);
+}
+
+TEST_CASE(energy_survives_a_power_cut) {
+  {
+    Meter meter(NOON, true);
+    App.run_for(65 * 60 * 1000 + 30 * 1000);
+    CHECK_NEAR(meter.energy.state, 100.0f * 65 / 60, 0.01f);
+  }
+  // The last flash write was at the 60 minute sync; the minutes after it are lost with the power.
+  host::restart(true);
+  Meter meter(NOON + 66 * 60);
+  CHECK_NEAR(meter.energy.state, 100.0f, 0.01f);
+}
+
+TEST_CASE(energy_from_yesterday_is_not_restored) {
+  {
+    Meter meter(NOON, true);
+    App.run_for(60 * 60 * 1000);
+  }
+  host::restart(true);
+  Meter meter(NOON + 24 * 60 * 60);
+  App.run_for(60 * 1000);
+  CHECK_EQ(meter.energy.state, 0.0f);
+}
+
+TEST_CASE(energy_resets_at_midnight) {
+  Meter meter(NOON + 11 * 60 * 60, true);  // 23:00
+  App.run_for(60 * 60 * 1000 + 30 * 1000);
+  // The 00:00 update closed yesterday's hour and reset it; 30 s of today were published since.
+  CHECK_NEAR(meter.energy.state, 0.0f, 0.001f);
+  App.run_for(60 * 1000);
+  CHECK_NEAR(meter.energy.state, 100.0f * 60 / 3600, 0.01f);
+}
+
+TEST_CASE(an_update_over_midnight_is_split_between_the_days) {
+  Meter meter(NOON + 11 * 60 * 60 + 30, true);  // 23:00:30, so the updates fall on the half minute.
+  std::vector<float> published;
+  meter.energy.add_on_state_callback([&published](float state) { published.push_back(state); });
+  App.run_for(60 * 60 * 1000 + 1000);
+  // The 00:00:30 update closed yesterday at midnight, 59.5 minutes on, and started today with the 30 s since.
+  REQUIRE(published.size() >= 2);
+  CHECK_NEAR(published[published.size() - 2], 100.0f * 59.5f / 60, 0.01f);
+  CHECK_NEAR(published.back(), 100.0f * 30 / 3600, 0.01f);
+  App.run_for(60 * 1000);
+  CHECK_NEAR(meter.energy.state, 100.0f * 90 / 3600, 0.01f);
+}
+
+TEST_CASE(a_light_as_the_source) {
+  OnOffLight output;
+  light::LightState light(&output);
+  sensor::Sensor power;
+  sensor::Sensor energy;
+  time::RealTimeClock clock;
+  clock.synchronize_epoch(NOON);
+  virtual_power_meter::VirtualPowerMeter meter;
+  meter.set_light(&light);
+  meter.set_power(100.0f);
+  meter.set_power_sensor(&power);
+  meter.set_energy_sensor(&energy);
+  meter.set_time(&clock);
+  App.register_component(&light);
+  App.register_component(&meter);
+  App.setup();
+
+  light.turn_on().perform();
+  CHECK_EQ(power.state, 100.0f);
+  App.run_for(30 * 60 * 1000);
+  light.turn_off().perform();
+  CHECK_EQ(power.state, 0.0f);
+  App.run_for(60 * 1000);
+  CHECK_NEAR(energy.state, 50.0f, 0.001f);
+}
+
+BENCHMARK(virtual_power_meter_day) {
+  Meter meter(NOON);
+  Toggler toggler(&meter.source, 10 * 60 * 1000);
+  App.register_component(&toggler);
+  toggler.setup();
+
+  host::Bench bench("virtual_power_meter, switch toggled every 10 min, one day");
+  bench.run(24 * 60 * 60 * 1000);
+  CHECK_EQ(bench.get_allocations(), 0u);
+  // Saved at most once a minute while on, written at most once per 10 minute sync.
+  CHECK(bench.get_flash_writes() <= 24u * 6u);
+}
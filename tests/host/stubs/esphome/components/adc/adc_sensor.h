@@ -0,0 +1,29 @@
+#pragma once
+
+#include <functional>
+
+#include "esphome/core/component.h"
+#include "esphome/components/sensor/sensor.h"
+
+namespace esphome::adc {
+
+/// An ADC input whose readings come from a function the test provides, e.g. one that looks at which outputs are
+/// powered. sample() returns raw counts, as on a device configured with `raw: true`.
+class ADCSensor : public sensor::Sensor, public PollingComponent {
+ public:
+  void update() override { this->publish_state(this->sample()); }
+  float sample() {
+    this->samples_++;
+    return this->sampler_ ? this->sampler_() : NAN;
+  }
+
+  // Host only.
+  void set_sampler(std::function<float()> &&sampler) { this->sampler_ = std::move(sampler); }
+  uint32_t get_sample_count() const { return this->samples_; }
+
+ protected:
+  std::function<float()> sampler_;
+  uint32_t samples_{0};
+};
+
+}  // namespace esphome::adc
@@ -0,0 +1,18 @@
+#include "esphome/components/api/custom_api_device.h"
+
+namespace esphome::api::host {
+
+std::map<std::string, Service> &services() {
+  static std::map<std::string, Service> instance;
+  return instance;
+}
+
+bool call_service(const std::string &name, const std::vector<std::string> &args) {
+  auto it = services().find(name);
+  if (it == services().end() || it->second.arg_count != args.size())
+    return false;
+  it->second.run(args);
+  return true;
+}
+
+}  // namespace esphome::api::host
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace esphome::api {
+
+namespace host {
+
+/// A service registered by a component. A test calls it with its arguments as strings, as Home Assistant would
+/// send them.
+struct Service {
+  size_t arg_count;
+  std::function<void(const std::vector<std::string> &)> run;
+};
+std::map<std::string, Service> &services();
+/// Calls the service `name`, returns false if no component registered it or the argument count is wrong.
+bool call_service(const std::string &name, const std::vector<std::string> &args = {});
+
+template<typename T> T service_arg(const std::string &value);
+template<> inline std::string service_arg<std::string>(const std::string &value) { return value; }
+template<> inline bool service_arg<bool>(const std::string &value) { return value == "true" || value == "1"; }
+template<> inline int32_t service_arg<int32_t>(const std::string &value) { return std::atoi(value.c_str()); }
+template<> inline float service_arg<float>(const std::string &value) { return std::strtof(value.c_str(), nullptr); }
+
+}  // namespace host
+
+class CustomAPIDevice {
+ public:
+  template<typename T, typename... Ts>
+  void register_service(void (T::*callback)(Ts...), const std::string &name,
+                        const std::array<std::string, sizeof...(Ts)> &arg_names = {}) {
+    T *obj = static_cast<T *>(this);
+    host::services()[name] = {sizeof...(Ts), [obj, callback](const std::vector<std::string> &args) {
+                                call_(obj, callback, args, std::index_sequence_for<Ts...>{});
+                              }};
+  }
+
+ protected:
+  template<typename T, typename... Ts, size_t... Is>
+  static void call_(T *obj, void (T::*callback)(Ts...), const std::vector<std::string> &args,
+                    std::index_sequence<Is...>) {
+    (obj->*callback)(host::service_arg<std::decay_t<Ts>>(args[Is])...);
+  }
+};
+
+}  // namespace esphome::api
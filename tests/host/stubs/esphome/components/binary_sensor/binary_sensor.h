@@ -0,0 +1,34 @@
+#pragma once
+
+#include <functional>
+
+#include "esphome/core/entity_base.h"
+#include "esphome/core/helpers.h"
+
+namespace esphome::binary_sensor {
+
+/// A binary sensor without filters. As on a device, publishing the state it already has does nothing.
+class BinarySensor : public EntityBase {
+ public:
+  void publish_state(bool state) {
+    if (this->has_state_ && state == this->state)
+      return;
+    this->state = state;
+    this->has_state_ = true;
+    this->callback_.call(state);
+  }
+  void publish_initial_state(bool state) {
+    this->has_state_ = false;
+    this->publish_state(state);
+  }
+  bool has_state() const { return this->has_state_; }
+  void add_on_state_callback(std::function<void(bool)> &&callback) { this->callback_.add(std::move(callback)); }
+
+  bool state{false};
+
+ protected:
+  CallbackManager<void(bool)> callback_;
+  bool has_state_{false};
+};
+
+}  // namespace esphome::binary_sensor
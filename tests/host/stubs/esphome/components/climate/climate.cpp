@@ -0,0 +1,106 @@
+#include "esphome/components/climate/climate.h"
+
+namespace esphome::climate {
+
+const char *climate_mode_to_string(ClimateMode mode) {
+  switch (mode) {
+    case CLIMATE_MODE_OFF:
+      return "OFF";
+    case CLIMATE_MODE_HEAT_COOL:
+      return "HEAT_COOL";
+    case CLIMATE_MODE_COOL:
+      return "COOL";
+    case CLIMATE_MODE_HEAT:
+      return "HEAT";
+    case CLIMATE_MODE_FAN_ONLY:
+      return "FAN_ONLY";
+    case CLIMATE_MODE_DRY:
+      return "DRY";
+    case CLIMATE_MODE_AUTO:
+      return "AUTO";
+    default:
+      return "UNKNOWN";
+  }
+}
+
+const char *climate_action_to_string(ClimateAction action) {
+  switch (action) {
+    case CLIMATE_ACTION_OFF:
+      return "OFF";
+    case CLIMATE_ACTION_COOLING:
+      return "COOLING";
+    case CLIMATE_ACTION_HEATING:
+      return "HEATING";
+    case CLIMATE_ACTION_IDLE:
+      return "IDLE";
+    case CLIMATE_ACTION_DRYING:
+      return "DRYING";
+    case CLIMATE_ACTION_FAN:
+      return "FAN";
+    default:
+      return "UNKNOWN";
+  }
+}
+
+void ClimateCall::validate_() {
+  const ClimateTraits traits = this->parent_->get_traits();
+  if (this->mode_.has_value() && !traits.supports_mode(*this->mode_))
+    this->mode_.reset();
+  if (traits.get_supports_two_point_target_temperature()) {
+    this->target_temperature_.reset();
+  } else {
+    this->target_temperature_low_.reset();
+    this->target_temperature_high_.reset();
+  }
+}
+
+void ClimateCall::perform() {
+  this->validate_();
+  this->parent_->control(*this);
+}
+
+ClimateCall ClimateDeviceRestoreState::to_call(Climate *climate) {
+  ClimateCall call = climate->make_call();
+  call.set_mode(this->mode);
+  if (climate->get_traits().get_supports_two_point_target_temperature()) {
+    call.set_target_temperature_low(this->target_temperature_low);
+    call.set_target_temperature_high(this->target_temperature_high);
+  } else {
+    call.set_target_temperature(this->target_temperature);
+  }
+  return call;
+}
+
+void ClimateDeviceRestoreState::apply(Climate *climate) {
+  climate->mode = this->mode;
+  climate->target_temperature = this->target_temperature;
+  climate->target_temperature_low = this->target_temperature_low;
+  climate->target_temperature_high = this->target_temperature_high;
+  climate->publish_state();
+}
+
+void Climate::publish_state() {
+  this->callback_.call(*this);
+  this->save_state_();
+}
+
+optional<ClimateDeviceRestoreState> Climate::restore_state_() {
+  this->rtc_ = this->make_entity_preference<ClimateDeviceRestoreState>();
+  this->rtc_created_ = true;
+  ClimateDeviceRestoreState recovered{};
+  if (!this->rtc_.load(&recovered))
+    return {};
+  return recovered;
+}
+
+void Climate::save_state_() {
+  if (!this->rtc_created_) {
+    this->rtc_ = this->make_entity_preference<ClimateDeviceRestoreState>();
+    this->rtc_created_ = true;
+  }
+  ClimateDeviceRestoreState state{this->mode, this->target_temperature, this->target_temperature_low,
+                                  this->target_temperature_high};
+  this->rtc_.save(&state);
+}
+
+}  // namespace esphome::climate
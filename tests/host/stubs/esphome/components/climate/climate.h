@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <set>
+
+#include "esphome/core/entity_base.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/optional.h"
+#include "esphome/core/preferences.h"
+
+namespace esphome::climate {
+
+enum ClimateMode : uint8_t {
+  CLIMATE_MODE_OFF = 0,
+  CLIMATE_MODE_HEAT_COOL = 1,
+  CLIMATE_MODE_COOL = 2,
+  CLIMATE_MODE_HEAT = 3,
+  CLIMATE_MODE_FAN_ONLY = 4,
+  CLIMATE_MODE_DRY = 5,
+  CLIMATE_MODE_AUTO = 6,
+};
+
+enum ClimateAction : uint8_t {
+  CLIMATE_ACTION_OFF = 0,
+  CLIMATE_ACTION_COOLING = 2,
+  CLIMATE_ACTION_HEATING = 3,
+  CLIMATE_ACTION_IDLE = 4,
+  CLIMATE_ACTION_DRYING = 5,
+  CLIMATE_ACTION_FAN = 6,
+};
+
+enum ClimateFeature : uint32_t {
+  CLIMATE_SUPPORTS_CURRENT_TEMPERATURE = 1 << 0,
+  CLIMATE_SUPPORTS_TWO_POINT_TARGET_TEMPERATURE = 1 << 1,
+  CLIMATE_REQUIRES_TWO_POINT_TARGET_TEMPERATURE = 1 << 2,
+  CLIMATE_SUPPORTS_CURRENT_HUMIDITY = 1 << 3,
+  CLIMATE_SUPPORTS_TARGET_HUMIDITY = 1 << 4,
+  CLIMATE_SUPPORTS_ACTION = 1 << 5,
+};
+
+const char *climate_mode_to_string(ClimateMode mode);
+const char *climate_action_to_string(ClimateAction action);
+
+class ClimateTraits {
+ public:
+  void set_feature_flags(uint32_t flags) { this->feature_flags_ = flags; }
+  void add_feature_flags(uint32_t flags) { this->feature_flags_ |= flags; }
+  bool has_feature_flags(uint32_t flags) const { return (this->feature_flags_ & flags) == flags; }
+  uint32_t get_feature_flags() const { return this->feature_flags_; }
+  void add_supported_mode(ClimateMode mode) { this->supported_modes_.insert(mode); }
+  void set_supported_modes(std::set<ClimateMode> modes) { this->supported_modes_ = std::move(modes); }
+  const std::set<ClimateMode> &get_supported_modes() const { return this->supported_modes_; }
+  bool supports_mode(ClimateMode mode) const { return this->supported_modes_.count(mode) != 0; }
+  bool get_supports_two_point_target_temperature() const {
+    return this->feature_flags_ &
+           (CLIMATE_SUPPORTS_TWO_POINT_TARGET_TEMPERATURE | CLIMATE_REQUIRES_TWO_POINT_TARGET_TEMPERATURE);
+  }
+
+ protected:
+  uint32_t feature_flags_{0};
+  std::set<ClimateMode> supported_modes_;
+};
+
+class Climate;
+
+/// A request to change a climate device; perform() drops whatever the traits don't support and hands the rest to
+/// Climate::control().
+class ClimateCall {
+ public:
+  explicit ClimateCall(Climate *parent) : parent_(parent) {}
+
+  ClimateCall &set_mode(ClimateMode mode) {
+    this->mode_ = mode;
+    return *this;
+  }
+  ClimateCall &set_target_temperature(float target_temperature) {
+    this->target_temperature_ = target_temperature;
+    return *this;
+  }
+  ClimateCall &set_target_temperature_low(float target_temperature_low) {
+    this->target_temperature_low_ = target_temperature_low;
+    return *this;
+  }
+  ClimateCall &set_target_temperature_high(float target_temperature_high) {
+    this->target_temperature_high_ = target_temperature_high;
+    return *this;
+  }
+
+  const optional<ClimateMode> &get_mode() const { return this->mode_; }
+  const optional<float> &get_target_temperature() const { return this->target_temperature_; }
+  const optional<float> &get_target_temperature_low() const { return this->target_temperature_low_; }
+  const optional<float> &get_target_temperature_high() const { return this->target_temperature_high_; }
+
+  void perform();
+
+ protected:
+  void validate_();
+
+  Climate *parent_;
+  optional<ClimateMode> mode_;
+  optional<float> target_temperature_;
+  optional<float> target_temperature_low_;
+  optional<float> target_temperature_high_;
+};
+
+/// What is saved on every publish_state() and restored at boot.
+struct ClimateDeviceRestoreState {
+  ClimateMode mode;
+  float target_temperature;
+  float target_temperature_low;
+  float target_temperature_high;
+
+  ClimateCall to_call(Climate *climate);
+  void apply(Climate *climate);
+};
+
+class Climate : public EntityBase {
+ public:
+  virtual ~Climate() = default;
+
+  /// Sends the state to the frontends and saves the restore state.
+  void publish_state();
+  ClimateCall make_call() { return ClimateCall(this); }
+  ClimateTraits get_traits() { return this->traits(); }
+  void add_on_state_callback(std::function<void(Climate &)> &&callback) { this->callback_.add(std::move(callback)); }
+
+  ClimateMode mode{CLIMATE_MODE_OFF};
+  ClimateAction action{CLIMATE_ACTION_OFF};
+  float current_temperature{NAN};
+  float current_humidity{NAN};
+  float target_temperature{NAN};
+  float target_temperature_low{NAN};
+  float target_temperature_high{NAN};
+
+ protected:
+  friend class ClimateCall;
+
+  virtual ClimateTraits traits() = 0;
+  virtual void control(const ClimateCall &call) = 0;
+  optional<ClimateDeviceRestoreState> restore_state_();
+  void save_state_();
+
+  CallbackManager<void(Climate &)> callback_;
+  ESPPreferenceObject rtc_;
+  bool rtc_created_{false};
+};
+
+}  // namespace esphome::climate
@@ -0,0 +1,59 @@
+#include "esphome/components/econet/econet.h"
+
+#include "esphome/core/hal.h"
+
+namespace esphome::econet {
+
+void Econet::register_listener(const std::string &datapoint_id, int8_t request_mod, bool request_once,
+                               const std::function<void(const EconetDatapoint &datapoint)> &func,
+                               bool is_raw_datapoint, uint32_t src_adr) {
+  this->listeners_.push_back({datapoint_id, request_mod, request_once, src_adr, func});
+}
+
+void Econet::set_float_datapoint_value(const std::string &datapoint_id, float value, uint32_t address) {
+  this->write_({datapoint_id, EconetDatapointType::FLOAT, value, 0, address, millis()});
+}
+
+void Econet::set_enum_datapoint_value(const std::string &datapoint_id, uint8_t value, uint32_t address) {
+  this->write_({datapoint_id, EconetDatapointType::ENUM_TEXT, 0.0f, value, address, millis()});
+}
+
+void Econet::write_(host::EconetWrite &&write) {
+  if (this->write_handler_) {
+    this->write_handler_(write);
+    return;
+  }
+  this->writes_.push_back(std::move(write));
+}
+
+void Econet::publish_datapoint(const std::string &datapoint_id, uint32_t src_adr, const EconetDatapoint &datapoint) {
+  // Listeners can register or write from their callback, so walk by index over the ones present now.
+  const size_t count = this->listeners_.size();
+  for (size_t i = 0; i < count; i++) {
+    if (this->listeners_[i].datapoint_id == datapoint_id && this->listeners_[i].src_adr == src_adr)
+      this->listeners_[i].callback(datapoint);
+  }
+}
+
+void Econet::publish_float(const std::string &datapoint_id, uint32_t src_adr, float value) {
+  EconetDatapoint datapoint;
+  datapoint.type = EconetDatapointType::FLOAT;
+  datapoint.value_float = value;
+  this->publish_datapoint(datapoint_id, src_adr, datapoint);
+}
+
+void Econet::publish_enum(const std::string &datapoint_id, uint32_t src_adr, uint8_t value) {
+  EconetDatapoint datapoint;
+  datapoint.type = EconetDatapointType::ENUM_TEXT;
+  datapoint.value_enum = value;
+  this->publish_datapoint(datapoint_id, src_adr, datapoint);
+}
+
+void Econet::publish_text(const std::string &datapoint_id, uint32_t src_adr, const std::string &value) {
+  EconetDatapoint datapoint;
+  datapoint.type = EconetDatapointType::TEXT;
+  datapoint.value_string = value;
+  this->publish_datapoint(datapoint_id, src_adr, datapoint);
+}
+
+}  // namespace esphome::econet
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "esphome/core/component.h"
+
+namespace esphome::econet {
+
+enum class EconetDatapointType : uint8_t {
+  FLOAT = 0,
+  TEXT = 1,
+  ENUM_TEXT = 2,
+  RAW = 4,
+  UNSUPPORTED = 5,
+};
+
+struct EconetDatapoint {
+  EconetDatapointType type{EconetDatapointType::UNSUPPORTED};
+  float value_float{0.0f};
+  uint8_t value_enum{0};
+  std::string value_string;
+  std::vector<uint8_t> value_raw;
+};
+
+namespace host {
+
+/// A datapoint write a client sent to the bus.
+struct EconetWrite {
+  std::string datapoint_id;
+  EconetDatapointType type;
+  float value_float;
+  uint8_t value_enum;
+  uint32_t src_adr;
+  uint32_t time;  ///< millis() when it was sent.
+};
+
+}  // namespace host
+
+/// The bus side of the esphome-econet component. On the host nothing is polled: scenarios, or a simulated bus hooked
+/// up with set_write_handler(), deliver datapoints with publish_datapoint() and see every write the clients send.
+class Econet : public Component {
+ public:
+  void setup() override { this->disable_loop(); }
+
+  void register_listener(const std::string &datapoint_id, int8_t request_mod, bool request_once,
+                         const std::function<void(const EconetDatapoint &datapoint)> &func,
+                         bool is_raw_datapoint = false, uint32_t src_adr = 0);
+  void set_float_datapoint_value(const std::string &datapoint_id, float value, uint32_t address = 0);
+  void set_enum_datapoint_value(const std::string &datapoint_id, uint8_t value, uint32_t address = 0);
+
+  /// Calls the listeners registered for `datapoint_id` at `src_adr`, as a received read response would.
+  void publish_datapoint(const std::string &datapoint_id, uint32_t src_adr, const EconetDatapoint &datapoint);
+  void publish_float(const std::string &datapoint_id, uint32_t src_adr, float value);
+  void publish_enum(const std::string &datapoint_id, uint32_t src_adr, uint8_t value);
+  void publish_text(const std::string &datapoint_id, uint32_t src_adr, const std::string &value);
+
+  /// Called with every write instead of recording it for get_writes().
+  void set_write_handler(std::function<void(const host::EconetWrite &)> &&handler) {
+    this->write_handler_ = std::move(handler);
+  }
+  const std::vector<host::EconetWrite> &get_writes() const { return this->writes_; }
+  void clear_writes() { this->writes_.clear(); }
+
+  struct Listener {
+    std::string datapoint_id;
+    int8_t request_mod;
+    bool request_once;
+    uint32_t src_adr;
+    std::function<void(const EconetDatapoint &)> callback;
+  };
+  const std::vector<Listener> &get_listeners() const { return this->listeners_; }
+
+ protected:
+  void write_(host::EconetWrite &&write);
+
+  std::vector<Listener> listeners_;
+  std::vector<host::EconetWrite> writes_;
+  std::function<void(const host::EconetWrite &)> write_handler_;
+};
+
+class EconetClient {
+ public:
+  void set_econet_parent(Econet *parent) { this->parent_ = parent; }
+  void set_request_mod(int8_t request_mod) { this->request_mod_ = request_mod; }
+  void set_request_once(bool request_once) { this->request_once_ = request_once; }
+  void set_src_adr(uint32_t src_adr) { this->src_adr_ = src_adr; }
+
+ protected:
+  Econet *parent_{nullptr};
+  int8_t request_mod_{0};
+  bool request_once_{false};
+  uint32_t src_adr_{0};
+};
+
+}  // namespace esphome::econet
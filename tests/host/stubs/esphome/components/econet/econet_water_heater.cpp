@@ -0,0 +1,74 @@
+#include "esphome/components/econet/econet_water_heater.h"
+
+#include <cmath>
+
+namespace esphome::econet {
+
+using namespace water_heater;
+
+static float fahrenheit_to_celsius(float f) { return (f - 32.0f) * 5.0f / 9.0f; }
+static float celsius_to_fahrenheit(float c) { return c * 9.0f / 5.0f + 32.0f; }
+
+void EconetWaterHeater::setup() {
+  this->parent_->register_listener(
+      this->mode_id_, this->request_mod_, this->request_once_,
+      [this](const EconetDatapoint &datapoint) {
+        for (const auto &[value, mode] : this->modes_) {
+          if (value == datapoint.value_enum && mode != this->get_mode()) {
+            this->set_mode_(mode);
+            this->publish_state();
+          }
+        }
+      },
+      false, this->src_adr_);
+  this->parent_->register_listener(
+      this->target_temperature_id_, this->request_mod_, this->request_once_,
+      [this](const EconetDatapoint &datapoint) {
+        const float target = fahrenheit_to_celsius(datapoint.value_float);
+        if (std::isnan(this->get_target_temperature()) || std::fabs(target - this->get_target_temperature()) > 0.01f) {
+          this->set_target_temperature_(target);
+          this->publish_state();
+        }
+      },
+      false, this->src_adr_);
+  this->parent_->register_listener(
+      this->current_temperature_id_, this->request_mod_, this->request_once_,
+      [this](const EconetDatapoint &datapoint) {
+        const float current = fahrenheit_to_celsius(datapoint.value_float);
+        if (std::isnan(this->get_current_temperature()) ||
+            std::fabs(current - this->get_current_temperature()) > 0.01f) {
+          this->set_current_temperature(current);
+          this->publish_state();
+        }
+      },
+      false, this->src_adr_);
+}
+
+WaterHeaterTraits EconetWaterHeater::traits() {
+  WaterHeaterTraits traits;
+  traits.add_feature_flags(WATER_HEATER_SUPPORTS_CURRENT_TEMPERATURE | WATER_HEATER_SUPPORTS_TARGET_TEMPERATURE |
+                           WATER_HEATER_SUPPORTS_OPERATION_MODE);
+  WaterHeaterModeMask modes;
+  for (const auto &entry : this->modes_)
+    modes.insert(entry.second);
+  traits.set_supported_modes(modes);
+  traits.set_min_temperature(fahrenheit_to_celsius(110.0f));
+  traits.set_max_temperature(fahrenheit_to_celsius(140.0f));
+  return traits;
+}
+
+void EconetWaterHeater::control(const WaterHeaterCall &call) {
+  // Nothing changes until the heater reports it back.
+  if (call.get_mode().has_value()) {
+    for (const auto &[value, mode] : this->modes_) {
+      if (mode == *call.get_mode())
+        this->parent_->set_enum_datapoint_value(this->mode_id_, value, this->src_adr_);
+    }
+  }
+  if (!std::isnan(call.get_target_temperature())) {
+    this->parent_->set_float_datapoint_value(this->target_temperature_id_,
+                                             celsius_to_fahrenheit(call.get_target_temperature()), this->src_adr_);
+  }
+}
+
+}  // namespace esphome::econet
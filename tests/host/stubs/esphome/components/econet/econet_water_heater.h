@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "esphome/core/component.h"
+#include "esphome/components/econet/econet.h"
+#include "esphome/components/water_heater/water_heater.h"
+
+namespace esphome::econet {
+
+/// Stands in for the water_heater platform of esphome-econet: mode, target and current temperature come from
+/// datapoints in °F and are published in °C, control() writes mode and target back to the heater.
+class EconetWaterHeater : public water_heater::WaterHeater, public Component, public EconetClient {
+ public:
+  void set_mode_id(const char *mode_id) { this->mode_id_ = mode_id; }
+  void set_target_temperature_id(const char *target_temperature_id) {
+    this->target_temperature_id_ = target_temperature_id;
+  }
+  void set_current_temperature_id(const char *current_temperature_id) {
+    this->current_temperature_id_ = current_temperature_id;
+  }
+  void add_mode(uint8_t value, water_heater::WaterHeaterMode mode) { this->modes_.emplace_back(value, mode); }
+
+  void setup() override;
+  water_heater::WaterHeaterCallInternal make_call() override { return water_heater::WaterHeaterCallInternal(this); }
+
+ protected:
+  water_heater::WaterHeaterTraits traits() override;
+  void control(const water_heater::WaterHeaterCall &call) override;
+
+  const char *mode_id_{"WHTRCNFG"};
+  const char *target_temperature_id_{"WHTRSETP"};
+  const char *current_temperature_id_{"UPHTRTMP"};
+  std::vector<std::pair<uint8_t, water_heater::WaterHeaterMode>> modes_;
+};
+
+}  // namespace esphome::econet
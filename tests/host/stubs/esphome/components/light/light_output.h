@@ -0,0 +1,17 @@
+#pragma once
+
+#include "esphome/components/light/light_state.h"
+#include "esphome/components/light/light_traits.h"
+
+namespace esphome::light {
+
+/// The platform side of a light: LightState hands it every state change through write_state().
+class LightOutput {
+ public:
+  virtual ~LightOutput() = default;
+  virtual LightTraits get_traits() = 0;
+  virtual void setup_state(LightState *state) {}
+  virtual void write_state(LightState *state) = 0;
+};
+
+}  // namespace esphome::light
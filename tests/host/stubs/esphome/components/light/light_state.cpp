@@ -0,0 +1,70 @@
+#include "esphome/components/light/light_state.h"
+#include "esphome/components/light/light_output.h"
+
+namespace esphome::light {
+
+LightCall &LightCall::set_effect(const std::string &effect) {
+  if (effect == "None") {
+    this->effect_ = 0;
+    return *this;
+  }
+  const auto &effects = this->parent_->get_effects();
+  for (size_t i = 0; i < effects.size(); i++) {
+    if (effect == effects[i]->get_name()) {
+      this->effect_ = i + 1;
+      break;
+    }
+  }
+  return *this;
+}
+
+void LightCall::perform() {
+  LightState *light = this->parent_;
+  if (this->state_.has_value())
+    light->remote_values.set_state(*this->state_);
+  if (!light->remote_values.is_on()) {
+    // Turning off stops the effect, as on a device.
+    light->start_effect_(0);
+  } else if (this->effect_.has_value() && *this->effect_ <= light->effects_.size()) {
+    light->start_effect_(*this->effect_);
+  }
+  light->current_values = light->remote_values;
+  light->remote_values_callback_.call();
+  light->next_write_ = true;
+  light->enable_loop();
+}
+
+void LightState::setup() {
+  this->output_->setup_state(this);
+  this->next_write_ = true;
+}
+
+void LightState::loop() {
+  if (this->active_effect_index_ != 0)
+    this->effects_[this->active_effect_index_ - 1]->apply();
+  if (this->next_write_) {
+    // Cleared first: write_state() may perform() another call that needs its own write.
+    this->next_write_ = false;
+    this->output_->write_state(this);
+  }
+  if (this->active_effect_index_ == 0 && !this->next_write_)
+    this->disable_loop();
+}
+
+std::string LightState::get_effect_name() const {
+  if (this->active_effect_index_ == 0)
+    return "None";
+  return this->effects_[this->active_effect_index_ - 1]->get_name();
+}
+
+void LightState::start_effect_(uint32_t effect_index) {
+  if (effect_index == this->active_effect_index_)
+    return;
+  if (this->active_effect_index_ != 0)
+    this->effects_[this->active_effect_index_ - 1]->stop();
+  this->active_effect_index_ = effect_index;
+  if (effect_index != 0)
+    this->effects_[effect_index - 1]->start();
+}
+
+}  // namespace esphome::light
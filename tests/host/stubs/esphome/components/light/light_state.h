@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "esphome/core/component.h"
+#include "esphome/core/entity_base.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/optional.h"
+#include "esphome/components/light/light_traits.h"
+
+namespace esphome::light {
+
+class LightOutput;
+
+/// On/off part of a light's values; the host lights have no brightness or color.
+class LightColorValues {
+ public:
+  bool is_on() const { return this->state_; }
+  void set_state(bool state) { this->state_ = state; }
+
+ protected:
+  bool state_{false};
+};
+
+class LightEffect {
+ public:
+  explicit LightEffect(const char *name) : name_(name) {}
+  virtual ~LightEffect() = default;
+  virtual void start() {}
+  virtual void stop() {}
+  virtual void apply() = 0;
+  const char *get_name() const { return this->name_; }
+
+ protected:
+  const char *name_;
+};
+
+class LightState;
+
+/// A state change. perform() applies it immediately (the host has no transitions) and has the output written on the
+/// light's next loop, as on a device.
+class LightCall {
+ public:
+  explicit LightCall(LightState *parent) : parent_(parent) {}
+
+  LightCall &set_state(bool state) {
+    this->state_ = state;
+    return *this;
+  }
+  /// Effect by index into the light's effects, 1-based; 0 clears the effect.
+  LightCall &set_effect(uint32_t effect_index) {
+    this->effect_ = effect_index;
+    return *this;
+  }
+  LightCall &set_effect(const std::string &effect);
+  void perform();
+
+ protected:
+  LightState *parent_;
+  optional<bool> state_;
+  optional<uint32_t> effect_;
+};
+
+class LightState : public EntityBase, public Component {
+ public:
+  explicit LightState(LightOutput *output) : output_(output) {}
+
+  void add_effects(const std::vector<LightEffect *> &effects) {
+    this->effects_.insert(this->effects_.end(), effects.begin(), effects.end());
+  }
+  const std::vector<LightEffect *> &get_effects() const { return this->effects_; }
+
+  void setup() override;
+  void loop() override;
+  float get_setup_priority() const override { return setup_priority::HARDWARE - 1.0f; }
+
+  LightCall turn_on() { return this->make_call().set_state(true); }
+  LightCall turn_off() { return this->make_call().set_state(false); }
+  LightCall toggle() { return this->make_call().set_state(!this->remote_values.is_on()); }
+  LightCall make_call() { return LightCall(this); }
+
+  void current_values_as_binary(bool *binary) { *binary = this->current_values.is_on(); }
+  /// 1-based index of the running effect, 0 if none.
+  uint32_t get_current_effect_index() const { return this->active_effect_index_; }
+  std::string get_effect_name() const;
+
+  void add_new_remote_values_callback(std::function<void()> &&send_callback) {
+    this->remote_values_callback_.add(std::move(send_callback));
+  }
+
+  LightColorValues current_values;
+  LightColorValues remote_values;
+
+ protected:
+  friend class LightCall;
+
+  void start_effect_(uint32_t effect_index);
+
+  LightOutput *output_;
+  std::vector<LightEffect *> effects_;
+  uint32_t active_effect_index_{0};
+  bool next_write_{true};
+  CallbackManager<void()> remote_values_callback_;
+};
+
+}  // namespace esphome::light
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <set>
+
+namespace esphome::light {
+
+enum class ColorMode : uint8_t {
+  UNKNOWN = 0,
+  ON_OFF = 1,
+  BRIGHTNESS = 2,
+};
+
+class LightTraits {
+ public:
+  void set_supported_color_modes(std::set<ColorMode> modes) { this->supported_color_modes_ = std::move(modes); }
+  const std::set<ColorMode> &get_supported_color_modes() const { return this->supported_color_modes_; }
+
+ protected:
+  std::set<ColorMode> supported_color_modes_;
+};
+
+}  // namespace esphome::light
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstring>
+#include <functional>
+#include <string>
+
+#include "esphome/core/entity_base.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/optional.h"
+
+namespace esphome::select {
+
+class SelectTraits {
+ public:
+  /// The options are pointers, kept as they are; the strings must outlive them.
+  void set_options(const FixedVector<const char *> &options) { this->options_ = options; }
+  const FixedVector<const char *> &get_options() const { return this->options_; }
+
+ protected:
+  FixedVector<const char *> options_;
+};
+
+class Select;
+
+/// A request to change a select, by option or index; perform() hands a valid index to Select::control().
+class SelectCall {
+ public:
+  explicit SelectCall(Select *parent) : parent_(parent) {}
+  SelectCall &set_option(const std::string &option);
+  SelectCall &set_index(size_t index) {
+    this->index_ = index;
+    return *this;
+  }
+  void perform();
+
+ protected:
+  Select *parent_;
+  optional<std::string> option_;
+  optional<size_t> index_;
+};
+
+class Select : public EntityBase {
+ public:
+  virtual ~Select() = default;
+
+  void publish_state(size_t index) {
+    if (!this->has_index(index))
+      return;
+    this->active_index_ = index;
+    this->callback_.call(index);
+  }
+  const char *current_option() const {
+    return this->active_index_.has_value() ? this->option_at(*this->active_index_) : "";
+  }
+  optional<size_t> active_index() const { return this->active_index_; }
+  bool has_index(size_t index) const { return index < this->size(); }
+  size_t size() const { return this->traits.get_options().size(); }
+  const char *option_at(size_t index) const { return this->traits.get_options()[index]; }
+  optional<size_t> index_of(const char *option) const {
+    for (size_t i = 0; i < this->size(); i++) {
+      if (std::strcmp(this->option_at(i), option) == 0)
+        return i;
+    }
+    return nullopt;
+  }
+  SelectCall make_call() { return SelectCall(this); }
+  void add_on_state_callback(std::function<void(size_t)> &&callback) { this->callback_.add(std::move(callback)); }
+
+  SelectTraits traits;
+
+ protected:
+  friend class SelectCall;
+  virtual void control(size_t index) = 0;
+
+  optional<size_t> active_index_;
+  CallbackManager<void(size_t)> callback_;
+};
+
+inline SelectCall &SelectCall::set_option(const std::string &option) {
+  this->option_ = option;
+  return *this;
+}
+
+inline void SelectCall::perform() {
+  optional<size_t> index = this->index_;
+  if (this->option_.has_value())
+    index = this->parent_->index_of(this->option_->c_str());
+  if (!index.has_value() || !this->parent_->has_index(*index))
+    return;
+  this->parent_->control(*index);
+}
+
+}  // namespace esphome::select
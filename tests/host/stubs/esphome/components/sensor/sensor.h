@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cmath>
+#include <functional>
+
+#include "esphome/core/entity_base.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/string_ref.h"
+
+namespace esphome::sensor {
+
+/// A numeric sensor without filters: every value published is the state.
+class Sensor : public EntityBase {
+ public:
+  void publish_state(float state) {
+    this->raw_state = state;
+    this->raw_callback_.call(state);
+    this->state = state;
+    this->has_state_ = true;
+    this->callback_.call(state);
+  }
+  float get_state() const { return this->state; }
+  float get_raw_state() const { return this->raw_state; }
+  bool has_state() const { return this->has_state_; }
+
+  void add_on_state_callback(std::function<void(float)> &&callback) { this->callback_.add(std::move(callback)); }
+  void add_on_raw_state_callback(std::function<void(float)> &&callback) {
+    this->raw_callback_.add(std::move(callback));
+  }
+
+  void set_unit_of_measurement(const char *unit) { this->unit_of_measurement_ = unit; }
+  StringRef get_unit_of_measurement_ref() const { return StringRef(this->unit_of_measurement_); }
+  void set_accuracy_decimals(int8_t accuracy_decimals) { this->accuracy_decimals_ = accuracy_decimals; }
+  int8_t get_accuracy_decimals() const { return this->accuracy_decimals_; }
+
+  float state{NAN};
+  float raw_state{NAN};
+
+ protected:
+  CallbackManager<void(float)> raw_callback_;
+  CallbackManager<void(float)> callback_;
+  const char *unit_of_measurement_{""};
+  int8_t accuracy_decimals_{0};
+  bool has_state_{false};
+};
+
+}  // namespace esphome::sensor
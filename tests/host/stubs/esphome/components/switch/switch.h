@@ -0,0 +1,40 @@
+#pragma once
+
+#include <functional>
+
+#include "esphome/core/entity_base.h"
+#include "esphome/core/helpers.h"
+
+namespace esphome::switch_ {
+
+/// A switch whose write_state() decides what happens; it reports back with publish_state(), which does nothing if the
+/// state is unchanged.
+class Switch : public EntityBase {
+ public:
+  virtual ~Switch() = default;
+
+  void turn_on() { this->write_state(!this->inverted_); }
+  void turn_off() { this->write_state(this->inverted_); }
+  void toggle() { this->write_state(this->inverted_ == this->state); }
+  void publish_state(bool state) {
+    if (this->has_state_ && state == this->state)
+      return;
+    this->state = state;
+    this->has_state_ = true;
+    this->callback_.call(state);
+  }
+  void add_on_state_callback(std::function<void(bool)> &&callback) { this->callback_.add(std::move(callback)); }
+  void set_inverted(bool inverted) { this->inverted_ = inverted; }
+  bool is_inverted() const { return this->inverted_; }
+
+  bool state{false};
+
+ protected:
+  virtual void write_state(bool state) = 0;
+
+  CallbackManager<void(bool)> callback_;
+  bool inverted_{false};
+  bool has_state_{false};
+};
+
+}  // namespace esphome::switch_
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include "esphome/core/entity_base.h"
+#include "esphome/core/helpers.h"
+
+namespace esphome::text_sensor {
+
+class TextSensor : public EntityBase {
+ public:
+  void publish_state(const std::string &state) {
+    this->state = state;
+    this->has_state_ = true;
+    this->callback_.call(this->state);
+  }
+  void publish_state(const char *state) { this->publish_state(std::string(state)); }
+  const std::string &get_state() const { return this->state; }
+  bool has_state() const { return this->has_state_; }
+  void add_on_state_callback(std::function<void(std::string)> &&callback) {
+    this->callback_.add(std::move(callback));
+  }
+
+  std::string state;
+
+ protected:
+  CallbackManager<void(std::string)> callback_;
+  bool has_state_{false};
+};
+
+}  // namespace esphome::text_sensor
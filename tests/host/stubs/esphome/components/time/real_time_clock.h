@@ -0,0 +1,36 @@
+#pragma once
+
+#include <ctime>
+
+#include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/time.h"
+
+namespace esphome::time {
+
+/// A clock that has the time once synchronize_epoch() is called and then follows the simulated clock.
+class RealTimeClock : public PollingComponent {
+ public:
+  RealTimeClock() : PollingComponent(15 * 60 * 1000) {}
+
+  void update() override {}
+  ESPTime now() { return ESPTime::from_epoch_local(this->timestamp_now()); }
+  ESPTime utcnow() { return ESPTime::from_epoch_utc(this->timestamp_now()); }
+  time_t timestamp_now() {
+    if (this->epoch_ == 0)
+      return 0;
+    return this->epoch_ + static_cast<time_t>((millis_64() - this->synced_ms_) / 1000);
+  }
+
+  // Public on the host, where the test is the time source.
+  void synchronize_epoch(time_t epoch) {
+    this->epoch_ = epoch;
+    this->synced_ms_ = millis_64();
+  }
+
+ protected:
+  time_t epoch_{0};
+  uint64_t synced_ms_{0};
+};
+
+}  // namespace esphome::time
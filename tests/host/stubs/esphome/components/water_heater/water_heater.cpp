@@ -0,0 +1,84 @@
+#include "esphome/components/water_heater/water_heater.h"
+
+#include <cstring>
+
+namespace esphome::water_heater {
+
+const char *water_heater_mode_to_string(WaterHeaterMode mode) {
+  switch (mode) {
+    case WATER_HEATER_MODE_OFF:
+      return "OFF";
+    case WATER_HEATER_MODE_ECO:
+      return "ECO";
+    case WATER_HEATER_MODE_ELECTRIC:
+      return "ELECTRIC";
+    case WATER_HEATER_MODE_PERFORMANCE:
+      return "PERFORMANCE";
+    case WATER_HEATER_MODE_HIGH_DEMAND:
+      return "HIGH_DEMAND";
+    case WATER_HEATER_MODE_HEAT_PUMP:
+      return "HEAT_PUMP";
+    case WATER_HEATER_MODE_GAS:
+      return "GAS";
+    default:
+      return "UNKNOWN";
+  }
+}
+
+void WaterHeaterCall::validate_() {
+  const WaterHeaterTraits traits = this->parent_->get_traits();
+  if (this->mode_.has_value() && !traits.supports_mode(*this->mode_))
+    this->mode_.reset();
+  if (!std::isnan(this->target_temperature_)) {
+    if (!std::isnan(traits.get_min_temperature()) && this->target_temperature_ < traits.get_min_temperature())
+      this->target_temperature_ = traits.get_min_temperature();
+    if (!std::isnan(traits.get_max_temperature()) && this->target_temperature_ > traits.get_max_temperature())
+      this->target_temperature_ = traits.get_max_temperature();
+  }
+}
+
+void WaterHeaterCall::perform() {
+  this->validate_();
+  this->parent_->control(*this);
+}
+
+ESPPreferenceObject &WaterHeater::pref_() {
+  if (!this->pref_created_) {
+    this->pref_object_ = this->make_entity_preference<WaterHeaterRestoreState>();
+    this->pref_created_ = true;
+  }
+  return this->pref_object_;
+}
+
+void WaterHeater::publish_state() {
+  this->publish_count_++;
+  // Zero the padding as well, like climate does, so an unchanged state saves identical bytes and never reaches flash.
+  WaterHeaterRestoreState state;
+  std::memset(&state, 0, sizeof(state));
+  state.mode = this->mode_;
+  state.target_temperature = this->target_temperature_;
+  state.away = this->is_away();
+  this->pref_().save(&state);
+}
+
+optional<WaterHeaterCallInternal> WaterHeater::restore_state_() {
+  WaterHeaterRestoreState recovered{};
+  if (!this->pref_().load(&recovered))
+    return {};
+  WaterHeaterCallInternal call = this->make_call();
+  call.set_mode(recovered.mode);
+  call.set_target_temperature(recovered.target_temperature);
+  call.set_away(recovered.away);
+  return call;
+}
+
+void WaterHeater::dump_traits_(const char *tag) {
+  const WaterHeaterTraits traits = this->get_traits();
+  ESP_LOGCONFIG(tag, "  Min Temperature: %.1f", traits.get_min_temperature());
+  ESP_LOGCONFIG(tag, "  Max Temperature: %.1f", traits.get_max_temperature());
+  ESP_LOGCONFIG(tag, "  Target Temperature Step: %.2f", traits.get_target_temperature_step());
+  for (const auto mode : traits.get_supported_modes())
+    ESP_LOGCONFIG(tag, "  Supports Mode: %s", water_heater_mode_to_string(mode));
+}
+
+}  // namespace esphome::water_heater
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <initializer_list>
+
+#include "esphome/core/entity_base.h"
+#include "esphome/core/log.h"
+#include "esphome/core/optional.h"
+#include "esphome/core/preferences.h"
+
+namespace esphome::water_heater {
+
+enum WaterHeaterMode : uint8_t {
+  WATER_HEATER_MODE_OFF = 0,
+  WATER_HEATER_MODE_ECO = 1,
+  WATER_HEATER_MODE_ELECTRIC = 2,
+  WATER_HEATER_MODE_PERFORMANCE = 3,
+  WATER_HEATER_MODE_HIGH_DEMAND = 4,
+  WATER_HEATER_MODE_HEAT_PUMP = 5,
+  WATER_HEATER_MODE_GAS = 6,
+};
+
+enum WaterHeaterStateFlag : uint32_t {
+  WATER_HEATER_STATE_AWAY = 1 << 0,
+  WATER_HEATER_STATE_ON = 1 << 1,
+};
+
+enum WaterHeaterFeature : uint32_t {
+  WATER_HEATER_SUPPORTS_CURRENT_TEMPERATURE = 1 << 0,
+  WATER_HEATER_SUPPORTS_TARGET_TEMPERATURE = 1 << 1,
+  WATER_HEATER_SUPPORTS_OPERATION_MODE = 1 << 2,
+  WATER_HEATER_SUPPORTS_AWAY_MODE = 1 << 3,
+  WATER_HEATER_SUPPORTS_ON_OFF = 1 << 4,
+};
+
+const char *water_heater_mode_to_string(WaterHeaterMode mode);
+
+/// Set of modes kept as a bit mask, as on a device, so copying traits never allocates.
+class WaterHeaterModeMask {
+ public:
+  class Iterator {
+   public:
+    Iterator(uint32_t mask, uint8_t bit) : mask_(mask), bit_(bit) { this->skip_(); }
+    WaterHeaterMode operator*() const { return static_cast<WaterHeaterMode>(this->bit_); }
+    Iterator &operator++() {
+      this->bit_++;
+      this->skip_();
+      return *this;
+    }
+    bool operator!=(const Iterator &other) const { return this->bit_ != other.bit_; }
+
+   protected:
+    void skip_() {
+      while (this->bit_ < 32 && (this->mask_ & (1u << this->bit_)) == 0)
+        this->bit_++;
+    }
+    uint32_t mask_;
+    uint8_t bit_;
+  };
+
+  WaterHeaterModeMask() = default;
+  WaterHeaterModeMask(std::initializer_list<WaterHeaterMode> modes) {
+    for (auto mode : modes)
+      this->insert(mode);
+  }
+  void insert(WaterHeaterMode mode) { this->mask_ |= 1u << mode; }
+  size_t count(WaterHeaterMode mode) const { return (this->mask_ >> mode) & 1u; }
+  bool empty() const { return this->mask_ == 0; }
+  Iterator begin() const { return {this->mask_, 0}; }
+  Iterator end() const { return {0, 32}; }
+
+ protected:
+  uint32_t mask_{0};
+};
+
+class WaterHeaterTraits {
+ public:
+  void add_feature_flags(uint32_t flags) { this->feature_flags_ |= flags; }
+  bool has_feature_flags(uint32_t flags) const { return (this->feature_flags_ & flags) == flags; }
+  void set_supported_modes(WaterHeaterModeMask modes) { this->supported_modes_ = modes; }
+  const WaterHeaterModeMask &get_supported_modes() const { return this->supported_modes_; }
+  bool supports_mode(WaterHeaterMode mode) const { return this->supported_modes_.count(mode) != 0; }
+  void set_min_temperature(float min_temperature) { this->min_temperature_ = min_temperature; }
+  float get_min_temperature() const { return this->min_temperature_; }
+  void set_max_temperature(float max_temperature) { this->max_temperature_ = max_temperature; }
+  float get_max_temperature() const { return this->max_temperature_; }
+  void set_target_temperature_step(float step) { this->target_temperature_step_ = step; }
+  float get_target_temperature_step() const { return this->target_temperature_step_; }
+
+ protected:
+  uint32_t feature_flags_{0};
+  WaterHeaterModeMask supported_modes_;
+  float min_temperature_{NAN};
+  float max_temperature_{NAN};
+  float target_temperature_step_{NAN};
+};
+
+class WaterHeater;
+
+/// A request to change a water heater. perform() drops unsupported modes, clamps the target to the traits' range
+/// and hands the rest to WaterHeater::control().
+class WaterHeaterCall {
+ public:
+  explicit WaterHeaterCall(WaterHeater *parent) : parent_(parent) {}
+  virtual ~WaterHeaterCall() = default;
+
+  WaterHeaterCall &set_mode(WaterHeaterMode mode) {
+    this->mode_ = mode;
+    return *this;
+  }
+  WaterHeaterCall &set_target_temperature(float target_temperature) {
+    this->target_temperature_ = target_temperature;
+    return *this;
+  }
+  WaterHeaterCall &set_away(bool away) {
+    this->away_ = away;
+    return *this;
+  }
+
+  const optional<WaterHeaterMode> &get_mode() const { return this->mode_; }
+  float get_target_temperature() const { return this->target_temperature_; }
+  const optional<bool> &get_away() const { return this->away_; }
+
+  void perform();
+
+ protected:
+  void validate_();
+
+  WaterHeater *parent_;
+  optional<WaterHeaterMode> mode_;
+  float target_temperature_{NAN};
+  optional<bool> away_;
+};
+
+/// The call type components return from make_call().
+class WaterHeaterCallInternal : public WaterHeaterCall {
+ public:
+  explicit WaterHeaterCallInternal(WaterHeater *parent) : WaterHeaterCall(parent) {}
+};
+
+/// What publish_state() saves and restore_state_() reads back at boot.
+struct WaterHeaterRestoreState {
+  WaterHeaterMode mode;
+  float target_temperature;
+  bool away;
+};
+
+class WaterHeater : public EntityBase {
+ public:
+  virtual ~WaterHeater() = default;
+
+  WaterHeaterTraits get_traits() { return this->traits(); }
+  virtual WaterHeaterCallInternal make_call() = 0;
+
+  WaterHeaterMode get_mode() const { return this->mode_; }
+  float get_current_temperature() const { return this->current_temperature_; }
+  float get_target_temperature() const { return this->target_temperature_; }
+  bool is_away() const { return (this->state_ & WATER_HEATER_STATE_AWAY) != 0; }
+  void set_current_temperature(float current_temperature) { this->current_temperature_ = current_temperature; }
+
+  /// Sends the state to the frontends and saves mode, target and away.
+  void publish_state();
+  /// Number of publish_state() calls, for the scenarios.
+  uint32_t get_publish_count() const { return this->publish_count_; }
+
+ protected:
+  friend class WaterHeaterCall;
+
+  virtual WaterHeaterTraits traits() = 0;
+  virtual void control(const WaterHeaterCall &call) = 0;
+
+  void set_mode_(WaterHeaterMode mode) { this->mode_ = mode; }
+  void set_target_temperature_(float target_temperature) { this->target_temperature_ = target_temperature; }
+  void set_state_flag_(uint32_t flag, bool value) {
+    if (value) {
+      this->state_ |= flag;
+    } else {
+      this->state_ &= ~flag;
+    }
+  }
+  optional<WaterHeaterCallInternal> restore_state_();
+  void dump_traits_(const char *tag);
+  ESPPreferenceObject &pref_();
+
+  WaterHeaterMode mode_{WATER_HEATER_MODE_OFF};
+  float current_temperature_{NAN};
+  float target_temperature_{NAN};
+  uint32_t state_{0};
+  uint32_t publish_count_{0};
+  ESPPreferenceObject pref_object_;
+  bool pref_created_{false};
+};
+
+}  // namespace esphome::water_heater
@@ -0,0 +1,136 @@
+#include "esphome/core/application.h"
+#include "esphome/core/log.h"
+
+#include "host.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace esphome {
+
+static const char *const TAG = "app";
+
+static uint64_t steady_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+Application App;
+
+Application::Application() {
+  this->scheduler.on_item_start = [this](Component *) {
+    if (!this->collect_stats_)
+      return;
+    this->item_started_ns_ = steady_ns();
+    this->item_started_allocations_ = host::allocation_count();
+  };
+  this->scheduler.on_item_end = [this](Component *component) {
+    if (!this->collect_stats_)
+      return;
+    const size_t index = this->index_of_(component);
+    if (index == this->stats_.size())
+      return;
+    this->stats_[index].scheduler_ns += steady_ns() - this->item_started_ns_;
+    this->stats_[index].scheduler_calls++;
+    this->stats_[index].scheduler_allocations += host::allocation_count() - this->item_started_allocations_;
+  };
+}
+
+void Application::register_component(Component *component) {
+  this->components_.push_back(component);
+  this->stats_.emplace_back();
+}
+
+void Application::setup() {
+  // Highest priority first, and in registration order within a priority, as on a device.
+  std::stable_sort(this->components_.begin(), this->components_.end(), [](const Component *a, const Component *b) {
+    return a->get_setup_priority() > b->get_setup_priority();
+  });
+  for (size_t i = 0; i < this->components_.size(); i++) {
+    const uint64_t allocations = host::allocation_count();
+    this->components_[i]->call_setup();
+    this->stats_[i].setup_allocations = host::allocation_count() - allocations;
+    this->scheduler.call(millis_64());
+  }
+  for (auto *component : this->components_)
+    component->call_dump_config();
+  this->last_sync_ = millis_64();
+}
+
+void Application::loop() {
+  this->loop_count_++;
+  this->scheduler.call(millis_64());
+  for (size_t i = 0; i < this->components_.size(); i++) {
+    Component *component = this->components_[i];
+    if (component->is_failed() || !component->is_loop_enabled())
+      continue;
+    this->loop_component_start_time_ = millis();
+    if (!this->collect_stats_) {
+      component->call_loop();
+      continue;
+    }
+    const uint64_t allocations = host::allocation_count();
+    const uint64_t start = steady_ns();
+    component->call_loop();
+    this->stats_[i].loop_ns += steady_ns() - start;
+    this->stats_[i].loop_calls++;
+    this->stats_[i].loop_allocations += host::allocation_count() - allocations;
+  }
+  if (millis_64() - this->last_sync_ >= this->flash_write_interval_) {
+    this->last_sync_ = millis_64();
+    global_preferences->sync();
+  }
+}
+
+void Application::run_safe_shutdown_hooks() {
+  for (auto it = this->components_.rbegin(); it != this->components_.rend(); ++it)
+    (*it)->on_safe_shutdown();
+  global_preferences->sync();
+}
+
+void Application::run_for(uint32_t ms) {
+  const uint64_t end = host::clock_us() + static_cast<uint64_t>(ms) * 1000;
+  while (host::clock_us() < end) {
+    this->loop();
+    uint64_t step = static_cast<uint64_t>(HighFrequencyLoopRequester::is_high_frequency() ? 1 : this->loop_interval_);
+    const bool any_loop = std::any_of(this->components_.begin(), this->components_.end(), [](const Component *c) {
+      return !c->is_failed() && c->is_loop_enabled();
+    });
+    if (!any_loop) {
+      // Nothing to do until the next timeout, or the next sync.
+      const uint64_t next = std::min(this->scheduler.next_execution(), this->last_sync_ + this->flash_write_interval_);
+      if (next > millis_64())
+        step = std::max(step, next - millis_64());
+    }
+    host::advance_clock_us(std::min(step * 1000, end - host::clock_us()));
+  }
+}
+
+void Application::reset() {
+  ESP_LOGD(TAG, "Resetting the application");
+  this->components_.clear();
+  this->stats_.clear();
+  this->scheduler.clear();
+  this->loop_count_ = 0;
+  this->loop_interval_ = 16;
+  this->flash_write_interval_ = 10 * 60 * 1000;
+  this->last_sync_ = 0;
+}
+
+size_t Application::index_of_(const Component *component) const {
+  return std::find(this->components_.begin(), this->components_.end(), component) - this->components_.begin();
+}
+
+const host::ComponentStats &Application::get_stats(const Component *component) const {
+  static const host::ComponentStats NONE{};
+  const size_t index = this->index_of_(component);
+  return index < this->stats_.size() ? this->stats_[index] : NONE;
+}
+
+void Application::clear_stats() {
+  this->loop_count_ = 0;
+  for (auto &stats : this->stats_)
+    stats = {.setup_allocations = stats.setup_allocations};
+}
+
+}  // namespace esphome
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "esphome/core/component.h"
+#include "esphome/core/scheduler.h"
+
+namespace esphome {
+
+namespace host {
+
+/// Wall clock time one component has taken on the host, in its loop() and in its scheduler items, and the heap
+/// allocations it made in each.
+struct ComponentStats {
+  uint64_t loop_ns{0};
+  uint64_t loop_calls{0};
+  uint64_t scheduler_ns{0};
+  uint64_t scheduler_calls{0};
+  uint64_t setup_allocations{0};  ///< Made in setup(), kept by clear_stats().
+  uint64_t loop_allocations{0};
+  uint64_t scheduler_allocations{0};
+};
+
+}  // namespace host
+
+/// The main loop: sets the registered components up in priority order, then runs the scheduler and every enabled
+/// loop() once per loop(). On the host it also drives the simulated clock (run_for()) and syncs the preferences every
+/// flash write interval, as the preferences component does on a device.
+class Application {
+ public:
+  Application();
+
+  void register_component(Component *component);
+  /// Sets every component up, highest setup priority first, then logs their configuration.
+  void setup();
+  void loop();
+
+  uint32_t get_loop_component_start_time() const { return this->loop_component_start_time_; }
+  void feed_wdt() {}
+  /// Lets every component save its state before a restart the device chose, then syncs the preferences.
+  void run_safe_shutdown_hooks();
+
+  Scheduler scheduler;
+
+  // Host only.
+
+  /// Runs loop() until the clock has moved on `ms`, advancing it by the loop interval after each one, or 1 ms while
+  /// a component requests high frequency loops. With no loop enabled the clock jumps straight to the next timeout.
+  void run_for(uint32_t ms);
+  /// Main loop interval (ms) for run_for(), 16 ms like a device by default. Long scenarios use a coarser one.
+  void set_loop_interval(uint32_t loop_interval) { this->loop_interval_ = loop_interval; }
+  /// Flash write interval (ms), 10 min like packages/device_base.yaml by default.
+  void set_flash_write_interval(uint32_t interval) { this->flash_write_interval_ = interval; }
+  /// Forgets every component and scheduled item, for a scenario that simulates a restart with new components.
+  void reset();
+
+  const std::vector<Component *> &get_components() const { return this->components_; }
+  /// loop() calls since the last clear_stats().
+  uint64_t get_loop_count() const { return this->loop_count_; }
+  const host::ComponentStats &get_stats(const Component *component) const;
+  void clear_stats();
+  /// Times each loop() and scheduler item with the host's steady clock and counts their allocations. On by default;
+  /// the cost is a few clock reads.
+  void set_collect_stats(bool collect) { this->collect_stats_ = collect; }
+
+ protected:
+  size_t index_of_(const Component *component) const;
+
+  std::vector<Component *> components_;
+  std::vector<host::ComponentStats> stats_;
+  uint32_t loop_component_start_time_{0};
+  uint32_t loop_interval_{16};
+  uint32_t flash_write_interval_{10 * 60 * 1000};
+  uint64_t last_sync_{0};
+  uint64_t loop_count_{0};
+  bool collect_stats_{true};
+  uint64_t item_started_ns_{0};
+  uint64_t item_started_allocations_{0};
+};
+
+extern Application App;
+
+}  // namespace esphome
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+
+/// Fires the automations attached to it. On the host an automation is any callback added with add_action().
+template<typename... Ts> class Trigger {
+ public:
+  void trigger(Ts... x) {
+    for (auto &action : this->actions_)
+      action(x...);
+  }
+  void add_action(std::function<void(Ts...)> &&action) { this->actions_.push_back(std::move(action)); }
+
+ protected:
+  std::vector<std::function<void(Ts...)>> actions_;
+};
+
+}  // namespace esphome
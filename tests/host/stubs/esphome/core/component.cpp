@@ -0,0 +1,79 @@
+#include "esphome/core/component.h"
+#include "esphome/core/application.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+
+static const char *const TAG = "component";
+
+namespace setup_priority {
+
+const float BUS = 1000.0f;
+const float IO = 900.0f;
+const float HARDWARE = 800.0f;
+const float DATA = 600.0f;
+const float PROCESSOR = 400.0f;
+const float BLUETOOTH = 350.0f;
+const float AFTER_BLUETOOTH = 300.0f;
+const float WIFI = 250.0f;
+const float ETHERNET = 250.0f;
+const float BEFORE_CONNECTION = 220.0f;
+const float AFTER_WIFI = 200.0f;
+const float AFTER_CONNECTION = 100.0f;
+const float LATE = -100.0f;
+
+}  // namespace setup_priority
+
+float Component::get_setup_priority() const { return setup_priority::DATA; }
+
+void Component::call_setup() { this->setup(); }
+
+void Component::call_loop() { this->loop(); }
+
+void Component::call_dump_config() { this->dump_config(); }
+
+void Component::mark_failed() {
+  ESP_LOGE(TAG, "Component was marked as failed");
+  this->failed_ = true;
+}
+
+void Component::set_interval(const std::string &name, uint32_t interval, std::function<void()> &&f) {
+  App.scheduler.set_interval(this, name, interval, std::move(f));
+}
+
+void Component::set_interval(uint32_t interval, std::function<void()> &&f) {
+  App.scheduler.set_interval(this, "", interval, std::move(f));
+}
+
+bool Component::cancel_interval(const std::string &name) { return App.scheduler.cancel_interval(this, name); }
+
+void Component::set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f) {
+  App.scheduler.set_timeout(this, name, timeout, std::move(f));
+}
+
+void Component::set_timeout(uint32_t timeout, std::function<void()> &&f) {
+  App.scheduler.set_timeout(this, "", timeout, std::move(f));
+}
+
+bool Component::cancel_timeout(const std::string &name) { return App.scheduler.cancel_timeout(this, name); }
+
+void Component::defer(const std::string &name, std::function<void()> &&f) {
+  App.scheduler.set_timeout(this, name, 0, std::move(f));
+}
+
+void Component::defer(std::function<void()> &&f) { App.scheduler.set_timeout(this, "", 0, std::move(f)); }
+
+bool Component::cancel_defer(const std::string &name) { return App.scheduler.cancel_timeout(this, name); }
+
+void PollingComponent::call_setup() {
+  this->setup();
+  this->start_poller();
+}
+
+void PollingComponent::start_poller() {
+  this->set_interval("update", this->get_update_interval(), [this]() { this->update(); });
+}
+
+void PollingComponent::stop_poller() { this->cancel_interval("update"); }
+
+}  // namespace esphome
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/optional.h"
+#include "esphome/core/preferences.h"
+
+namespace esphome {
+
+namespace setup_priority {
+
+extern const float BUS;
+extern const float IO;
+extern const float HARDWARE;
+extern const float DATA;
+extern const float PROCESSOR;
+extern const float BLUETOOTH;
+extern const float AFTER_BLUETOOTH;
+extern const float WIFI;
+extern const float ETHERNET;
+extern const float BEFORE_CONNECTION;
+extern const float AFTER_WIFI;
+extern const float AFTER_CONNECTION;
+extern const float LATE;
+
+}  // namespace setup_priority
+
+/// An interval or timeout of this length never runs, setting one only cancels the previous one of the same name.
+static const uint32_t SCHEDULER_DONT_RUN = 4294967295UL;
+
+class Component {
+ public:
+  virtual ~Component() = default;
+
+  virtual void setup() {}
+  virtual void loop() {}
+  virtual void dump_config() {}
+  virtual float get_setup_priority() const;
+  virtual void on_shutdown() {}
+  virtual void on_safe_shutdown() {}
+
+  /// Called by Application instead of setup(), so PollingComponent can start its poller after setup().
+  virtual void call_setup();
+  void call_loop();
+  void call_dump_config();
+
+  void mark_failed();
+  bool is_failed() const { return this->failed_; }
+  void enable_loop() { this->loop_enabled_ = true; }
+  void disable_loop() { this->loop_enabled_ = false; }
+  bool is_loop_enabled() const { return this->loop_enabled_; }
+
+  void status_set_warning(const char *message = nullptr) { this->warning_ = true; }
+  void status_clear_warning() { this->warning_ = false; }
+  bool status_has_warning() const { return this->warning_; }
+
+ protected:
+  void set_interval(const std::string &name, uint32_t interval, std::function<void()> &&f);
+  void set_interval(uint32_t interval, std::function<void()> &&f);
+  bool cancel_interval(const std::string &name);
+  void set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f);
+  void set_timeout(uint32_t timeout, std::function<void()> &&f);
+  bool cancel_timeout(const std::string &name);
+  void defer(const std::string &name, std::function<void()> &&f);
+  void defer(std::function<void()> &&f);
+  bool cancel_defer(const std::string &name);
+
+  bool failed_{false};
+  bool loop_enabled_{true};
+  bool warning_{false};
+};
+
+/// A component that runs update() every update interval once it is set up.
+class PollingComponent : public Component {
+ public:
+  PollingComponent() : PollingComponent(0) {}
+  explicit PollingComponent(uint32_t update_interval) : update_interval_(update_interval) {}
+
+  virtual void update() = 0;
+  virtual void set_update_interval(uint32_t update_interval) { this->update_interval_ = update_interval; }
+  virtual uint32_t get_update_interval() const { return this->update_interval_; }
+
+  void call_setup() override;
+  /// (Re)starts the "update" interval with the current update interval.
+  void start_poller();
+  void stop_poller();
+
+ protected:
+  uint32_t update_interval_;
+};
+
+}  // namespace esphome
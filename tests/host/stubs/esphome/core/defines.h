@@ -0,0 +1,15 @@
+#pragma once
+
+// Generated by ESPHome from the configuration on a device. Every entity type the stubs provide is enabled; targets
+// that profile their loop add USE_LOOP_PROFILER themselves.
+
+#define USE_API
+#define USE_BINARY_SENSOR
+#define USE_CLIMATE
+#define USE_LIGHT
+#define USE_SELECT
+#define USE_SENSOR
+#define USE_SWITCH
+#define USE_TEXT_SENSOR
+#define USE_TIME
+#define USE_WATER_HEATER
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "esphome/core/helpers.h"
+#include "esphome/core/preferences.h"
+
+namespace esphome {
+
+/// Name and object id of an entity; the object id hash keys its preferences as on a device.
+class EntityBase {
+ public:
+  const std::string &get_name() const { return this->name_; }
+  void set_name(const char *name) {
+    this->name_ = name;
+    this->object_id_ = str_snake_case(this->name_);
+    this->object_id_hash_ = fnv1_hash(this->object_id_);
+  }
+  const std::string &get_object_id() const { return this->object_id_; }
+  uint32_t get_object_id_hash() const { return this->object_id_hash_; }
+  bool is_internal() const { return this->internal_; }
+  void set_internal(bool internal) { this->internal_ = internal; }
+
+  template<typename T> ESPPreferenceObject make_entity_preference(uint32_t version = 0) {
+    return global_preferences->make_preference<T>(this->object_id_hash_ ^ version);
+  }
+
+ protected:
+  std::string name_;
+  std::string object_id_;
+  uint32_t object_id_hash_{fnv1_hash("")};
+  bool internal_{false};
+};
+
+}  // namespace esphome
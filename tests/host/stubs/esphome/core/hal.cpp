@@ -0,0 +1,23 @@
+#include "esphome/core/hal.h"
+
+namespace esphome {
+
+namespace {
+uint64_t clock_us_ = 0;
+}  // namespace
+
+uint32_t millis() { return static_cast<uint32_t>(clock_us_ / 1000); }
+uint64_t millis_64() { return clock_us_ / 1000; }
+uint32_t micros() { return static_cast<uint32_t>(clock_us_); }
+void delay(uint32_t ms) { host::advance_clock(ms); }
+void delayMicroseconds(uint32_t us) { host::advance_clock_us(us); }
+void yield() {}
+
+namespace host {
+
+uint64_t clock_us() { return clock_us_; }
+void advance_clock_us(uint64_t us) { clock_us_ += us; }
+void reset_clock() { clock_us_ = 0; }
+
+}  // namespace host
+}  // namespace esphome
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+// The host build runs on a simulated clock: time only moves when the test (or Application::run_for()) advances it, so
+// a scenario covering a whole day takes as long as the code under test needs and replays exactly the same every time.
+
+#define IRAM_ATTR
+#define PROGMEM
+
+namespace esphome {
+
+uint32_t millis();
+uint64_t millis_64();
+uint32_t micros();
+/// Blocking delays just move the clock on.
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+namespace host {
+
+/// Microseconds since boot on the simulated clock.
+uint64_t clock_us();
+void advance_clock_us(uint64_t us);
+inline void advance_clock(uint32_t ms) { advance_clock_us(static_cast<uint64_t>(ms) * 1000); }
+/// Back to boot, for a scenario that simulates a restart.
+void reset_clock();
+
+}  // namespace host
+}  // namespace esphome
@@ -0,0 +1,61 @@
+#include "esphome/core/helpers.h"
+
+#include <cstdarg>
+#include <cstdio>
+
+namespace esphome {
+
+uint32_t fnv1_hash(const std::string &str) {
+  uint32_t hash = 2166136261UL;
+  for (char c : str) {
+    hash *= 16777619UL;
+    hash ^= static_cast<uint8_t>(c);
+  }
+  return hash;
+}
+
+std::string str_sprintf(const char *fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  va_list copy;
+  va_copy(copy, args);
+  const int length = vsnprintf(nullptr, 0, fmt, copy);
+  va_end(copy);
+  std::string str(length > 0 ? length : 0, '\0');
+  if (length > 0)
+    vsnprintf(&str[0], length + 1, fmt, args);
+  va_end(args);
+  return str;
+}
+
+std::string str_snake_case(const std::string &str) {
+  std::string result = str;
+  for (char &c : result) {
+    if (c >= 'A' && c <= 'Z') {
+      c = static_cast<char>(c - 'A' + 'a');
+    } else if (!((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9'))) {
+      c = '_';
+    }
+  }
+  return result;
+}
+
+uint32_t HighFrequencyLoopRequester::num_requests = 0;
+
+void HighFrequencyLoopRequester::start() {
+  if (this->started_)
+    return;
+  num_requests++;
+  this->started_ = true;
+}
+
+void HighFrequencyLoopRequester::stop() {
+  if (!this->started_)
+    return;
+  num_requests--;
+  this->started_ = false;
+}
+
+bool HighFrequencyLoopRequester::is_high_frequency() { return num_requests > 0; }
+
+}  // namespace esphome
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "esphome/core/optional.h"
+
+namespace esphome {
+
+template<typename T> T clamp(T value, T min, T max) { return std::clamp(value, min, max); }
+
+/// FNV-1 hash of `str`, the hash the entity preference keys are derived from.
+uint32_t fnv1_hash(const std::string &str);
+std::string str_sprintf(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+/// Lower case with everything but letters and digits replaced by `_`, how ESPHome turns a name into an object id.
+std::string str_snake_case(const std::string &str);
+
+template<typename... X> class CallbackManager;
+
+/// Callbacks registered by components, called in the order they were added.
+template<typename... Ts> class CallbackManager<void(Ts...)> {
+ public:
+  void add(std::function<void(Ts...)> &&callback) { this->callbacks_.push_back(std::move(callback)); }
+  void call(Ts... args) {
+    for (auto &callback : this->callbacks_)
+      callback(args...);
+  }
+  size_t size() const { return this->callbacks_.size(); }
+  void operator()(Ts... args) { this->call(args...); }
+
+ protected:
+  std::vector<std::function<void(Ts...)>> callbacks_;
+};
+
+/// Asks the main loop to run without its usual delay. On the host that means Application::run_for() only moves the
+/// clock on by 1 ms per loop instead of the loop interval while any requester is active.
+class HighFrequencyLoopRequester {
+ public:
+  /// Host only: a component torn down between scenarios must not leave the loop running fast.
+  ~HighFrequencyLoopRequester() { this->stop(); }
+  void start();
+  void stop();
+  static bool is_high_frequency();
+
+ protected:
+  bool started_{false};
+  static uint32_t num_requests;
+};
+
+/// Vector sized once with init(), as ESPHome uses for lists that are built at setup and never grow after.
+template<typename T> class FixedVector {
+ public:
+  void init(size_t size) {
+    this->data_.clear();
+    this->data_.reserve(size);
+  }
+  void push_back(const T &value) { this->data_.push_back(value); }
+  size_t size() const { return this->data_.size(); }
+  bool empty() const { return this->data_.empty(); }
+  T &operator[](size_t i) { return this->data_[i]; }
+  const T &operator[](size_t i) const { return this->data_[i]; }
+  auto begin() { return this->data_.begin(); }
+  auto end() { return this->data_.end(); }
+  auto begin() const { return this->data_.begin(); }
+  auto end() const { return this->data_.end(); }
+
+ protected:
+  std::vector<T> data_;
+};
+
+}  // namespace esphome
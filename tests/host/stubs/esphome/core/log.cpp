@@ -0,0 +1,32 @@
+#include "esphome/core/log.h"
+#include "esphome/core/hal.h"
+
+#include <cstdarg>
+#include <cstdlib>
+
+namespace esphome {
+
+namespace host {
+
+static int initial_log_level() {
+  const char *level = std::getenv("HOST_LOG_LEVEL");
+  return level != nullptr ? std::atoi(level) : ESPHOME_LOG_LEVEL_WARN;
+}
+
+int log_level = initial_log_level();
+
+}  // namespace host
+
+void esp_log_printf_(int level, const char *tag, int line, const char *format, ...) {
+  static const char LEVEL_LETTERS[] = "?EWICDVV";
+  const uint64_t now = millis_64();
+  fprintf(stderr, "[%6" PRIu64 ".%03" PRIu64 "][%c][%s:%d]: ", now / 1000, now % 1000,
+          LEVEL_LETTERS[level < 0 || level > 7 ? 0 : level], tag, line);
+  va_list args;
+  va_start(args, format);
+  vfprintf(stderr, format, args);
+  va_end(args);
+  fputc('\n', stderr);
+}
+
+}  // namespace esphome
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstdio>
+
+// Log macros with ESPHome's formatting, printed to stderr with the simulated time. Only messages at or above
+// host::log_level are formatted, set from the HOST_LOG_LEVEL environment variable (0 = none ... 7 = very verbose,
+// default 2 = warnings), so a scenario runs quietly unless it is being debugged.
+
+#define ESPHOME_LOG_LEVEL_NONE 0
+#define ESPHOME_LOG_LEVEL_ERROR 1
+#define ESPHOME_LOG_LEVEL_WARN 2
+#define ESPHOME_LOG_LEVEL_INFO 3
+#define ESPHOME_LOG_LEVEL_CONFIG 4
+#define ESPHOME_LOG_LEVEL_DEBUG 5
+#define ESPHOME_LOG_LEVEL_VERBOSE 6
+#define ESPHOME_LOG_LEVEL_VERY_VERBOSE 7
+
+namespace esphome {
+
+namespace host {
+extern int log_level;
+}  // namespace host
+
+void esp_log_printf_(int level, const char *tag, int line, const char *format, ...)
+    __attribute__((format(printf, 4, 5)));
+
+}  // namespace esphome
+
+#define esph_log_(level, tag, ...) \
+  do { \
+    if (::esphome::host::log_level >= (level)) \
+      ::esphome::esp_log_printf_(level, tag, __LINE__, __VA_ARGS__); \
+  } while (0)
+
+#define ESP_LOGE(tag, ...) esph_log_(ESPHOME_LOG_LEVEL_ERROR, tag, __VA_ARGS__)
+#define ESP_LOGW(tag, ...) esph_log_(ESPHOME_LOG_LEVEL_WARN, tag, __VA_ARGS__)
+#define ESP_LOGI(tag, ...) esph_log_(ESPHOME_LOG_LEVEL_INFO, tag, __VA_ARGS__)
+#define ESP_LOGCONFIG(tag, ...) esph_log_(ESPHOME_LOG_LEVEL_CONFIG, tag, __VA_ARGS__)
+#define ESP_LOGD(tag, ...) esph_log_(ESPHOME_LOG_LEVEL_DEBUG, tag, __VA_ARGS__)
+#define ESP_LOGV(tag, ...) esph_log_(ESPHOME_LOG_LEVEL_VERBOSE, tag, __VA_ARGS__)
+#define ESP_LOGVV(tag, ...) esph_log_(ESPHOME_LOG_LEVEL_VERY_VERBOSE, tag, __VA_ARGS__)
+
+#define LOG_STR(s) (s)
+#define LOG_STR_LITERAL(s) (s)
+#define LOG_STR_ARG(s) (s)
+
+#define YESNO(b) ((b) ? "YES" : "NO")
+#define ONOFF(b) ((b) ? "ON" : "OFF")
+#define TRUEFALSE(b) ((b) ? "TRUE" : "FALSE")
+
+namespace esphome::host {
+/// Components log themselves with `this`, which a direct comparison with nullptr warns about.
+inline bool is_set(const void *obj) { return obj != nullptr; }
+}  // namespace esphome::host
+
+#define LOG_ENTITY_(prefix, type, obj) \
+  if (::esphome::host::is_set(obj)) { \
+    ESP_LOGCONFIG(TAG, "%s%s '%s'", prefix, LOG_STR_LITERAL(type), (obj)->get_name().c_str()); \
+  }
+
+#define LOG_SENSOR(prefix, type, obj) LOG_ENTITY_(prefix, type, obj)
+#define LOG_BINARY_SENSOR(prefix, type, obj) LOG_ENTITY_(prefix, type, obj)
+#define LOG_TEXT_SENSOR(prefix, type, obj) LOG_ENTITY_(prefix, type, obj)
+#define LOG_SWITCH(prefix, type, obj) LOG_ENTITY_(prefix, type, obj)
+#define LOG_SELECT(prefix, type, obj) LOG_ENTITY_(prefix, type, obj)
+#define LOG_CLIMATE(prefix, type, obj) LOG_ENTITY_(prefix, type, obj)
+#define LOG_WATER_HEATER(prefix, type, obj) LOG_ENTITY_(prefix, type, obj)
+
+#define LOG_UPDATE_INTERVAL(this) \
+  ESP_LOGCONFIG(TAG, "  Update Interval: %.1fs", static_cast<float>((this)->get_update_interval()) / 1000.0f)
@@ -0,0 +1,82 @@
+#include "esphome/core/preferences.h"
+
+#include <cstring>
+
+namespace esphome {
+
+namespace host {
+
+HostPreferences &preferences() {
+  static HostPreferences instance;
+  return instance;
+}
+
+bool HostPreferences::Entry::save(const uint8_t *data, size_t len) {
+  this->parent_->stats_.saves++;
+  this->ram_.assign(data, data + len);
+  return true;
+}
+
+bool HostPreferences::Entry::load(uint8_t *data, size_t len) {
+  const std::vector<uint8_t> &stored = this->ram_.empty() ? this->flash_ : this->ram_;
+  if (stored.size() != len)
+    return false;
+  std::memcpy(data, stored.data(), len);
+  return true;
+}
+
+HostPreferences::Entry *HostPreferences::get_entry_(uint32_t type, bool in_flash) {
+  auto &entries = in_flash ? this->flash_entries_ : this->rtc_entries_;
+  return &entries.try_emplace(type, this, in_flash).first->second;
+}
+
+ESPPreferenceObject HostPreferences::make_preference(size_t length, uint32_t type, bool in_flash) {
+  Entry *entry = this->get_entry_(type, in_flash);
+  // Sized up front like a device's preference slot, so saving and syncing never show up as allocations.
+  entry->ram_.reserve(length);
+  entry->flash_.reserve(length);
+  return ESPPreferenceObject(entry);
+}
+
+// The ESP32 default, preferences without an explicit choice go to flash.
+ESPPreferenceObject HostPreferences::make_preference(size_t length, uint32_t type) {
+  return this->make_preference(length, type, true);
+}
+
+bool HostPreferences::sync() {
+  this->stats_.syncs++;
+  for (auto &it : this->flash_entries_) {
+    Entry &entry = it.second;
+    if (entry.ram_.empty() || entry.ram_ == entry.flash_)
+      continue;
+    entry.flash_ = entry.ram_;
+    this->stats_.flash_writes++;
+  }
+  return true;
+}
+
+// Entries are only ever emptied, never removed, so the preference objects components hold stay valid.
+bool HostPreferences::reset() {
+  for (auto *entries : {&this->flash_entries_, &this->rtc_entries_}) {
+    for (auto &it : *entries) {
+      it.second.ram_.clear();
+      it.second.flash_.clear();
+    }
+  }
+  return true;
+}
+
+void HostPreferences::restart(bool power_loss) {
+  for (auto &it : this->flash_entries_)
+    it.second.ram_.clear();
+  if (!power_loss)
+    return;
+  for (auto &it : this->rtc_entries_)
+    it.second.ram_.clear();
+}
+
+}  // namespace host
+
+ESPPreferences *global_preferences = &host::preferences();
+
+}  // namespace esphome
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <type_traits>
+#include <vector>
+
+namespace esphome {
+
+class ESPPreferenceBackend {
+ public:
+  virtual ~ESPPreferenceBackend() = default;
+  virtual bool save(const uint8_t *data, size_t len) = 0;
+  virtual bool load(uint8_t *data, size_t len) = 0;
+};
+
+class ESPPreferenceObject {
+ public:
+  ESPPreferenceObject() = default;
+  explicit ESPPreferenceObject(ESPPreferenceBackend *backend) : backend_(backend) {}
+
+  template<typename T> bool save(const T *src) {
+    if (this->backend_ == nullptr)
+      return false;
+    return this->backend_->save(reinterpret_cast<const uint8_t *>(src), sizeof(T));
+  }
+  template<typename T> bool load(T *dest) {
+    if (this->backend_ == nullptr)
+      return false;
+    return this->backend_->load(reinterpret_cast<uint8_t *>(dest), sizeof(T));
+  }
+
+ protected:
+  ESPPreferenceBackend *backend_{nullptr};
+};
+
+class ESPPreferences {
+ public:
+  virtual ~ESPPreferences() = default;
+  virtual ESPPreferenceObject make_preference(size_t length, uint32_t type, bool in_flash) = 0;
+  virtual ESPPreferenceObject make_preference(size_t length, uint32_t type) = 0;
+  /// Writes the preferences saved since the last sync to flash.
+  virtual bool sync() = 0;
+  virtual bool reset() = 0;
+
+  template<typename T, typename std::enable_if<std::is_trivially_copyable<T>::value, bool>::type = true>
+  ESPPreferenceObject make_preference(uint32_t type, bool in_flash) {
+    return this->make_preference(sizeof(T), type, in_flash);
+  }
+  template<typename T, typename std::enable_if<std::is_trivially_copyable<T>::value, bool>::type = true>
+  ESPPreferenceObject make_preference(uint32_t type) {
+    return this->make_preference(sizeof(T), type);
+  }
+};
+
+extern ESPPreferences *global_preferences;
+
+namespace host {
+
+/// What the preferences have cost since the counters were last cleared.
+struct PreferenceStats {
+  uint32_t saves{0};         ///< save() calls, flash and RTC.
+  uint32_t flash_writes{0};  ///< Preferences written to flash by a sync because their data changed.
+  uint32_t syncs{0};
+};
+
+/// In-memory preferences that behave like the ESP32 NVS ones: save() only updates RAM and sync(), run every flash
+/// write interval by Application, writes each preference whose data differs from what is already in flash. RTC
+/// preferences (in_flash = false) never touch flash and survive a restart but not a power loss.
+class HostPreferences : public ESPPreferences {
+ public:
+  ESPPreferenceObject make_preference(size_t length, uint32_t type, bool in_flash) override;
+  ESPPreferenceObject make_preference(size_t length, uint32_t type) override;
+  bool sync() override;
+  bool reset() override;
+
+  /// Simulates a restart: anything saved since the last sync is lost, and so is RTC memory if `power_loss`.
+  void restart(bool power_loss);
+
+  const PreferenceStats &get_stats() const { return this->stats_; }
+  void clear_stats() { this->stats_ = {}; }
+
+ protected:
+  class Entry : public ESPPreferenceBackend {
+   public:
+    Entry(HostPreferences *parent, bool in_flash) : parent_(parent), in_flash_(in_flash) {}
+    bool save(const uint8_t *data, size_t len) override;
+    bool load(uint8_t *data, size_t len) override;
+
+    HostPreferences *parent_;
+    bool in_flash_;
+    std::vector<uint8_t> ram_;    ///< Last saved data, empty if never saved.
+    std::vector<uint8_t> flash_;  ///< Data written by the last sync, empty if never written.
+  };
+
+  Entry *get_entry_(uint32_t type, bool in_flash);
+
+  std::map<uint32_t, Entry> flash_entries_;
+  std::map<uint32_t, Entry> rtc_entries_;
+  PreferenceStats stats_;
+};
+
+/// The preferences global_preferences points at.
+HostPreferences &preferences();
+
+}  // namespace host
+}  // namespace esphome
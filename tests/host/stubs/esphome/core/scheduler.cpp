@@ -0,0 +1,114 @@
+#include "esphome/core/scheduler.h"
+#include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+
+#include <algorithm>
+
+namespace esphome {
+
+void Scheduler::set_timeout(Component *component, const std::string &name, uint32_t timeout,
+                            std::function<void()> func) {
+  this->set_item_(component, name, timeout, false, std::move(func));
+}
+
+bool Scheduler::cancel_timeout(Component *component, const std::string &name) {
+  return this->cancel_item_(component, name, false);
+}
+
+void Scheduler::set_interval(Component *component, const std::string &name, uint32_t interval,
+                             std::function<void()> func) {
+  this->set_item_(component, name, interval, true, std::move(func));
+}
+
+bool Scheduler::cancel_interval(Component *component, const std::string &name) {
+  return this->cancel_item_(component, name, true);
+}
+
+void Scheduler::set_item_(Component *component, const std::string &name, uint32_t delay, bool is_interval,
+                          std::function<void()> func) {
+  if (!name.empty())
+    this->cancel_item_(component, name, is_interval);
+  if (delay == SCHEDULER_DONT_RUN)
+    return;
+
+  std::unique_ptr<Item> item;
+  if (this->recycled_.empty()) {
+    item = std::make_unique<Item>();
+  } else {
+    item = std::move(this->recycled_.back());
+    this->recycled_.pop_back();
+  }
+  item->component = component;
+  item->name = name;
+  item->next_execution = millis_64() + delay;
+  item->interval = delay;
+  item->is_interval = is_interval;
+  item->removed = false;
+  item->order = this->next_order_++;
+  item->callback = std::move(func);
+  this->items_.push_back(std::move(item));
+}
+
+bool Scheduler::cancel_item_(Component *component, const std::string &name, bool is_interval) {
+  bool cancelled = false;
+  for (auto &item : this->items_) {
+    if (item->component == component && item->is_interval == is_interval && !item->removed && item->name == name) {
+      item->removed = true;
+      cancelled = true;
+    }
+  }
+  return cancelled;
+}
+
+void Scheduler::call(uint64_t now) {
+  this->due_.clear();
+  for (auto &item : this->items_) {
+    if (!item->removed && item->next_execution <= now)
+      this->due_.push_back(item.get());
+  }
+  std::sort(this->due_.begin(), this->due_.end(), [](const Item *a, const Item *b) {
+    return a->next_execution != b->next_execution ? a->next_execution < b->next_execution : a->order < b->order;
+  });
+
+  for (Item *item : this->due_) {
+    // An earlier item may have cancelled this one.
+    if (item->removed)
+      continue;
+    if (item->is_interval) {
+      // Intervals keep their phase, a late loop doesn't push every later run back.
+      item->next_execution += std::max<uint64_t>(item->interval, 1);
+      if (item->next_execution <= now)
+        item->next_execution = now + std::max<uint64_t>(item->interval, 1);
+    } else {
+      item->removed = true;
+    }
+    if (this->on_item_start)
+      this->on_item_start(item->component);
+    item->callback();
+    if (this->on_item_end)
+      this->on_item_end(item->component);
+  }
+
+  // Compacted by hand, std::remove_if would leave nothing to recycle and std::stable_partition can allocate.
+  size_t kept = 0;
+  for (auto &item : this->items_) {
+    if (!item->removed) {
+      this->items_[kept++] = std::move(item);
+    } else if (this->recycled_.size() < MAX_RECYCLED) {
+      item->callback = nullptr;
+      this->recycled_.push_back(std::move(item));
+    }
+  }
+  this->items_.resize(kept);
+}
+
+uint64_t Scheduler::next_execution() const {
+  uint64_t next = UINT64_MAX;
+  for (const auto &item : this->items_) {
+    if (!item->removed)
+      next = std::min(next, item->next_execution);
+  }
+  return next;
+}
+
+}  // namespace esphome
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace esphome {
+
+class Component;
+
+/// Timeouts and intervals of every component, run from the main loop in the order they fall due. A named item
+/// replaces the previous one of the same kind and name on the same component.
+///
+/// Unlike on a device, an interval first runs a whole interval after it was set rather than after a random part of
+/// it, so scenarios are deterministic.
+class Scheduler {
+ public:
+  Scheduler() {
+    this->items_.reserve(MAX_RECYCLED);
+    this->due_.reserve(MAX_RECYCLED);
+    this->recycled_.reserve(MAX_RECYCLED);
+  }
+
+  void set_timeout(Component *component, const std::string &name, uint32_t timeout, std::function<void()> func);
+  bool cancel_timeout(Component *component, const std::string &name);
+  void set_interval(Component *component, const std::string &name, uint32_t interval, std::function<void()> func);
+  bool cancel_interval(Component *component, const std::string &name);
+
+  /// Runs every item due at or before `now` (ms). Items set while running wait for the next call.
+  void call(uint64_t now);
+  /// Time (ms) the next item falls due, UINT64_MAX if nothing is scheduled.
+  uint64_t next_execution() const;
+  /// Drops every item, for a scenario that simulates a restart.
+  void clear() { this->items_.clear(); }
+
+  /// Called around every item run, so Application can attribute the time to its component.
+  std::function<void(Component *)> on_item_start;
+  std::function<void(Component *)> on_item_end;
+
+ protected:
+  struct Item {
+    Component *component;
+    std::string name;
+    uint64_t next_execution;
+    uint32_t interval;
+    bool is_interval;
+    bool removed;
+    uint64_t order;  ///< Items falling due at the same time run in the order they were set.
+    std::function<void()> callback;
+  };
+
+  void set_item_(Component *component, const std::string &name, uint32_t delay, bool is_interval,
+                 std::function<void()> func);
+  bool cancel_item_(Component *component, const std::string &name, bool is_interval);
+
+  std::vector<std::unique_ptr<Item>> items_;
+  std::vector<Item *> due_;  ///< Kept between calls so running the scheduler doesn't allocate.
+  /// Finished items kept for reuse, as the ESPHome scheduler does, so a component re-arming a timeout on every
+  /// update doesn't show up as an allocation in the benchmarks.
+  std::vector<std::unique_ptr<Item>> recycled_;
+  static constexpr size_t MAX_RECYCLED = 16;
+  uint64_t next_order_{0};
+};
+
+}  // namespace esphome
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstring>
+#include <string>
+
+namespace esphome {
+
+/// Non-owning view of a NUL terminated string, as returned by the entity getters.
+class StringRef {
+ public:
+  StringRef() = default;
+  StringRef(const char *str) : str_(str != nullptr ? str : "") {}
+
+  const char *c_str() const { return this->str_; }
+  std::string str() const { return this->str_; }
+  size_t size() const { return std::strlen(this->str_); }
+  bool empty() const { return *this->str_ == '\0'; }
+
+  bool operator==(const char *other) const { return std::strcmp(this->str_, other) == 0; }
+  bool operator==(const std::string &other) const { return other == this->str_; }
+  bool operator==(const StringRef &other) const { return std::strcmp(this->str_, other.str_) == 0; }
+
+ protected:
+  const char *str_{""};
+};
+
+}  // namespace esphome
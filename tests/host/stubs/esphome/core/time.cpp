@@ -0,0 +1,42 @@
+#include "esphome/core/time.h"
+
+namespace esphome {
+
+ESPTime ESPTime::from_epoch_utc(time_t epoch) {
+  struct tm c_tm;
+  gmtime_r(&epoch, &c_tm);
+  ESPTime time{};
+  time.second = c_tm.tm_sec;
+  time.minute = c_tm.tm_min;
+  time.hour = c_tm.tm_hour;
+  time.day_of_week = c_tm.tm_wday + 1;
+  time.day_of_month = c_tm.tm_mday;
+  time.day_of_year = c_tm.tm_yday + 1;
+  time.month = c_tm.tm_mon + 1;
+  time.year = c_tm.tm_year + 1900;
+  time.is_dst = false;
+  time.timestamp = epoch;
+  return time;
+}
+
+ESPTime ESPTime::from_epoch_local(time_t epoch) { return from_epoch_utc(epoch); }
+
+void ESPTime::increment_second() { *this = from_epoch_utc(this->timestamp + 1); }
+
+void ESPTime::recalc_timestamp_utc(bool use_day_of_year) {
+  struct tm c_tm {};
+  c_tm.tm_sec = this->second;
+  c_tm.tm_min = this->minute;
+  c_tm.tm_hour = this->hour;
+  c_tm.tm_year = this->year - 1900;
+  if (use_day_of_year) {
+    c_tm.tm_mon = 0;
+    c_tm.tm_mday = this->day_of_year;
+  } else {
+    c_tm.tm_mon = this->month - 1;
+    c_tm.tm_mday = this->day_of_month;
+  }
+  this->timestamp = timegm(&c_tm);
+}
+
+}  // namespace esphome
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+
+namespace esphome {
+
+/// Broken down local time. The host's local time zone is always UTC, so scenarios don't depend on the machine.
+struct ESPTime {
+  uint8_t second;
+  uint8_t minute;
+  uint8_t hour;
+  uint8_t day_of_week;  ///< 1 = Sunday ... 7 = Saturday.
+  uint8_t day_of_month;
+  uint16_t day_of_year;  ///< 1 - 366.
+  uint8_t month;         ///< 1 - 12.
+  uint16_t year;
+  bool is_dst;
+  time_t timestamp;
+
+  /// Whether the time has been set, i.e. isn't from before 2019.
+  bool is_valid() const { return this->year >= 2019; }
+  void increment_second();
+  void recalc_timestamp_utc(bool use_day_of_year = true);
+
+  static ESPTime from_epoch_local(time_t epoch);
+  static ESPTime from_epoch_utc(time_t epoch);
+
+  bool operator<(const ESPTime &other) const { return this->timestamp < other.timestamp; }
+  bool operator<=(const ESPTime &other) const { return this->timestamp <= other.timestamp; }
+  bool operator==(const ESPTime &other) const { return this->timestamp == other.timestamp; }
+  bool operator>=(const ESPTime &other) const { return this->timestamp >= other.timestamp; }
+  bool operator>(const ESPTime &other) const { return this->timestamp > other.timestamp; }
+};
+
+}  // namespace esphome
@@ -0,0 +1,9 @@
+#pragma once
+
+namespace esphome {
+
+/// There is no network on the host, so nothing is ever connected.
+inline bool network_is_connected() { return false; }
+inline bool api_is_connected() { return false; }
+
+}  // namespace esphome